@@ -5,12 +5,19 @@
 #include <cmath>
 #include <functional>
 #include <ctime>
+#include <bit>
+#include <limits>
 #include "AStar.h"
+#include "SearchTrace.h"
+#include "CompactPath.h"
+#include "SimdNeighbors.h"
+#include "SwampMap.h"
 
 AStar::AStar(int mapWidth, int mapHeight)
-    : _weight(1.0f)               // <--- [ٽ] ġ 1.0 ʼ ʱȭ!
-    , _allowDiagonal(true)        // 밢  ⺻
-    , _heuristicType(HeuristicType::MANHATTAN) // ⺻ ޸ƽ
+    : _weight(1.0f)               // <--- [핵심] 가중치 1.0 필수 초기화!
+    , _allowDiagonal(true)        // 대각선 허용 기본값
+    , _heuristicType(HeuristicType::MANHATTAN) // 기본 휴리스틱
+    , _simdLevel(SimdNeighbors::DetectLevel())
 {
     Initialize(mapWidth, mapHeight);
 }
@@ -25,169 +32,777 @@ void AStar::Initialize(int mapWidth, int mapHeight)
     _mapWidth = mapWidth;
     _mapHeight = mapHeight;
 
-    //   ũ  (false ʱȭ)
+    // 맵 데이터 크기 잡기 (false로 초기화)
     _mapGrid.assign(_mapWidth * _mapHeight, false);
 
-    //   ˻ ũ  (nullptr ʱȭ)
+    // 노드 맵 검색용 크기 잡기 (nullptr로 초기화)
     _nodeMap.resize(_mapWidth * _mapHeight);
     std::fill(_nodeMap.begin(), _nodeMap.end(), nullptr);
+
+    // 이동 마스크 계산
+    _moveMask.assign(_mapWidth * _mapHeight, 0);
+    RebuildMoveMasks();
+
+    // 셀 표시 상태 (크기가 바뀌었으니 전체 다시 그리기)
+    _cellType.assign(_mapWidth * _mapHeight, (unsigned char)NodeType::NONE);
+    _dirtyMark.assign(_dirtyTrackingEnabled ? _mapWidth * _mapHeight : 0, 0);
+    _dirtyCells.clear();
+    _fullDirty = true;
+    _cellEvents.clear();
+    _cellEventsReset = true;
+    RefreshAllCellTypes();
+
+    _searchTreeValid = false;
+
+    // 크기가 바뀌면 이전 기록은 의미가 없으므로 버전만 올리고 기록은 비움
+    ++_mapVersion;
+    _journalStartVersion = _mapVersion;
+    _mapJournal.clear();
 }
 
 void AStar::SetObstacle(int x, int y, bool isWall)
 {
     if (x < 0 || x >= _mapWidth || y < 0 || y >= _mapHeight) return;
+    if (_mapGrid[y * _mapWidth + x] == isWall) return; // 변화 없음
+
     _mapGrid[y * _mapWidth + x] = isWall;
+    UpdateMoveMask(x, y);
+    RefreshCellType(y * _mapWidth + x);
+    _searchTreeValid = false;
+    RecordMapChange(x, y, x, y);
 }
 
 void AStar::ClearObstacles()
+{
+    ClearGrid();
+    RebuildMoveMasks();
+    RefreshAllCellTypes();
+    _searchTreeValid = false;
+    RecordMapChange(0, 0, _mapWidth - 1, _mapHeight - 1);
+}
+
+void AStar::FillRect(int x, int y, int width, int height, bool isWall)
+{
+    int x0 = (std::max)(x, 0);
+    int y0 = (std::max)(y, 0);
+    int x1 = (std::min)(x + width, _mapWidth) - 1;
+    int y1 = (std::min)(y + height, _mapHeight) - 1;
+    if (x0 > x1 || y0 > y1) return;
+
+    for (int row = y0; row <= y1; ++row)
+    {
+        auto rowBegin = _mapGrid.begin() + (row * _mapWidth);
+        std::fill(rowBegin + x0, rowBegin + (x1 + 1), isWall);
+    }
+    FinishEdit(x0, y0, x1, y1);
+}
+
+void AStar::PaintBrush(int centerX, int centerY, int radius, bool isWall)
+{
+    if (radius < 0) return;
+
+    int y0 = (std::max)(centerY - radius, 0);
+    int y1 = (std::min)(centerY + radius, _mapHeight - 1);
+    int minX = _mapWidth;
+    int maxX = -1;
+
+    // 행마다 원에 들어가는 구간 [centerX - half, centerX + half]를 채움
+    for (int row = y0; row <= y1; ++row)
+    {
+        int dy = row - centerY;
+        int half = (int)std::sqrt((float)(radius * radius - dy * dy));
+        int x0 = (std::max)(centerX - half, 0);
+        int x1 = (std::min)(centerX + half, _mapWidth - 1);
+        if (x0 > x1) continue;
+
+        auto rowBegin = _mapGrid.begin() + (row * _mapWidth);
+        std::fill(rowBegin + x0, rowBegin + (x1 + 1), isWall);
+        minX = (std::min)(minX, x0);
+        maxX = (std::max)(maxX, x1);
+    }
+    if (minX <= maxX) FinishEdit(minX, y0, maxX, y1);
+}
+
+void AStar::ApplyMask(int x, int y, int maskWidth, int maskHeight, const std::vector<unsigned long long>& mask, bool isWall)
+{
+    int minX = _mapWidth, minY = _mapHeight;
+    int maxX = -1, maxY = -1;
+    WriteMask(x, y, maskWidth, maskHeight, mask, isWall, minX, minY, maxX, maxY);
+    if (minX <= maxX && minY <= maxY) FinishEdit(minX, minY, maxX, maxY);
+}
+
+void AStar::ReplaceObstacles(const std::vector<unsigned long long>& wallMask)
+{
+    int minX = 0, minY = 0;
+    int maxX = _mapWidth - 1, maxY = _mapHeight - 1;
+    ClearGrid();
+    WriteMask(0, 0, _mapWidth, _mapHeight, wallMask, true, minX, minY, maxX, maxY);
+
+    // 전체가 바뀐 것으로 보고 한 번에 재계산 + 기록 한 건
+    RebuildMoveMasks();
+    RefreshAllCellTypes();
+    _searchTreeValid = false;
+    RecordMapChange(0, 0, _mapWidth - 1, _mapHeight - 1);
+}
+
+void AStar::ClearGrid()
 {
     std::fill(_mapGrid.begin(), _mapGrid.end(), false);
 }
 
-bool AStar::IsWalkable(int x, int y)
+void AStar::WriteMask(int x, int y, int maskWidth, int maskHeight, const std::vector<unsigned long long>& mask, bool isWall,
+    int& minX, int& minY, int& maxX, int& maxY)
+{
+    int wordsPerRow = (maskWidth + 63) / 64;
+    if (maskWidth <= 0 || maskHeight <= 0 || (int)mask.size() < wordsPerRow * maskHeight) return;
+
+    for (int row = 0; row < maskHeight; ++row)
+    {
+        int mapY = y + row;
+        if (mapY < 0 || mapY >= _mapHeight) continue;
+
+        for (int word = 0; word < wordsPerRow; ++word)
+        {
+            unsigned long long bits = mask[row * wordsPerRow + word];
+            if (bits == 0) continue;
+
+            int baseX = x + word * 64;
+            int lastBit = (std::min)(64, maskWidth - word * 64); // 마지막 워드의 남는 비트는 무시
+
+            // 꽉 찬 워드(와 맵 안에 들어오는 구간)는 구간 채우기 한 번으로
+            if (bits == ~0ull && lastBit == 64 && baseX >= 0 && baseX + 64 <= _mapWidth)
+            {
+                auto begin = _mapGrid.begin() + (mapY * _mapWidth + baseX);
+                std::fill(begin, begin + 64, isWall);
+                minX = (std::min)(minX, baseX);
+                maxX = (std::max)(maxX, baseX + 63);
+            }
+            else
+            {
+                while (bits != 0)
+                {
+                    int bit = std::countr_zero(bits);
+                    bits &= bits - 1;
+                    if (bit >= lastBit) break;
+
+                    int mapX = baseX + bit;
+                    if (mapX < 0 || mapX >= _mapWidth) continue;
+
+                    _mapGrid[mapY * _mapWidth + mapX] = isWall;
+                    minX = (std::min)(minX, mapX);
+                    maxX = (std::max)(maxX, mapX);
+                }
+            }
+            minY = (std::min)(minY, mapY);
+            maxY = (std::max)(maxY, mapY);
+        }
+    }
+}
+
+void AStar::FinishEdit(int x0, int y0, int x1, int y1)
+{
+    // 바뀐 칸의 한 칸 바깥까지 마스크가 영향을 받음 (UpdateMoveMask와 같은 이유)
+    int maskX0 = (std::max)(x0 - 1, 0);
+    int maskY0 = (std::max)(y0 - 1, 0);
+    int maskX1 = (std::min)(x1 + 1, _mapWidth - 1);
+    int maskY1 = (std::min)(y1 + 1, _mapHeight - 1);
+    for (int ny = maskY0; ny <= maskY1; ++ny)
+    {
+        for (int nx = maskX0; nx <= maskX1; ++nx)
+            _moveMask[ny * _mapWidth + nx] = ComputeMoveMask(nx, ny);
+    }
+
+    for (int ny = y0; ny <= y1; ++ny)
+    {
+        for (int nx = x0; nx <= x1; ++nx)
+            RefreshCellType(ny * _mapWidth + nx);
+    }
+
+    _searchTreeValid = false;
+    RecordMapChange(x0, y0, x1, y1);
+}
+
+void AStar::RecordMapChange(int x0, int y0, int x1, int y1)
+{
+    ++_mapVersion;
+
+    // 가득 차면 오래된 절반을 버림 (그 버전들에서 따라오는 쪽은 전체 다시 읽기)
+    if ((int)_mapJournal.size() >= MAP_JOURNAL_CAPACITY)
+    {
+        size_t dropCount = _mapJournal.size() / 2;
+        _journalStartVersion = _mapJournal[dropCount - 1].version;
+        _mapJournal.erase(_mapJournal.begin(), _mapJournal.begin() + dropCount);
+    }
+
+    _mapJournal.push_back({ _mapVersion, x0, y0, x1 - x0 + 1, y1 - y0 + 1 });
+}
+
+bool AStar::GetChangesSince(unsigned int version, std::vector<MapChange>& out) const
+{
+    out.clear();
+    if (version < _journalStartVersion || version > _mapVersion) return false;
+
+    // 버전은 기록 순서대로 증가하므로 이분 탐색으로 시작 위치를 찾음
+    auto first = std::upper_bound(_mapJournal.begin(), _mapJournal.end(), version,
+        [](unsigned int v, const MapChange& change) { return v < change.version; });
+    out.assign(first, _mapJournal.end());
+    return true;
+}
+
+unsigned char AStar::ComputeMoveMask(int x, int y)
+{
+    if (!IsWalkable(x, y)) return 0;
+
+    unsigned char mask = 0;
+    for (int i = 0; i < 8; ++i)
+    {
+        int nextX = x + dx[i];
+        int nextY = y + dy[i];
+
+        if (!IsWalkable(nextX, nextY)) continue;
+
+        // 대각선은 양쪽 직선 방향이 모두 벽일 때만 막음
+        if (i >= 4 && !IsWalkable(x, nextY) && !IsWalkable(nextX, y))
+            continue;
+
+        mask |= (unsigned char)(1 << i);
+    }
+    return mask;
+}
+
+void AStar::UpdateMoveMask(int x, int y)
+{
+    // (x, y)가 바뀌면 자기 자신과 이웃 8칸의 마스크가 영향을 받음
+    // (이웃으로서의 영향 + 대각선 코너 규칙의 직선 칸으로서의 영향 모두 3x3 안에 있음)
+    for (int ny = y - 1; ny <= y + 1; ++ny)
+    {
+        for (int nx = x - 1; nx <= x + 1; ++nx)
+        {
+            if (nx < 0 || nx >= _mapWidth || ny < 0 || ny >= _mapHeight) continue;
+            _moveMask[ny * _mapWidth + nx] = ComputeMoveMask(nx, ny);
+        }
+    }
+}
+
+void AStar::RebuildMoveMasks()
+{
+    for (int y = 0; y < _mapHeight; ++y)
+    {
+        for (int x = 0; x < _mapWidth; ++x)
+        {
+            _moveMask[y * _mapWidth + x] = ComputeMoveMask(x, y);
+        }
+    }
+}
+
+void AStar::SetCellType(int index, NodeType type)
+{
+    if (_cellType[index] == (unsigned char)type) return;
+    _cellType[index] = (unsigned char)type;
+
+    if (_dirtyTrackingEnabled && !_dirtyMark[index])
+    {
+        _dirtyMark[index] = 1;
+        _dirtyCells.push_back(index);
+    }
+
+    if (_cellEventsEnabled)
+        _cellEvents.push_back({ index, type });
+}
+
+void AStar::RefreshCellType(int index)
+{
+    if (_mapGrid[index]) SetCellType(index, NodeType::WALL);
+    else if (_cellType[index] == (unsigned char)NodeType::PATH && _nodeMap[index]) return; // 경로 표시 유지
+    else if (_nodeMap[index] == nullptr) SetCellType(index, NodeType::NONE);
+    else SetCellType(index, _nodeMap[index]->isClosed ? NodeType::CLOSED : NodeType::OPEN);
+}
+
+void AStar::RefreshAllCellTypes()
+{
+    for (int index = 0; index < _mapWidth * _mapHeight; ++index)
+        RefreshCellType(index);
+}
+
+void AStar::SetDirtyTrackingEnabled(bool enable)
+{
+    if (_dirtyTrackingEnabled == enable) return;
+
+    _dirtyTrackingEnabled = enable;
+    _dirtyMark.assign(enable ? _mapWidth * _mapHeight : 0, 0);
+    _dirtyCells.clear();
+    _fullDirty = true; // 꺼져 있던 동안의 변화는 모름
+}
+
+bool AStar::TakeDirtyCells(std::vector<int>& out)
+{
+    if (!_dirtyTrackingEnabled)
+    {
+        out.clear();
+        return true;
+    }
+
+    bool full = _fullDirty;
+    _fullDirty = false;
+
+    for (int index : _dirtyCells) _dirtyMark[index] = 0;
+    if (full) _dirtyCells.clear();
+
+    // 버퍼를 맞바꿔서 다음 프레임에 capacity 재사용
+    out.clear();
+    out.swap(_dirtyCells);
+    return full;
+}
+
+void AStar::SetCellEventsEnabled(bool enable)
+{
+    if (_cellEventsEnabled == enable) return;
+
+    _cellEventsEnabled = enable;
+    _cellEvents.clear();
+    _cellEventsReset = true; // 꺼져 있던 동안의 변화는 모르므로 전체 재동기화 필요
+}
+
+bool AStar::PollCellEvents(std::vector<CellEvent>& out)
+{
+    bool reset = _cellEventsReset;
+    _cellEventsReset = false;
+
+    // 버퍼를 맞바꿔서 capacity 재사용
+    out.clear();
+    out.swap(_cellEvents);
+    return reset;
+}
+
+bool AStar::IsWalkable(int x, int y) const
 {
     if (x < 0 || x >= _mapWidth || y < 0 || y >= _mapHeight) return false;
-    return !_mapGrid[y * _mapWidth + x]; // (true)̸ false ȯ
+    return !_mapGrid[y * _mapWidth + x]; // 벽(true)이면 false 반환
 }
 
 float AStar::CalculateH(Point current, Point end) {
-	float dx = std::abs((float)(current.x - end.x));
-	float dy = std::abs((float)(current.y - end.y));
+	// [수정] 식은 다른 탐색기와 함께 쓰는 HeuristicDistance로 옮김
+	return HeuristicDistance(_heuristicType, current, end) * _weight;
+}
 
-	switch (_heuristicType) {
-	case HeuristicType::MANHATTAN:
-		return (dx + dy) * _weight;
-	case HeuristicType::EUCLIDEAN:
-		return std::sqrt(dx * dx + dy * dy) * _weight;
-	}
-	return 0.0f;
+void AStar::SetSimdLevel(SimdLevel level)
+{
+    _simdLevel = (std::min)(level, SimdNeighbors::DetectLevel());
 }
 
 void AStar::StartPathFinding(Point start, Point end)
 {
-    // 1. ʱȭ
+    // [추가] 늪 전처리에 그 뒤의 맵 편집을 반영하고 이번 출발/도착이 든 늪은 열어둠
+    _swampSkipCount = 0;
+    if (_swampMap)
+    {
+        _swampMap->SyncFrom(*this);
+        _swampMap->BeginQuery(start, end);
+    }
+
+    // [추가] 출발점이 같으면 이전 탐색 트리를 이어서 사용
+    if (CanReuseSearchTree(start, end))
+    {
+        RetargetPathFinding(end);
+        return;
+    }
+
+    // 1. 초기화
     ClearNodes();
     _lastPath.clear();
     _lastStart = start;
-    _targetEnd = end; //   ص־ Update 
+    _targetEnd = end; // 멤버 변수에 저장해둬야 Update에서 씀
 
-    //  ʱȭ (  )
-    // ClearNodes _nodeMap κ ʱȭϹǷ ⼱ нϰų ϰ Ȯ
+    // 맵 초기화 (이전 흔적 지우기)
+    // ClearNodes에서 _nodeMap을 부분 초기화하므로 여기선 패스하거나 안전하게 확인
 
-    //   ó
+    // 시작점 예외 처리
     if (!IsWalkable(start.x, start.y) || !IsWalkable(end.x, end.y))
     {
+        _searchTreeValid = false;
         _state = State::FAILED;
         return;
     }
 
-    // 2.   
+    if (_traceRecorder) _traceRecorder->Begin(_mapWidth, _mapHeight, start, end);
+
+    // 이번 트리를 만든 설정 기록 (재사용 가능 여부 판단용)
+    _searchTreeValid = true;
+    _treeHeuristicType = _heuristicType;
+    _treeWeight = _weight;
+    _treeAllowDiagonal = _allowDiagonal;
+    _treeSwampRevision = _swampMap ? _swampMap->GetRevision() : 0;
+
+    // 2. 시작 노드 등록
     float h = CalculateH(start, end);
     Node* startNode = _nodePool.Alloc(start.x, start.y, nullptr, 0.0f, h);
     _createdNodes.push_back(startNode);
 
-    _openList.push_back(startNode);
-    std::push_heap(_openList.begin(), _openList.end(), NodeCompare());
+    _openList.push_back({ startNode->f, startNode->h, startNode });
+    std::push_heap(_openList.begin(), _openList.end(), OpenEntryCompare());
 
     int startIndex = start.y * _mapWidth + start.x;
     _nodeMap[startIndex] = startNode;
+    SetCellType(startIndex, NodeType::OPEN);
+
+    // [상태 변경] 이제 탐색 중이다!
+    _state = State::SEARCHING;
+}
+
+bool AStar::CanReuseSearchTree(Point start, Point end) const
+{
+    if (!_searchTreeReuse || !_searchTreeValid || _createdNodes.empty()) return false;
+    if (start != _lastStart) return false;
+
+    // 늪 건너뛰기: 열린 늪이 달라지면 이전 트리에는 새로 열린 늪 쪽 이웃이 빠져 있음
+    if (_swampMap)
+    {
+        if (_swampMap->GetRevision() != _treeSwampRevision) return false;
+        if (_swampMap->GetSwampId(end.x, end.y) != _swampMap->GetSwampId(_targetEnd.x, _targetEnd.y)) return false;
+    }
+
+    // 기록기는 탐색 하나를 처음부터 기록하므로 이어서 탐색하면 재생이 맞지 않음
+    if (_traceRecorder) return false;
+
+    // g값은 휴리스틱과 무관하지만, 닫힌 노드의 확장 순서(= 확정 여부)는 설정에 따라 달라짐
+    return _treeHeuristicType == _heuristicType && _treeWeight == _weight && _treeAllowDiagonal == _allowDiagonal;
+}
+
+void AStar::RetargetPathFinding(Point end)
+{
+    // 1. 이전 경로 표시 지우기 (경로 위 노드는 모두 닫힌 노드)
+    for (const Point& p : _lastPath)
+        SetCellType(p.y * _mapWidth + p.x, NodeType::CLOSED);
+    _lastPath.clear();
+    _pathEnd = nullptr;
+    _targetEnd = end;
+    _expandCount = 0;
+
+    if (!IsWalkable(end.x, end.y))
+    {
+        _state = State::FAILED; // 트리는 그대로 두므로 다음 목적지에서 다시 이어감
+        return;
+    }
+
+    // 2. 새 목적지가 이미 닫힌 노드면 확장 없이 바로 경로 완성
+    Node* endNode = _nodeMap[end.y * _mapWidth + end.x];
+    if (endNode != nullptr && endNode->isClosed)
+    {
+        _state = State::FINISHED;
+        BuildPath(endNode);
+        return;
+    }
+
+    // 3. 이전 목적지는 닫기만 하고 이웃을 펼치지 않았으므로 다시 열어줌 (g는 이미 확정값)
+    if (_unexpandedGoal != nullptr)
+    {
+        _unexpandedGoal->isClosed = false;
+        if (!_closedList.empty() && _closedList.back() == _unexpandedGoal)
+            _closedList.pop_back();
+        SetCellType(_unexpandedGoal->y * _mapWidth + _unexpandedGoal->x, NodeType::OPEN);
+        _openList.push_back({ _unexpandedGoal->f, _unexpandedGoal->h, _unexpandedGoal });
+        _unexpandedGoal = nullptr;
+    }
+
+    // 4. 열린 목록을 새 목적지 기준으로 재정렬
+    //    Lazy Deletion으로 남은 중복/닫힌 항목은 이 참에 정리
+    std::sort(_openList.begin(), _openList.end(),
+        [](const OpenEntry& a, const OpenEntry& b) { return a.node < b.node; });
+    _openList.erase(std::unique(_openList.begin(), _openList.end(),
+        [](const OpenEntry& a, const OpenEntry& b) { return a.node == b.node; }), _openList.end());
+    _openList.erase(std::remove_if(_openList.begin(), _openList.end(),
+        [](const OpenEntry& entry) { return entry.node->isClosed; }), _openList.end());
+
+    for (OpenEntry& entry : _openList)
+    {
+        Node* node = entry.node;
+        node->h = CalculateH({ node->x, node->y }, end);
+        node->f = node->g + node->h;
+        entry = { node->f, node->h, node };
+    }
+    std::make_heap(_openList.begin(), _openList.end(), OpenEntryCompare());
 
-    // [ ]  Ž ̴!
     _state = State::SEARCHING;
 }
 
+bool AStar::GetCompactPath(CompactPath& out) const
+{
+    out.Clear();
+    if (_pathEnd == nullptr) return false;
+
+    // parent 체인(끝 -> 시작)을 따라가며 바로 인코딩
+    Node* node = _pathEnd;
+    out.BeginReverse({ node->x, node->y });
+    while (node->parent)
+    {
+        out.PushReverse(CompactPath::DirectionOf(node->x - node->parent->x, node->y - node->parent->y));
+        node = node->parent;
+    }
+    out.FinishReverse({ node->x, node->y });
+    return true;
+}
+
+void AStar::BuildPath(Node* goal)
+{
+    _pathEnd = goal;
+
+    // 경로 역추적
+    Node* trace = goal;
+    while (trace)
+    {
+        _lastPath.push_back({ trace->x, trace->y });
+        SetCellType(trace->y * _mapWidth + trace->x, NodeType::PATH);
+        trace = trace->parent;
+    }
+    // [중요] 시작 -> 끝 순서로 뒤집기
+    std::reverse(_lastPath.begin(), _lastPath.end());
+}
+
 void AStar::UpdatePathFinding()
 {
-    // Ž  ƴϸ ƹ͵  
+    // 탐색 중이 아니면 아무것도 안 함
     if (_state != State::SEARCHING) return;
 
-    // OpenList  ->   ִ  
+    // OpenList가 비었으면 -> 갈 수 있는 길이 없음
     if (_openList.empty())
     {
         _state = State::FAILED;
         return;
     }
 
+    // [추가] 노드 상한: 이번 확장으로 최대 8개가 새로 생기므로 미리 자리 확보
+    // [수정] 기록 중에는 잊기를 하지 않음 (기록 형식에 노드를 잊는 이벤트가 없어 재생이 어긋남) -> 상한에 닿으면 PARTIAL로 끝냄
+    if (_nodeLimit > 0)
+    {
+        if ((int)_createdNodes.size() + 8 > _nodeLimit && (_traceRecorder || !PruneNodes()))
+        {
+            FinishPartial();
+            return;
+        }
+        // 잊고 다시 펼치기를 반복하느라 끝나지 않는 경우 방지 (맵 전체의 4배)
+        if (_expandCount > 4 * _mapWidth * _mapHeight)
+        {
+            FinishPartial();
+            return;
+        }
+    }
+
     // -------------------------------------------------------
-    // [ while  ȿ ִ     ]
+    // [원래 while 루프 안에 있던 로직을 딱 한 번만 실행]
     // -------------------------------------------------------
 
-    // 1.  
-    std::pop_heap(_openList.begin(), _openList.end(), NodeCompare());
-    Node* current = _openList.back();
+    // 1. 노드 꺼내기
+    std::pop_heap(_openList.begin(), _openList.end(), OpenEntryCompare());
+    Node* current = _openList.back().node;
     _openList.pop_back();
 
-    // 2. Lazy Deletion üũ
+    int currentIndex = current->y * _mapWidth + current->x;
+
+    // 2. Lazy Deletion 체크
     if (current->isClosed)
-        return; // ̹  ׳ ѱ ( ȣ⶧ ٽ )
+    {
+        if (_traceRecorder) _traceRecorder->RecordStalePop(currentIndex);
+        return; // 이번 프레임은 그냥 넘김 (다음 호출때 다시 꺼냄)
+    }
 
-    // 3. 湮 Ȯ
+    // 3. 방문 확정
     current->isClosed = true;
+    ++_expandCount;
     _closedList.push_back(current);
+    SetCellType(currentIndex, NodeType::CLOSED);
+    if (_traceRecorder) _traceRecorder->RecordExpand(currentIndex);
 
-    // 4.   üũ
+    // 4. 목적지 도착 체크
     if (current->x == _targetEnd.x && current->y == _targetEnd.y)
     {
-        _state = State::FINISHED; // ãҴ!
-
-        //  
-        Node* trace = current;
-        while (trace)
-        {
-            _lastPath.push_back({ trace->x, trace->y });
-            trace = trace->parent;
-        }
-        // [߿]  ->   
-        std::reverse(_lastPath.begin(), _lastPath.end());
+        _state = State::FINISHED; // 찾았다!
+        _unexpandedGoal = current;
+        BuildPath(current);
         return;
     }
 
-    // 5. 8 Ž
-    for (int i = 0; i < 8; ++i)
+    // 5. 8방향 탐색
+    // 미리 계산된 이동 마스크의 켜진 비트만 순회 (벽/범위/코너 체크 불필요)
+    unsigned int moveMask = _moveMask[currentIndex];
+    if (!_allowDiagonal) moveMask &= 0x0F; // 직선 4방향만
+
+    // [추가] 이웃 8칸의 g / h를 한 번에 계산해 두고 켜진 방향만 꺼내 씀
+    SimdNeighbors::Result neighbors;
+    if (moveMask != 0)
+        SimdNeighbors::Evaluate(_simdLevel, current->x, current->y, current->g, _targetEnd, _heuristicType, _weight, neighbors);
+
+    while (moveMask != 0)
     {
+        int i = std::countr_zero(moveMask);
+        moveMask &= moveMask - 1;
+
         int nextX = current->x + dx[i];
         int nextY = current->y + dy[i];
 
-        if (!IsWalkable(nextX, nextY)) continue;
-        if (nextX < 0 || nextX >= _mapWidth || nextY < 0 || nextY >= _mapHeight) continue;
+        int nextIndex = nextY * _mapWidth + nextX;
 
-        // 밢 & ڳʸ üũ
-        if (!_allowDiagonal && i >= 4) continue;
-        if (i >= 4)
+        // [추가] 출발/도착과 상관없는 늪 안으로는 들어가지 않음
+        if (_swampMap && _swampMap->IsPruned(nextIndex))
         {
-            if (!IsWalkable(current->x, nextY) && !IsWalkable(nextX, current->y))
-                continue;
+            ++_swampSkipCount;
+            continue;
         }
 
-        int nextIndex = nextY * _mapWidth + nextX;
         Node* nextNode = _nodeMap[nextIndex];
 
         if (nextNode != nullptr && nextNode->isClosed) continue;
 
-        float newG = current->g + cost[i];
+        float newG = neighbors.g[i];
 
-        // Case A: ó 湮
+        // Case A: 처음 방문
         if (nextNode == nullptr)
         {
-            float newH = CalculateH({ nextX, nextY }, _targetEnd);
+            // [추가] 잊었던 셀은 그때보다 나은 경로로 올 때만 다시 만듦
+            // (부모가 다시 펼칠 때는 같은 g로 오므로 통과, 이미 탐색한 안쪽을 옆에서 다시 파고드는 건 막음)
+            if (_boundResult != BoundResult::EXACT && newG > _forgottenG[nextIndex] + 0.0001f) continue;
+
+            float newH = neighbors.h[i];
             nextNode = _nodePool.Alloc(nextX, nextY, current, newG, newH);
             _createdNodes.push_back(nextNode);
             _nodeMap[nextIndex] = nextNode;
+            SetCellType(nextIndex, NodeType::OPEN);
 
-            _openList.push_back(nextNode);
-            std::push_heap(_openList.begin(), _openList.end(), NodeCompare());
+            _openList.push_back({ nextNode->f, nextNode->h, nextNode });
+            std::push_heap(_openList.begin(), _openList.end(), OpenEntryCompare());
+            if (_traceRecorder) _traceRecorder->RecordPush(i);
         }
-        // Case B:    ߰
+        // Case B: 더 좋은 경로 발견
         else if (newG < nextNode->g)
         {
             nextNode->g = newG;
             nextNode->f = newG + nextNode->h;
+            --nextNode->parent->childCount;
             nextNode->parent = current;
+            ++current->childCount;
+
+            // 이전 항목은 키가 그대로 남아 있다가 나중에 닫힌 노드로 버려짐
+            _openList.push_back({ nextNode->f, nextNode->h, nextNode });
+            std::push_heap(_openList.begin(), _openList.end(), OpenEntryCompare());
+            if (_traceRecorder) _traceRecorder->RecordDecrease(i);
+        }
+    }
+}
+
+void AStar::SetNodeLimit(int maxNodes)
+{
+    // [수정] 받은 값을 그대로 지킴 (작은 값을 64로 올리면 호출자가 정한 상한을 넘게 됨)
+    // 확장 한 번에 8개까지 생기므로 남은 자리가 8개보다 적고 잊을 잎도 없으면 UpdatePathFinding이 PARTIAL로 끝냄
+    _nodeLimit = (maxNodes <= 0) ? 0 : maxNodes;
+}
+
+bool AStar::IsPathOptimal() const
+{
+    if (_state != State::FINISHED || _boundResult != BoundResult::EXACT) return false;
+    if (_weight > 1.0f) return false;
+
+    // 맨해튼은 대각선 이동이 있으면 실제 거리보다 크게 잡음
+    return _heuristicType != HeuristicType::MANHATTAN || !_allowDiagonal;
+}
+
+bool AStar::PruneNodes()
+{
+    int needed = (int)_createdNodes.size() + 8 - _nodeLimit;
+
+    // 1. 정리 후보: 시작 노드가 아닌 잎 노드 (자식이 있는 노드를 지우면 parent 포인터가 끊김)
+    std::vector<Node*> candidates;
+    for (Node* node : _createdNodes)
+    {
+        if (node->childCount == 0 && node->parent != nullptr)
+            candidates.push_back(node);
+    }
+    if ((int)candidates.size() < needed) return false;
+
+    // 한 번에 상한의 1/8 정도를 비워서 정리 비용을 나눠 냄
+    int pruneCount = (std::max)(needed, (std::min)((int)candidates.size(), _nodeLimit / 8));
+
+    if (_forgottenG.size() != _nodeMap.size())
+        _forgottenG.assign(_nodeMap.size(), std::numeric_limits<float>::infinity());
+
+    // 닫힌 잎(펼쳤는데 자식이 없음 = 이 노드를 거쳐야만 갈 수 있는 곳이 없음)은 잊어도 잃는 게 없으므로 먼저,
+    // 그다음은 f가 나쁜 열린 잎부터 (NodeCompare가 true면 a가 더 나쁨)
+    std::nth_element(candidates.begin(), candidates.begin() + (pruneCount - 1), candidates.end(),
+        [](const Node* a, const Node* b)
+        {
+            if (a->isClosed != b->isClosed) return a->isClosed;
+            return NodeCompare()(a, b);
+        });
 
-            _openList.push_back(nextNode);
-            std::push_heap(_openList.begin(), _openList.end(), NodeCompare());
+    // 2. 열린 잎은 f를 부모에 남기고, 닫힌 부모는 다시 열어서 필요하면 다시 펼치게 함
+    for (int i = 0; i < pruneCount; ++i)
+    {
+        Node* node = candidates[i];
+        Node* parent = node->parent;
+        --parent->childCount;
+
+        if (node->isClosed)
+        {
+            // 닫힌 잎: 부모에 남길 정보 없음
+        }
+        else if (parent->isClosed)
+        {
+            parent->isClosed = false;
+            parent->f = node->f;
+            SetCellType(parent->y * _mapWidth + parent->x, NodeType::OPEN);
+        }
+        else
+        {
+            parent->f = (std::min)(parent->f, node->f);
         }
+
+        int index = node->y * _mapWidth + node->x;
+        _forgottenG[index] = (std::min)(_forgottenG[index], node->g);
+        _nodeMap[index] = nullptr;
+        RefreshCellType(index);
     }
+
+    // 3. 목록 재구성 (_nodeMap에서 빠진 노드 = 잊은 노드)
+    auto isAlive = [this](const Node* node) { return _nodeMap[node->y * _mapWidth + node->x] == node; };
+
+    _closedList.erase(std::remove_if(_closedList.begin(), _closedList.end(),
+        [&](const Node* node) { return !isAlive(node) || !node->isClosed; }), _closedList.end());
+
+    // 반납은 다른 목록을 다 정리한 뒤에 (반납한 노드는 읽으면 안 됨)
+    _createdNodes.erase(std::remove_if(_createdNodes.begin(), _createdNodes.end(), [&](Node* node)
+        {
+            if (isAlive(node)) return false;
+            _nodePool.Free(node);
+            return true;
+        }), _createdNodes.end());
+
+    // 부모의 f를 바꿨으니 힙도 새로 쌓음 (Lazy Deletion으로 남은 낡은 항목도 같이 정리)
+    _openList.clear();
+    for (Node* node : _createdNodes)
+    {
+        if (!node->isClosed) _openList.push_back({ node->f, node->h, node });
+    }
+    std::make_heap(_openList.begin(), _openList.end(), OpenEntryCompare());
+
+    _boundResult = BoundResult::PRUNED;
+    _searchTreeValid = false; // 잊은 노드가 있으니 목적지 교체 시 이어 쓰지 않음
+    return true;
+}
+
+void AStar::FinishPartial()
+{
+    // 닫힌 노드 중 목적지에 가장 가까운(h가 가장 작은) 곳까지의 경로를 남김
+    Node* best = nullptr;
+    for (Node* node : _closedList)
+    {
+        if (best == nullptr || node->h < best->h) best = node;
+    }
+
+    _lastPath.clear();
+    _pathEnd = nullptr;
+    if (best) BuildPath(best);
+
+    _boundResult = BoundResult::PARTIAL;
+    _searchTreeValid = false;
+    _state = State::FAILED;
 }
 
 void AStar::ClearNodes()
@@ -196,13 +811,20 @@ void AStar::ClearNodes()
     {
         int index = node->y * _mapWidth + node->x;
         _nodeMap[index] = nullptr;
+        RefreshCellType(index);
         _nodePool.Free(node);
     }
 
-    // Ʈ ʱȭ
+    // 리스트 초기화
     _createdNodes.clear();
-
-    //  Open, ClosedList ݴϴ (͸ )
+    _unexpandedGoal = nullptr;
+    _pathEnd = nullptr;
+    _expandCount = 0;
+    if (_boundResult != BoundResult::EXACT)
+        std::fill(_forgottenG.begin(), _forgottenG.end(), std::numeric_limits<float>::infinity());
+    _boundResult = BoundResult::EXACT;
+
+    // 물론 Open, ClosedList도 비워줍니다 (포인터만 날림)
     _openList.clear();
     _closedList.clear();
 }
@@ -211,7 +833,7 @@ void AStar::Draw(DrawCallback drawFunc)
 {
     if (drawFunc == nullptr) return;
 
-    // 1. ü  () ׸
+    // 1. 전체 맵 (벽) 그리기
     for (int y = 0; y < _mapHeight; ++y)
     {
         for (int x = 0; x < _mapWidth; ++x)
@@ -221,81 +843,86 @@ void AStar::Draw(DrawCallback drawFunc)
         }
     }
 
-    // 2. ClosedList (湮  - )
+    // 2. ClosedList (방문 함 - 빨강)
     for (Node* node : _closedList)
     {
-        //    ʱ  üũ 
+        // 시작점과 도착점은 덮어쓰지 않기 위해 체크 가능
         drawFunc(node->x, node->y, NodeType::CLOSED);
     }
 
-    // 3. OpenList (湮  - ʷ)
-    for (Node* node : _openList)
+    // 3. OpenList (방문 예정 - 초록)
+    for (const OpenEntry& entry : _openList)
     {
-        if (node->isClosed) continue; // ߺ 
-        drawFunc(node->x, node->y, NodeType::OPEN);
+        if (entry.node->isClosed) continue; // 중복 제거
+        drawFunc(entry.node->x, entry.node->y, NodeType::OPEN);
     }
 
-    // 4.   (Ķ)
+    // 4. 최종 경로 (파랑)
     for (const Point& p : _lastPath)
     {
         drawFunc(p.x, p.y, NodeType::PATH);
     }
 
-    // 5. ,  
+    // 5. 시작점, 도착점 강조
     if (_lastStart.x != -1) drawFunc(_lastStart.x, _lastStart.y, NodeType::START);
     if (_lastEnd.x != -1) drawFunc(_lastEnd.x, _lastEnd.y, NodeType::END);
 }
 
-// 1. ϰ  Ѹ
+// 1. 랜덤하게 벽 뿌리기
 void AStar::GenerateRandomMap(int fillPercent)
 {
-    //   ʱȭ
-    ClearObstacles();
-    ClearNodes(); // ã ͵  
+    // 기존 데이터 초기화
+    // [수정] 벽은 아래에서 모든 칸을 새로 쓰므로 ClearObstacles(재계산 + 기록)는 하지 않음 -> 끝에서 한 번만
+    ClearNodes(); // 길찾기 데이터도 날려야 안전
     _lastPath.clear();
     _state = State::READY;
+    _searchTreeValid = false;
 
     for (int y = 0; y < _mapHeight; ++y)
     {
         for (int x = 0; x < _mapWidth; ++x)
         {
-            // ڸ    (  )
+            // 가장자리는 무조건 벽으로 막기 (나가는 길 방지)
             if (x == 0 || x == _mapWidth - 1 || y == 0 || y == _mapHeight - 1)
             {
                 _mapGrid[y * _mapWidth + x] = true;
             }
             else
             {
-                // fillPercent Ȯ  
-                // (rand % 100) -> 0~99  
+                // fillPercent 확률로 벽 생성
+                // (rand % 100) -> 0~99 사이 난수
                 bool isWall = (std::rand() % 100) < fillPercent;
                 _mapGrid[y * _mapWidth + x] = isWall;
             }
         }
     }
+
+    RebuildMoveMasks();
+    RefreshAllCellTypes();
+    RecordMapChange(0, 0, _mapWidth - 1, _mapHeight - 1);
 }
 
-// 2. ֺ    (Smoothing)
+// 2. 주변 벽 개수 세기 (Smoothing용)
 int AStar::GetSurroundingWallCount(int gridX, int gridY)
 {
     int wallCount = 0;
 
-    //  ֺ 8ĭ +  ڽű ˻ (3x3 )
+    // 내 주변 8칸 + 나 자신까지 검사 (3x3 영역)
     for (int neighborY = gridY - 1; neighborY <= gridY + 1; ++neighborY)
     {
         for (int neighborX = gridX - 1; neighborX <= gridX + 1; ++neighborX)
         {
-            //   ̸ ׳  Ĩϴ (  ϱ )
+            // 맵 범위 밖이면 그냥 벽으로 칩니다 (동굴 안쪽으로 유도하기 위해)
             if (neighborX < 0 || neighborX >= _mapWidth || neighborY < 0 || neighborY >= _mapHeight)
             {
                 wallCount++;
             }
-            // ڱ ڽ ϰ ϴ 쵵 , 
-            // ⼭ ڱ ġ ƴ  ų,   ϱ⵵ .
-            //  ڱ ڽ ϰ .
+            // 자기 자신은 제외하고 계산하는 경우도 있지만, 
+            // 여기서는 자기 위치가 아닐 때만 세거나, 로직에 따라 포함하기도 함.
+            // 보통 자기 자신 제외하고 셈.
             else if (neighborX != gridX || neighborY != gridY)
             {
-                // ̸ īƮ
+                // 벽이면 카운트
                 if (_mapGrid[neighborY * _mapWidth + neighborX])
                 {
                     wallCount++;
@@ -306,10 +933,10 @@ int AStar::GetSurroundingWallCount(int gridX, int gridY)
     return wallCount;
 }
 
-// 3. ٵ (Smoothing) - ٽ ˰
+// 3. 다듬기 (Smoothing) - 핵심 알고리즘
 void AStar::SmoothMap()
 {
-    std::vector<bool> newMap = _mapGrid; //   纻 
+    std::vector<bool> newMap = _mapGrid; // 현재 맵 복사본 생성
 
     for (int y = 0; y < _mapHeight; ++y)
     {
@@ -317,17 +944,21 @@ void AStar::SmoothMap()
         {
             int neighborWallTiles = GetSurroundingWallCount(x, y);
 
-            // [Ģ]
-            // ֺ  4  ->    ( ħ)
+            // [규칙]
+            // 주변에 벽이 4개보다 많으면 -> 나도 벽이 됨 (벽이 뭉침)
             if (neighborWallTiles > 4)
                 newMap[y * _mapWidth + x] = true;
-            // ֺ  4  ->     ( о)
+            // 주변에 벽이 4개보다 적으면 -> 나는 빈 땅이 됨 (구멍이 넓어짐)
             else if (neighborWallTiles < 4)
                 newMap[y * _mapWidth + x] = false;
 
-            // 4? ->   (  ״)
+            // 4개면? -> 현상 유지 (기존 값 그대로)
         }
     }
 
-    _mapGrid = newMap; //  
+    _mapGrid = newMap; // 맵 덮어쓰기
+    RebuildMoveMasks();
+    RefreshAllCellTypes();
+    _searchTreeValid = false;
+    RecordMapChange(0, 0, _mapWidth - 1, _mapHeight - 1);
 }
\ No newline at end of file
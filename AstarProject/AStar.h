@@ -10,7 +10,7 @@ struct Point
 };
 
 // -----------------------------------------------------------
-// 1. Node ü
+// 1. Node 구조체
 // -----------------------------------------------------------
 struct Node
 {
@@ -18,16 +18,19 @@ struct Node
     int y;
     Node* parent;
 
-    float g; // κ ̵ Ÿ (float)
-    float h; //   Ÿ (float)
+    float g; // 시작점으로부터의 이동 거리 (float)
+    float h; // 목적지와의 절대적 거리 (float)
     float f; // f = g + h (float)
 
     bool isClosed;
-    // MemoryPool Alloc ȣ 
-    // placement new  Ҵ ÿ ʱȭ˴ϴ.
+    int childCount; // [추가] 이 노드를 parent로 가리키는 노드 수 (0이면 잎 노드 -> 메모리 상한 시 정리 대상)
+
+    // MemoryPool의 Alloc에서 호출할 생성자
+    // placement new를 통해 할당과 동시에 초기화됩니다.
     Node(int _x, int _y, Node* _parent, float _g, float _h)
-        : x(_x), y(_y), parent(_parent), g(_g), h(_h), f(_g + _h), isClosed(false) // false ʱȭ
+        : x(_x), y(_y), parent(_parent), g(_g), h(_h), f(_g + _h), isClosed(false), childCount(0) // false로 초기화
     {
+        if (parent) ++parent->childCount;
     }
 };
 
@@ -35,124 +38,375 @@ struct NodeCompare
 {
     bool operator()(const Node* a, const Node* b) const
     {
-        // [߰] F  ٸ (float  )
+        // [추가] F값이 거의 같다면 (float 오차 고려)
         if (std::abs(a->f - b->f) < 0.0001f)
         {
-            // H  ( ) 尡 켱  
-            // (std::push_heap true  a ڷ  -> , a b '' ̶ )
-            // H ũ  ̹Ƿ true ȯ
+            // H가 더 작은(목적지에 가까운) 노드가 우선순위를 갖도록 함
+            // (std::push_heap은 true일 때 a를 뒤로 보냄 -> 즉, a가 b보다 '나쁜' 놈이라는 뜻)
+            // H가 크면 나쁜 놈이므로 true 반환
             return a->h > b->h;
         }
-        return a->f > b->f; //  (Min-Heap)
+        return a->f > b->f; // 오름차순 (Min-Heap)
+    }
+};
+
+// [수정] 열린 목록 항목: 넣을 때의 f / h를 복사해 둠
+// 노드의 f를 직접 비교하면 더 좋은 경로로 g가 줄 때 힙 안에 이미 있는 항목의 키도 같이 바뀌어 힙 순서가 깨짐
+// (pop이 최소가 아닌 노드를 꺼내서 옥타일 같은 일관된 휴리스틱에서도 경로가 최적이 아니게 됨)
+// 낡은 항목은 그대로 두고 새 항목을 넣은 뒤, 꺼낼 때 이미 닫힌 노드면 버림 (Lazy Deletion)
+struct OpenEntry
+{
+    float f;
+    float h;
+    Node* node;
+};
+
+// [수정] f / h 멤버가 있는 열린 목록 항목이면 모두 비교 (ParallelAStar, ChunkedAStar 등 다른 탐색기도 같이 씀)
+struct OpenEntryCompare
+{
+    template <typename T>
+    bool operator()(const T& a, const T& b) const
+    {
+        // NodeCompare와 같은 순서 (f 같으면 h 작은 쪽 우선)
+        if (std::abs(a.f - b.f) < 0.0001f) return a.h > b.h;
+        return a.f > b.f;
+    }
+};
+
+// [추가] (거리, 셀 인덱스) 최소 힙 비교자 (FlowField, DistanceTable 등의 Dijkstra용)
+struct DistEntryCompare
+{
+    bool operator()(const std::pair<float, int>& a, const std::pair<float, int>& b) const
+    {
+        return a.first > b.first;
     }
 };
 
+class SearchTraceRecorder;
+class CompactPath;
+class SwampMap;
+
 // -----------------------------------------------------------
-// 2. AStar Ŭ 
+// 2. AStar 클래스 선언
 // -----------------------------------------------------------
 class AStar
 {
 public:
-    enum class HeuristicType { MANHATTAN, EUCLIDEAN };
+    enum class HeuristicType { MANHATTAN, EUCLIDEAN, OCTILE }; // [추가] OCTILE: 대각선 이동 비용에 맞춘 거리 (일관됨)
     enum class NodeType { NONE, OPEN, CLOSED, PATH, WALL, START, END };
 
-    // [߰]  Ž ¸ Ÿ 
+    // [추가] 현재 탐색 상태를 나타내는 열거형
     enum class State { READY, SEARCHING, FINISHED, FAILED };    
+
+    // [추가] 노드 상한 탐색 결과
+    // EXACT  : 상한에 걸리지 않음 (상한 없이 탐색한 것과 같은 결과)
+    // PRUNED : 나쁜 잎 노드를 잊어가며 탐색함 (경로는 유효하지만 더 나쁠 수 있음)
+    // PARTIAL: 메모리/확장 한도 소진. FAILED 상태이며 GetPath는 목적지에 가장 가까이 간 곳까지의 경로
+    enum class BoundResult { EXACT, PRUNED, PARTIAL };
+
+    // [추가] 이웃 평가에 쓰는 명령어 집합 (SimdNeighbors 참고)
+    enum class SimdLevel { SCALAR, SSE2, AVX2 };
+
+    // [추가] 맵 변경 기록 한 건: version에서 벽 상태가 바뀌었을 수 있는 사각형 (맵 안으로 잘린 셀 범위)
+    struct MapChange
+    {
+        unsigned int version;
+        int x;
+        int y;
+        int width;
+        int height;
+    };
+
+    // [추가] 셀 표시 상태 전이 이벤트 (셀 인덱스 = y * 맵너비 + x)
+    struct CellEvent
+    {
+        int index;
+        NodeType type; // 바뀐 뒤의 상태
+    };
+
+    // 8방향 이동 테이블 (0~3: 직선, 4~7: 대각선)
+    // FlowField 등 같은 맵을 쓰는 다른 탐색기도 이 순서를 그대로 사용합니다.
+    static constexpr int dx[8] = { 0, 0, -1, 1, - 1, 1, -1, 1 };
+    static constexpr int dy[8] = { -1, 1, 0, 0 , -1, -1, 1, 1 };
+    static constexpr float cost[8] = { 1.0f, 1.0f, 1.0f, 1.0f, 1.414f, 1.414f, 1.414f, 1.414f };
+
+    // [추가] 가중치 없는 휴리스틱 거리 (CalculateH와 다른 탐색기들이 같은 식을 씀)
+    static float HeuristicDistance(HeuristicType type, Point from, Point to)
+    {
+        float distX = std::abs((float)(from.x - to.x));
+        float distY = std::abs((float)(from.y - to.y));
+
+        switch (type) {
+        case HeuristicType::MANHATTAN:
+            return distX + distY;
+        case HeuristicType::EUCLIDEAN:
+            return std::sqrt(distX * distX + distY * distY);
+        case HeuristicType::OCTILE:
+            // 직선 max + 대각선 보정 min (SimdNeighbors와 같은 연산 순서)
+            return (std::max)(distX, distY) + (cost[4] - 1.0f) * (std::min)(distX, distY);
+        }
+        return 0.0f;
+    }
+
+    // [추가] 대각선 허용 여부에 맞는 일관된 휴리스틱 (대각선: 옥타일 / 4방향: 맨해튼)
+    static HeuristicType GetConsistentHeuristic(bool allowDiagonal)
+    {
+        return allowDiagonal ? HeuristicType::OCTILE : HeuristicType::MANHATTAN;
+    }
 public:
-    // ڿ ޸ Ǯ ʱ ũ⸦ մϴ.
+    // 생성자에서 메모리 풀의 초기 크기를 설정합니다.
     AStar(int mapWidth, int mapHeight);
     ~AStar();
 
-    // 1. ʱȭ:  ũ   ޸ Ȯ
+    // 1. 초기화: 맵 크기 설정 및 메모리 확보
     void Initialize(int mapWidth, int mapHeight);
 
 
-    // 2. ֹ 
+    // 2. 장애물 설정
     void SetObstacle(int x, int y, bool isWall);
-    void ClearObstacles(); //  ֹ 
+    void ClearObstacles(); // 모든 장애물 제거
+
+    // [추가] 일괄 편집. 맵 밖으로 나간 부분은 잘라내고, 이동 마스크/표시 상태는 끝에 한 번만 갱신
+    // 행 단위 구간 채우기(std::fill)로 처리하므로 vector<bool>의 워드 단위 채우기가 적용됩니다.
+    void FillRect(int x, int y, int width, int height, bool isWall);
+    void PaintBrush(int centerX, int centerY, int radius, bool isWall); // 원형 브러시
+    // mask: 행마다 (maskWidth + 63) / 64개의 64비트 워드 (비트 i = 그 행의 i번째 칸)
+    // 비트가 1인 칸만 isWall로 바꿈. 0인 워드는 통째로 건너뜀
+    void ApplyMask(int x, int y, int maskWidth, int maskHeight, const std::vector<unsigned long long>& mask, bool isWall);
+    // [추가] 맵 전체를 wallMask(맵 크기, 형식은 ApplyMask와 같음)로 교체. 지우기 + 칠하기를 변경 기록 한 건으로
+    void ReplaceObstacles(const std::vector<unsigned long long>& wallMask);
+
+    // [추가] 맵 변경 기록 (추가만 되는 로그)
+    // 벽이 바뀌는 편집마다 맵 버전이 1씩 오르고 바뀐 사각형이 기록됩니다.
+    // 캐시/전처리 구조는 마지막으로 반영한 버전을 들고 있다가 GetChangesSince로 그 뒤 변경만 받아가면 됩니다.
+    // 기록은 최근 MAP_JOURNAL_CAPACITY건만 유지. 그보다 오래된 버전이나 맵 크기 변경 전 버전이면
+    // false를 돌려주므로 그때는 전체를 다시 읽어야 합니다.
+    static constexpr int MAP_JOURNAL_CAPACITY = 1024;
+    unsigned int GetMapVersion() const { return _mapVersion; }
+    bool GetChangesSince(unsigned int version, std::vector<MapChange>& out) const;
 
-    // ã 
-    void StartPathFinding(Point start, Point end); // 1. Ž  غ
-    void UpdatePathFinding();                      // 2.  ܰ( ϳ) ó
+    // 길찾기 실행
+    void StartPathFinding(Point start, Point end); // 1. 탐색 시작 준비
+    void UpdatePathFinding();                      // 2. 한 단계(노드 하나) 처리
 
-    // [߰]   Ȯο
+    // [추가] 현재 상태 확인용
     State GetState() const { return _state; }
-    const std::vector<Point>& GetPath() const { return _lastPath; } // ϼ  ȯ
+    const std::vector<Point>& GetPath() const { return _lastPath; } // 완성된 경로 반환
+    // [추가] 같은 경로를 런 길이 인코딩으로 (노드 parent 체인에서 바로 만듦). 경로가 없으면 false
+    bool GetCompactPath(CompactPath& out) const;
 
-    bool IsWalkable(int x, int y); //  üũ
+    bool IsWalkable(int x, int y) const; // 벽인지 체크
 
-    //  
+    // 설정 관련
     void SetHeuristicType(HeuristicType type) { _heuristicType = type; }
-    void SetHeuristicWeight(float weight) { _weight = weight; } // ġ (⺻ 1.0)
-    void SetAllowDiagonal(bool allow) { _allowDiagonal = allow; } // 밢 ̵  
+    void SetHeuristicWeight(float weight) { _weight = weight; } // 가중치 (기본 1.0)
+    float GetHeuristicWeight() const { return _weight; }
+    void SetAllowDiagonal(bool allow) { _allowDiagonal = allow; } // 대각선 이동 허용 여부
+
+    // [추가] 이웃 8칸 g / h 계산에 쓸 명령어 집합. 기본은 CPU가 지원하는 가장 높은 단계이고,
+    // 그보다 높은 단계를 요청하면 지원하는 최고 단계로 낮춤 (결과는 어느 단계든 같음, 비교 측정용)
+    void SetSimdLevel(SimdLevel level);
+    SimdLevel GetSimdLevel() const { return _simdLevel; }
+
+    // [추가] 탐색 트리 재사용 모드
+    // 켜두면 출발점이 같고 목적지만 바뀐 StartPathFinding은 이전 탐색의 노드를 버리지 않고,
+    // 확정된 g값은 그대로 둔 채 열린 목록만 새 목적지 기준으로 다시 정렬해 이어서 탐색합니다.
+    // (맵 편집 / 휴리스틱·가중치·대각선 설정 변경 / 기록기 연결 시에는 자동으로 새로 탐색)
+    // 일관된 휴리스틱(대각선 허용 시 EUCLIDEAN / OCTILE)이면 새로 탐색한 것과 같은 비용의 경로가 나오고,
+    // 맨해튼처럼 과대평가하는 휴리스틱이면 새로 탐색할 때와 마찬가지로 최적은 보장되지 않습니다.
+    void SetSearchTreeReuse(bool enable) { _searchTreeReuse = enable; }
+    bool GetSearchTreeReuse() const { return _searchTreeReuse; }
+
+    // [추가] 메모리 상한 탐색 (SMA* 방식)
+    // 살아 있는 노드 수가 maxNodes에 닿으면 f가 가장 나쁜 열린 잎 노드들을 반납하고,
+    // 그 부모를 잊힌 자식의 f값으로 다시 열어 나중에 필요하면 다시 펼치게 합니다.
+    // 0이면 상한 없음 (기본값). [수정] 값을 올리지 않고 그대로 지킴:
+    // 확장 전에 8자리를 비워 둬야 하므로 9보다 작으면 첫 확장도 못 하고 PARTIAL로 끝남
+    void SetNodeLimit(int maxNodes);
+    int GetNodeLimit() const { return _nodeLimit; }
+    BoundResult GetBoundResult() const { return _boundResult; }
+    // 찾은 경로가 최적임이 보장되는지 (상한에 안 걸렸고 휴리스틱이 과대평가하지 않을 때)
+    bool IsPathOptimal() const;
+    int GetLiveNodeCount() const { return (int)_createdNodes.size(); }
+    int GetExpandCount() const { return _expandCount; } // 이번 탐색에서 닫은 노드 수
 
-    // ðȭ Լ ( )
+    // [추가] 늪(막다른 주머니) 건너뛰기 모드. SwampMap::Build로 만든 전처리를 연결하면
+    // 탐색 시작마다 그 뒤의 맵 편집을 반영(SyncFrom)하고, 출발/도착이 들어 있지 않은 늪 칸은 이웃으로 만들지 않습니다.
+    // 경로 비용은 건너뛰지 않을 때와 같음. nullptr이면 끔. 수명은 호출자가 관리
+    void SetSwampMap(SwampMap* swamps) { _swampMap = swamps; _searchTreeValid = false; }
+    int GetSwampSkipCount() const { return _swampSkipCount; } // 이번 탐색에서 늪이라 만들지 않은 이웃 수
+
+    // [추가] 탐색 기록기 연결 (nullptr이면 기록 안 함). 기록기 수명은 호출자가 관리
+    // 기록 중에는 트리 재사용과 노드 상한의 잊기를 하지 않음 (상한에 닿으면 잊지 않고 PARTIAL로 끝남)
+    void SetTraceRecorder(SearchTraceRecorder* recorder) { _traceRecorder = recorder; }
+
+    // 시각화 함수 (추후 구현)
     using DrawCallback = std::function<void(int x, int y, NodeType type)>;
     void Draw(DrawCallback drawFunc);
 
-    // ðȭ :    Ʈ ȯ (const ϰ)
+    // 시각화 전용: 만들어진 모든 노드 리스트 반환 (const로 안전하게)
     const std::vector<Node*>& GetAllNodes() const { return _createdNodes; }
 
-    //    Ȯο (ȭ鿡  )
+    // [추가] 셀 단위 표시 상태 (WALL > PATH > CLOSED > OPEN > NONE 우선순위)
+    // 탐색/장애물 변경 시 바로 갱신되므로 렌더러는 이 값만 읽으면 됩니다.
+    NodeType GetCellType(int x, int y) const { return (NodeType)_cellType[y * _mapWidth + x]; }
+    const Node* GetNode(int x, int y) const { return _nodeMap[y * _mapWidth + x]; }
+
+    // 지난 호출 이후 표시 상태가 바뀐 셀 인덱스를 out에 담아줌 (중복 없음)
+    // 맵 크기가 바뀌어 전체를 다시 그려야 하면 true 반환 (out은 비어 있음)
+    // [수정] 켜둔 경우에만 기록 (기본은 꺼짐, 탐색 핫패스에서 비용이 들지 않게).
+    // 꺼져 있으면 TakeDirtyCells는 항상 true(전체 다시 그리기), 새로 켠 직후 첫 호출도 true
+    void SetDirtyTrackingEnabled(bool enable);
+    bool TakeDirtyCells(std::vector<int>& out);
+
+    // [추가] 상태 전이 이벤트 스트림
+    // 켜져 있는 동안 탐색/편집 중 일어난 (셀, 새 상태) 전이를 발생 순서대로 쌓아두고,
+    // PollCellEvents가 지난 호출 이후의 묶음을 out에 한꺼번에 넘겨줍니다.
+    // (셀마다 콜백을 부르는 Draw 대신 바뀐 것만 연속 메모리로 처리할 수 있음)
+    // 맵 크기 변경 / 이벤트를 새로 켠 직후처럼 전체 상태를 다시 읽어야 하면 true 반환
+    void SetCellEventsEnabled(bool enable);
+    bool PollCellEvents(std::vector<CellEvent>& out);
+
+    // 현재 설정 상태 확인용 (화면에 띄우기 위해)
     HeuristicType GetHeuristicType() const { return _heuristicType; }
     bool GetAllowDiagonal() const { return _allowDiagonal; }
 
-    // 1.    ä (fillPercent:   Ȯ,  45~50)
+    // [추가] 외부 탐색기(FlowField 등)용 맵 조회
+    int GetMapWidth() const { return _mapWidth; }
+    int GetMapHeight() const { return _mapHeight; }
+    // 대각선 허용 여부까지 반영된 이동 마스크 (벽이면 0)
+    unsigned char GetMoveMask(int x, int y) const
+    {
+        unsigned char mask = _moveMask[y * _mapWidth + x];
+        return _allowDiagonal ? mask : (unsigned char)(mask & 0x0F);
+    }
+    // [추가] 대각선 허용 여부와 상관없는 8방향 이동 마스크 (SwampMap처럼 설정이 바뀌어도 유효해야 하는 전처리용)
+    unsigned char GetRawMoveMask(int x, int y) const { return _moveMask[y * _mapWidth + x]; }
+
+    // 1. 맵을 랜덤한 노이즈로 채우기 (fillPercent: 벽이 될 확률, 보통 45~50)
     void GenerateRandomMap(int fillPercent = 45);
 
-    // 2.  ڵ Ģ  ܰ ٵ
+    // 2. 세포 자동자 규칙으로 한 단계 다듬기
     void SmoothMap();
 
 private:
     // -------------------------------------------------------
-    //   Լ
+    // 내부 헬퍼 함수
     // -------------------------------------------------------
 
     int GetSurroundingWallCount(int gridX, int gridY);
-    // ޸ƽ  (ɼǿ  б)
+    // 휴리스틱 계산 (옵션에 따라 분기)
     float CalculateH(Point current, Point end);
 
-    // Ž      ݳ
+    // 탐색 종료 후 사용한 모든 노드 반납
     void ClearNodes();
 
+    // [추가] 탐색 트리 재사용
+    bool CanReuseSearchTree(Point start, Point end) const;
+    void RetargetPathFinding(Point end); // 기존 트리를 유지한 채 목적지만 교체
+    void BuildPath(Node* goal);          // goal부터 parent를 따라 _lastPath 구성
+
+    // [추가] 노드 상한
+    bool PruneNodes();       // 나쁜 잎 노드 반납. 더 비울 게 없으면 false
+    void FinishPartial();    // 한도 소진: 가장 가까이 간 곳까지 경로를 남기고 FAILED
+
+    // [추가] 이동 가능 방향 마스크 (비트 i = dx[i], dy[i] 방향으로 이동 가능)
+    unsigned char ComputeMoveMask(int x, int y);
+    void UpdateMoveMask(int x, int y); // (x, y) 주변 3x3 셀의 마스크만 갱신
+    void RebuildMoveMasks();           // 맵 전체 마스크 재계산
+
+    // [추가] 일괄 편집 마무리: [x0, x1] x [y0, y1] (맵 안) 주변 마스크/표시 상태 갱신 + 변경 기록
+    void FinishEdit(int x0, int y0, int x1, int y1);
+    // [추가] 벽 비트만 씀 (마스크 / 표시 상태 / 변경 기록은 호출자가 한 번에). 바뀔 수 있는 사각형을 넓혀 줌
+    void ClearGrid();
+    void WriteMask(int x, int y, int maskWidth, int maskHeight, const std::vector<unsigned long long>& mask, bool isWall,
+        int& minX, int& minY, int& maxX, int& maxY);
+    void RecordMapChange(int x0, int y0, int x1, int y1);
+
+    // [추가] 셀 표시 상태 갱신 (바뀌면 더티 목록에 추가)
+    void SetCellType(int index, NodeType type);
+    void RefreshCellType(int index);   // 벽/노드 상태로부터 다시 계산
+    void RefreshAllCellTypes();
+
 private:
     // -------------------------------------------------------
-    //  
+    // 멤버 변수
     // -------------------------------------------------------
-    const int dx[8] = { 0, 0, -1, 1, - 1, 1, -1, 1 };
-    const int dy[8] = { -1, 1, 0, 0 , -1, -1, 1, 1 };
-    const float cost[8] = { 1.0f, 1.0f, 1.0f, 1.0f, 1.414f, 1.414f, 1.414f, 1.414f };
-    
     int _mapWidth;
     int _mapHeight;
 
     HeuristicType _heuristicType;
     float _weight;
     bool _allowDiagonal;
+    SimdLevel _simdLevel;
 
-    // [޸ Ǯ]
-    // Node ü ϴ Ǯ. AStar Ŭ  .
+    // [메모리 풀]
+    // Node 객체를 관리하는 풀. AStar 클래스 멤버로 존재.
     procademy::CMemoryPool<Node> _nodePool{ 1000, true };
 
-    // [Ž ̳]
-    // ⿡  Node*  _nodePool Alloc ͵Դϴ.
-    std::vector<Node*> _openList;   // (Heap)  
-    std::vector<Node*> _closedList; // 湮   (ݳ)
+    // [탐색용 컨테이너]
+    // 여기에 들어가는 Node*는 모두 _nodePool에서 Alloc된 것들입니다.
+    std::vector<OpenEntry> _openList; // 힙(Heap)으로 사용할 벡터
+    std::vector<Node*> _closedList; // 방문한 노드 보관 (반납용)
     std::vector<Node*> _createdNodes;
 
-    //  ˻   ̳ (ǥ 湮  Ȯο)
-    // : _visited[y][x] -> ش ġ  Node 
+    // 빠른 검색을 위한 보조 컨테이너 (좌표로 방문 여부 확인용)
+    // 예: _visited[y][x] -> 해당 위치에 생성된 Node 포인터
     std::vector<Node*> _nodeMap;
 
-    // [ ]
-    // true: (ֹ), false: ̵ 
+    // [맵 데이터]
+    // true: 벽(장애물), false: 이동 가능
     std::vector<bool> _mapGrid;
 
-    //    (Draw)
+    // [이동 마스크]
+    // 셀마다 8방향 이동 가능 여부를 1바이트로 미리 계산해둠 (벽 체크 + 코너 규칙 포함)
+    // 대각선 허용 여부는 Update에서 하위 4비트만 남기는 식으로 반영
+    std::vector<unsigned char> _moveMask;
+
+    // [맵 변경 기록]
+    unsigned int _mapVersion = 0;
+    unsigned int _journalStartVersion = 0; // 이 버전 이후의 변경만 _mapJournal에 남아 있음
+    std::vector<MapChange> _mapJournal;
+
+    // [셀 표시 상태 / 더티 추적]
+    std::vector<unsigned char> _cellType;  // NodeType 값
+    std::vector<unsigned char> _dirtyMark; // 1이면 이미 _dirtyCells에 들어 있음
+    std::vector<int> _dirtyCells;
+    bool _fullDirty = true;
+    bool _dirtyTrackingEnabled = false;
+
+    // [상태 전이 이벤트]
+    bool _cellEventsEnabled = false;
+    bool _cellEventsReset = true;
+    std::vector<CellEvent> _cellEvents;
+
+    // 마지막 경로 저장 (Draw용)
     std::vector<Point> _lastPath;
     Point _lastStart{ -1, -1 };
     Point _lastEnd{ -1, -1 };
 
+    SearchTraceRecorder* _traceRecorder = nullptr;
+
+    // [탐색 트리 재사용]
+    bool _searchTreeReuse = false;
+    bool _searchTreeValid = false;      // 맵 편집 등으로 트리가 무효가 되면 false
+    HeuristicType _treeHeuristicType{}; // 트리를 만들 때의 설정 (바뀌면 재사용 불가)
+    float _treeWeight = 1.0f;
+    bool _treeAllowDiagonal = true;
+    Node* _unexpandedGoal = nullptr;    // 도착해서 닫기만 하고 이웃은 펼치지 않은 목적지 노드
+    Node* _pathEnd = nullptr;           // _lastPath의 마지막 칸 노드 (GetCompactPath용)
+    unsigned int _treeSwampRevision = 0; // 트리를 만들 때의 늪 전처리 상태
+
+    // [노드 상한]
+    int _nodeLimit = 0;
+    int _expandCount = 0;               // 이번 탐색의 확장 횟수 (다시 펼치기가 끝없이 반복되는 것 방지)
+    BoundResult _boundResult = BoundResult::EXACT;
+    std::vector<float> _forgottenG;     // 잊은 셀의 g (정리가 한 번이라도 일어난 탐색에서만 사용)
+
+    // [늪 건너뛰기]
+    SwampMap* _swampMap = nullptr;
+    int _swampSkipCount = 0;
+
     State _state = State::READY;
-    Point _targetEnd = { -1, -1 }; //  
+    Point _targetEnd = { -1, -1 }; // 목적지 저장용
 };
\ No newline at end of file
@@ -0,0 +1,271 @@
+﻿#include "MemoryPool.h"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <chrono>
+#include <bit>
+#include "AStar.h"
+#include "AnytimeAStar.h"
+
+namespace
+{
+    const float INF = std::numeric_limits<float>::infinity();
+
+    // 마감 시각 확인 간격 (확장 수 기준, 매번 시계를 읽지 않도록)
+    const int CLOCK_CHECK_INTERVAL = 64;
+
+    // 가중치 감소 단계가 너무 잘게 나뉘지 않도록 반복 수 상한
+    const unsigned int MAX_ITERATIONS = 4096;
+}
+
+AnytimeAStar::AnytimeAStar(const AStar& map)
+    : _map(map)
+{
+}
+
+float AnytimeAStar::CalculateH(int index) const
+{
+    // 가중치를 1까지 낮췄을 때 최적이 보장되도록 일관된(consistent) 휴리스틱만 사용
+    // 대각선 허용: 옥타일 거리 / 4방향: 맨해튼 거리
+    int width = _map.GetMapWidth();
+    return AStar::HeuristicDistance(AStar::GetConsistentHeuristic(_map.GetAllowDiagonal()), { index % width, index / width }, _end);
+}
+
+void AnytimeAStar::NewStamp()
+{
+    // 번호가 한 바퀴 돌면 실제로 지워줌 (진행 중인 탐색도 처음부터 다시 시작해야 하므로 Start에서만 호출)
+    if (++_stamp == 0)
+    {
+        std::fill(_visitStamp.begin(), _visitStamp.end(), 0);
+        std::fill(_openStamp.begin(), _openStamp.end(), 0);
+        std::fill(_closedStamp.begin(), _closedStamp.end(), 0);
+        std::fill(_inconsStamp.begin(), _inconsStamp.end(), 0);
+        _stamp = 1;
+    }
+}
+
+void AnytimeAStar::Start(Point start, Point end, float initialWeight, float weightStep)
+{
+    int width = _map.GetMapWidth();
+    int height = _map.GetMapHeight();
+    size_t cellCount = (size_t)width * height;
+    if (_g.size() != cellCount)
+    {
+        _g.assign(cellCount, INF);
+        _h.assign(cellCount, 0.0f);
+        _parent.assign(cellCount, -1);
+        _visitStamp.assign(cellCount, 0);
+        _openStamp.assign(cellCount, 0);
+        _closedStamp.assign(cellCount, 0);
+        _inconsStamp.assign(cellCount, 0);
+        _stamp = 0;
+    }
+
+    _weight = (std::max)(initialWeight, 1.0f);
+    _weightStep = (std::max)(weightStep, (_weight - 1.0f) / MAX_ITERATIONS);
+    _weightStep = (std::max)(_weightStep, 0.01f);
+
+    // 반복마다 번호를 하나씩 쓰므로, 탐색 도중 번호가 한 바퀴 돌지 않게 남은 번호가 부족하면 미리 돌려줌
+    if (_stamp > std::numeric_limits<unsigned int>::max() - (MAX_ITERATIONS + 2))
+        _stamp = std::numeric_limits<unsigned int>::max();
+    NewStamp();
+    _searchStamp = _stamp;
+
+    _open.clear();
+    _incons.clear();
+    _path.clear();
+    _pathCost = 0.0f;
+    _bound = INF;
+    _iterationCount = 0;
+    _expandedCount = 0;
+    _end = end;
+    _startIndex = -1;
+    _endIndex = -1;
+
+    if (start.x < 0 || start.x >= width || start.y < 0 || start.y >= height ||
+        end.x < 0 || end.x >= width || end.y < 0 || end.y >= height ||
+        !_map.IsWalkable(start.x, start.y) || !_map.IsWalkable(end.x, end.y))
+    {
+        _state = AStar::State::FAILED;
+        return;
+    }
+
+    _startIndex = start.y * width + start.x;
+    _endIndex = end.y * width + end.x;
+
+    _visitStamp[_startIndex] = _stamp;
+    _g[_startIndex] = 0.0f;
+    _h[_startIndex] = CalculateH(_startIndex);
+    _parent[_startIndex] = -1;
+    PushOpen(_startIndex);
+
+    _state = AStar::State::SEARCHING;
+}
+
+void AnytimeAStar::PushOpen(int index)
+{
+    _openStamp[index] = _stamp;
+    _open.push_back({ GetKey(index), _g[index], index });
+    std::push_heap(_open.begin(), _open.end(), [](const OpenEntry& a, const OpenEntry& b) { return a.key > b.key; });
+}
+
+bool AnytimeAStar::IsOpenEntryValid(const OpenEntry& entry) const
+{
+    // g가 줄어 다시 넣었거나 이미 확장된 셀의 항목은 낡은 것
+    return _openStamp[entry.index] == _stamp && entry.g == _g[entry.index];
+}
+
+int AnytimeAStar::Run(std::chrono::steady_clock::time_point deadline, int expansionBudget)
+{
+    auto compare = [](const OpenEntry& a, const OpenEntry& b) { return a.key > b.key; };
+    int width = _map.GetMapWidth();
+    int expanded = 0;
+
+    while (_state == AStar::State::SEARCHING)
+    {
+        // 1. ImprovePath: 목적지의 g가 OPEN 최소 키 이하가 될 때까지 확장
+        float goalG = (_visitStamp[_endIndex] >= _searchStamp) ? _g[_endIndex] : INF;
+        bool improved = false;
+        while (true)
+        {
+            while (!_open.empty() && !IsOpenEntryValid(_open.front()))
+            {
+                std::pop_heap(_open.begin(), _open.end(), compare);
+                _open.pop_back();
+            }
+            if (_open.empty() || goalG <= _open.front().key)
+            {
+                improved = true;
+                break;
+            }
+
+            // 예산 / 마감 확인 (멈춰도 OPEN/INCONS가 그대로 남아 있어 다음 Run에서 이어감)
+            if (expansionBudget > 0 && expanded >= expansionBudget) break;
+            if (expanded % CLOCK_CHECK_INTERVAL == 0 && expanded > 0 &&
+                std::chrono::steady_clock::now() >= deadline)
+                break;
+
+            std::pop_heap(_open.begin(), _open.end(), compare);
+            int index = _open.back().index;
+            _open.pop_back();
+
+            _openStamp[index] = 0;
+            _closedStamp[index] = _stamp;
+            ++expanded;
+            ++_expandedCount;
+
+            int x = index % width;
+            int y = index / width;
+            float g = _g[index];
+            unsigned int mask = _map.GetMoveMask(x, y);
+            while (mask != 0)
+            {
+                int i = std::countr_zero(mask);
+                mask &= mask - 1;
+
+                int nextIndex = (y + AStar::dy[i]) * width + (x + AStar::dx[i]);
+                float newG = g + AStar::cost[i];
+
+                if (_visitStamp[nextIndex] < _searchStamp)
+                {
+                    _visitStamp[nextIndex] = _stamp;
+                    _h[nextIndex] = CalculateH(nextIndex);
+                }
+                else if (newG >= _g[nextIndex])
+                {
+                    continue;
+                }
+
+                _g[nextIndex] = newG;
+                _parent[nextIndex] = index;
+                if (nextIndex == _endIndex) goalG = newG;
+
+                // 이번 반복에서 이미 확장한 셀은 다시 열지 않고 다음 반복으로 미룸
+                if (_closedStamp[nextIndex] != _stamp)
+                    PushOpen(nextIndex);
+                else if (_inconsStamp[nextIndex] != _stamp)
+                {
+                    _inconsStamp[nextIndex] = _stamp;
+                    _incons.push_back(nextIndex);
+                }
+            }
+        }
+
+        if (!improved) break; // 시간 / 예산 소진
+
+        // 2. 반복 완료: 경로 갱신 후 가중치를 낮춰 다음 반복
+        FinishIteration();
+        if (_state != AStar::State::SEARCHING) break;
+        BeginIteration();
+
+        if (expansionBudget > 0 && expanded >= expansionBudget) break;
+        if (std::chrono::steady_clock::now() >= deadline) break;
+    }
+
+    return expanded;
+}
+
+void AnytimeAStar::FinishIteration()
+{
+    ++_iterationCount;
+
+    if (_visitStamp[_endIndex] < _searchStamp)
+    {
+        // 가중치와 관계없이 OPEN이 비었다면 도달 불가
+        _state = AStar::State::FAILED;
+        return;
+    }
+
+    // 1. 경로 복원 (다음 반복에서 parent가 바뀌므로 복사해 둠)
+    int width = _map.GetMapWidth();
+    _path.clear();
+    for (int index = _endIndex; index != -1; index = _parent[index])
+        _path.push_back({ index % width, index / width });
+    std::reverse(_path.begin(), _path.end());
+    _pathCost = _g[_endIndex];
+
+    // 2. bound = min(weight, 경로 비용 / OPEN ∪ INCONS의 최소 g + h)
+    //    아직 확장되지 않은 셀들의 g + h가 최적 비용의 하한이 됨
+    float lowerBound = _pathCost;
+    for (const OpenEntry& entry : _open)
+    {
+        if (IsOpenEntryValid(entry))
+            lowerBound = (std::min)(lowerBound, _g[entry.index] + _h[entry.index]);
+    }
+    for (int index : _incons)
+        lowerBound = (std::min)(lowerBound, _g[index] + _h[index]);
+
+    _bound = (lowerBound > 0.0f) ? (std::min)(_weight, _pathCost / lowerBound) : 1.0f;
+
+    if (_weight <= 1.0f || _bound <= 1.0f)
+    {
+        _bound = 1.0f;
+        _state = AStar::State::FINISHED;
+    }
+}
+
+void AnytimeAStar::BeginIteration()
+{
+    _weight = (std::max)(1.0f, _weight - _weightStep);
+
+    // OPEN ∪ INCONS를 새 반복 번호로 옮기고 새 가중치로 키를 다시 계산
+    std::vector<OpenEntry> previous;
+    previous.swap(_open);
+    unsigned int previousStamp = _stamp;
+    NewStamp();
+
+    for (const OpenEntry& entry : previous)
+    {
+        if (_openStamp[entry.index] == previousStamp && entry.g == _g[entry.index])
+            _open.push_back({ GetKey(entry.index), _g[entry.index], entry.index });
+    }
+    for (int index : _incons)
+        _open.push_back({ GetKey(index), _g[index], index });
+    _incons.clear();
+
+    for (const OpenEntry& entry : _open)
+        _openStamp[entry.index] = _stamp;
+    std::make_heap(_open.begin(), _open.end(), [](const OpenEntry& a, const OpenEntry& b) { return a.key > b.key; });
+}
\ No newline at end of file
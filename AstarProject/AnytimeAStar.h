@@ -0,0 +1,84 @@
+﻿#pragma once
+
+// -----------------------------------------------------------
+// AnytimeAStar (ARA*: 가중치를 줄여가며 경로를 개선하는 탐색)
+//
+// SetHeuristicWeight는 정해진 가중치로 한 번만 탐색하므로
+// 시간 예산이 빠듯한 호출자는 "빠르지만 나쁜 경로"와 "느리지만 최적 경로" 중 하나를 골라야 합니다.
+// 이 탐색기는 큰 가중치로 먼저 경로를 하나 찾고, 가중치를 조금씩 낮추면서
+// 이전 반복의 g값/열린 목록을 그대로 이어받아 경로를 개선합니다.
+// - Run은 마감 시각 / 확장 예산이 다 되면 반복 도중이라도 멈추고, 다음 Run에서 이어서 진행
+// - 중간에 멈춰도 GetPath는 마지막으로 완료된 반복의 경로를 돌려줌
+// - GetSuboptimalityBound: 현재 경로 비용 <= bound * 최적 비용 (1이면 최적)
+// -----------------------------------------------------------
+class AnytimeAStar
+{
+public:
+    explicit AnytimeAStar(const AStar& map);
+
+    // 탐색 준비. initialWeight에서 시작해 반복마다 weightStep만큼 낮춤 (최소 1)
+    void Start(Point start, Point end, float initialWeight = 3.0f, float weightStep = 0.5f);
+
+    // deadline 또는 expansionBudget(0 이하면 무제한)까지 진행. 이번 호출에서 확장한 노드 수 반환
+    int Run(std::chrono::steady_clock::time_point deadline, int expansionBudget = 0);
+
+    // SEARCHING: 아직 개선 중 (경로가 있을 수도 있음) / FINISHED: 최적 경로 확정 / FAILED: 경로 없음
+    AStar::State GetState() const { return _state; }
+
+    bool HasPath() const { return !_path.empty(); }
+    const std::vector<Point>& GetPath() const { return _path; }
+    float GetPathCost() const { return _pathCost; }
+
+    float GetWeight() const { return _weight; }                       // 현재 반복의 가중치
+    float GetSuboptimalityBound() const { return _bound; }            // 경로가 없으면 무한대
+    int GetIterationCount() const { return _iterationCount; }         // 완료된 반복 수
+    int GetExpandedCount() const { return _expandedCount; }           // 이번 탐색 누적 확장 수
+
+private:
+    struct OpenEntry
+    {
+        float key; // g + weight * h
+        float g;   // 넣을 당시의 g (현재 _g와 다르면 낡은 항목)
+        int index;
+    };
+
+    float CalculateH(int index) const;
+    float GetKey(int index) const { return _g[index] + _weight * _h[index]; }
+
+    void PushOpen(int index);
+    bool IsOpenEntryValid(const OpenEntry& entry) const;
+    void BeginIteration();   // 가중치를 낮추고 INCONS를 OPEN으로 옮긴 뒤 키 재계산
+    void FinishIteration();  // 경로 확정 + bound 계산
+    void NewStamp();
+
+private:
+    const AStar& _map;
+
+    std::vector<float> _g;
+    std::vector<float> _h;
+    std::vector<int> _parent;
+    std::vector<unsigned int> _visitStamp;  // >= _searchStamp 이면 _g/_h/_parent 유효
+    std::vector<unsigned int> _openStamp;   // == _stamp 이면 OPEN에 있음
+    std::vector<unsigned int> _closedStamp; // == _stamp 이면 이번 반복에서 확장됨
+    std::vector<unsigned int> _inconsStamp; // == _stamp 이면 INCONS에 있음
+    unsigned int _stamp = 0;       // 반복마다 증가
+    unsigned int _searchStamp = 0; // 이번 탐색의 첫 반복 번호
+
+    std::vector<OpenEntry> _open; // 최소 힙
+    std::vector<int> _incons;     // 이번 반복에서 닫힌 뒤 g가 줄어든 셀
+
+    int _startIndex = -1;
+    int _endIndex = -1;
+    Point _end{ -1, -1 };
+
+    float _weight = 1.0f;
+    float _weightStep = 0.5f;
+    float _bound = 0.0f;
+
+    std::vector<Point> _path;
+    float _pathCost = 0.0f;
+    int _iterationCount = 0;
+    int _expandedCount = 0;
+
+    AStar::State _state = AStar::State::READY;
+};
\ No newline at end of file
@@ -9,12 +9,19 @@
 #include <ctime>
 #include <iomanip>
 #include <functional>
+#include <memory>
+#include <atomic>
+#include <thread>
 #include "AStar.h"
+#include "TripleBuffer.h"
+#include "BackgroundSearch.h"
+#include "GridRenderer.h"
 
 // --------------------------------------------------------
 // 전역 변수 및 설정
 // --------------------------------------------------------
 AStar* g_pAStar = nullptr;
+GridRenderer g_renderer;     // 셀 색상 프레임버퍼 (셀 1개 = 1픽셀, 바뀐 셀만 다시 그림)
 int MAP_WIDTH = 20;  // 맵 가로 격자 수
 int MAP_HEIGHT = 20; // 맵 세로 격자 수
 float g_cameraSpeed = 10.0f; // WASD 이동 속도
@@ -35,9 +42,21 @@ POINT g_lastMousePos = { 0, 0 };
 // [추가] 드래그 시 벽을 설치할지(true), 지울지(false) 결정하는 플래그
 bool g_isDrawingWalls = true;
 
+// [추가] 탐색은 뒤 스레드에서. 화면은 발행된 프레임만 읽음
+BackgroundSearch g_search;
+bool g_searchShown = false;   // 한 번이라도 탐색을 시작했으면 그 프레임을 그림 (맵 크기가 바뀌면 해제)
+const int ANIMATION_STEPS_PER_SECOND = 300; // 예전 타이머 애니메이션 속도 (10ms마다 3단계)
+
 // 함수 전방 선언
 void FitMapToScreen(HWND hWnd);
 
+// 현재 맵 / 설정으로 뒤 스레드 탐색을 (다시) 시작
+void RestartSearch()
+{
+    g_searchShown = true;
+    g_search.Start(*g_pAStar, g_startPos, g_endPos);
+}
+
 // --------------------------------------------------------
 // 좌표 변환 헬퍼 함수
 // --------------------------------------------------------
@@ -84,51 +103,74 @@ void Render(HDC hdc, HWND hWnd)
     HFONT hOldFont = (HFONT)SelectObject(memDC, hFont);
     SetBkMode(memDC, TRANSPARENT);
 
-    // 맵 그리기 준비
-    const auto& allNodes = g_pAStar->GetAllNodes();
-    std::vector<Node*> renderMap(MAP_WIDTH * MAP_HEIGHT, nullptr);
-    for (Node* n : allNodes)
+    // [추가] 탐색 중/후에는 뒤 스레드가 발행한 최근 프레임을 그림 (Node*는 읽지 않음)
+    const SearchFrame* frame = g_searchShown ? &g_search.GetFrame() : nullptr;
+    if (frame && (frame->number == 0 || frame->width != MAP_WIDTH || frame->height != MAP_HEIGHT))
+        frame = nullptr;
+
+    // 맵 그리기: 바뀐 셀만 프레임버퍼에 반영한 뒤 화면 크기로 늘려서 복사
+    g_renderer.SetMarkers(g_startPos, g_endPos);
+    if (frame) g_renderer.Update(*frame);
+    else g_renderer.Update(*g_pAStar);
+
+    BITMAPINFO bmi = {};
+    bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bmi.bmiHeader.biWidth = g_renderer.GetPixelWidth();
+    bmi.bmiHeader.biHeight = -g_renderer.GetPixelHeight(); // 음수 = 위에서 아래로
+    bmi.bmiHeader.biPlanes = 1;
+    bmi.bmiHeader.biBitCount = 32;
+    bmi.bmiHeader.biCompression = BI_RGB;
+
+    POINT mapTopLeft = GridToScreen(0, 0);
+    POINT mapBottomRight = GridToScreen(MAP_WIDTH, MAP_HEIGHT);
+    SetStretchBltMode(memDC, COLORONCOLOR);
+    StretchDIBits(memDC,
+        mapTopLeft.x, mapTopLeft.y, mapBottomRight.x - mapTopLeft.x, mapBottomRight.y - mapTopLeft.y,
+        0, 0, g_renderer.GetPixelWidth(), g_renderer.GetPixelHeight(),
+        g_renderer.GetPixels().data(), &bmi, DIB_RGB_COLORS, SRCCOPY);
+
+    // 화면에 보이는 셀 범위 (Culling)
+    int minX = (std::max)(0, (int)((0 - g_offsetX) / g_scale));
+    int minY = (std::max)(0, (int)((0 - g_offsetY) / g_scale));
+    int maxX = (std::min)(MAP_WIDTH - 1, (int)((scrW - g_offsetX) / g_scale));
+    int maxY = (std::min)(MAP_HEIGHT - 1, (int)((scrH - g_offsetY) / g_scale));
+
+    // 격자선 (셀마다 FrameRect 대신 가로/세로 선만 긋기)
+    HPEN hGridPen = CreatePen(PS_SOLID, 1, RGB(0, 0, 0));
+    HPEN hOldGridPen = (HPEN)SelectObject(memDC, hGridPen);
+    for (int x = minX; x <= maxX + 1; ++x)
     {
-        if (n->x >= 0 && n->x < MAP_WIDTH && n->y >= 0 && n->y < MAP_HEIGHT)
-            renderMap[n->y * MAP_WIDTH + n->x] = n;
+        POINT top = GridToScreen(x, minY);
+        POINT bottom = GridToScreen(x, maxY + 1);
+        MoveToEx(memDC, top.x, top.y, nullptr);
+        LineTo(memDC, bottom.x, bottom.y);
     }
+    for (int y = minY; y <= maxY + 1; ++y)
+    {
+        POINT left = GridToScreen(minX, y);
+        POINT right = GridToScreen(maxX + 1, y);
+        MoveToEx(memDC, left.x, left.y, nullptr);
+        LineTo(memDC, right.x, right.y);
+    }
+    SelectObject(memDC, hOldGridPen);
+    DeleteObject(hGridPen);
 
-    for (int y = 0; y < MAP_HEIGHT; ++y)
+    // 줌 레벨이 너무 작으면(너무 멀면) 노드 정보는 생략
+    if (frame && g_scale > 10.0f)
     {
-        for (int x = 0; x < MAP_WIDTH; ++x)
+        for (const SearchFrame::FrameNode& node : frame->nodes)
         {
-            POINT topLeft = GridToScreen(x, y);
-            POINT bottomRight = GridToScreen(x + 1, y + 1);
-            RECT cellRect = { topLeft.x, topLeft.y, bottomRight.x, bottomRight.y };
+            if (node.x < minX || node.x > maxX || node.y < minY || node.y > maxY) continue;
 
-            // Culling
-            if (bottomRight.x < 0 || topLeft.x > scrW || bottomRight.y < 0 || topLeft.y > scrH)
-                continue;
-
-            // 1. 셀 배경색 채우기
-            HBRUSH hBrush = nullptr;
-            Node* node = renderMap[y * MAP_WIDTH + x];
-
-            if (x == g_startPos.x && y == g_startPos.y) hBrush = CreateSolidBrush(RGB(0, 255, 0));
-            else if (x == g_endPos.x && y == g_endPos.y) hBrush = CreateSolidBrush(RGB(255, 0, 0));
-            else if (!g_pAStar->IsWalkable(x, y)) hBrush = CreateSolidBrush(RGB(50, 50, 50));
-            else if (node)
-            {
-                if (node->isClosed) hBrush = CreateSolidBrush(RGB(200, 200, 255));
-                else hBrush = CreateSolidBrush(RGB(200, 255, 200));
-            }
-            else hBrush = CreateSolidBrush(RGB(240, 240, 240));
-
-            FillRect(memDC, &cellRect, hBrush);
-            FrameRect(memDC, &cellRect, (HBRUSH)GetStockObject(BLACK_BRUSH));
-            DeleteObject(hBrush);
+            POINT topLeft = GridToScreen(node.x, node.y);
+            POINT bottomRight = GridToScreen(node.x + 1, node.y + 1);
+            RECT cellRect = { topLeft.x, topLeft.y, bottomRight.x, bottomRight.y };
 
-            // 2. [복구] 부모 노드 방향 표시 (파란 선)
-            // 줌 레벨이 너무 작지 않으면(너무 멀지 않으면) 항상 그리도록 변경
-            if (node && node->parent && g_scale > 10.0f)
+            // 1. [복구] 부모 노드 방향 표시 (파란 선)
+            if (node.parentX >= 0)
             {
                 POINT center = { (topLeft.x + bottomRight.x) / 2, (topLeft.y + bottomRight.y) / 2 };
-                POINT parentCenter = GridToScreen(node->parent->x, node->parent->y);
+                POINT parentCenter = GridToScreen(node.parentX, node.parentY);
                 parentCenter.x = (parentCenter.x + (long)(g_scale / 2));
                 parentCenter.y = (parentCenter.y + (long)(g_scale / 2));
 
@@ -143,24 +185,21 @@ void Render(HDC hdc, HWND hWnd)
                 MoveToEx(memDC, center.x, center.y, nullptr);
                 LineTo(memDC, parentCenter.x, parentCenter.y);
 
-                // 끝에 작은 점 찍어서 방향 명확히 (선택사항)
-                // SetPixel(memDC, parentCenter.x, parentCenter.y, RGB(0,0,255));
-
                 SelectObject(memDC, hOldPen);
                 DeleteObject(hPen);
             }
 
-            // 3. [수정] 텍스트 정보 (float 표시)
+            // 2. [수정] 텍스트 정보 (float 표시)
             // 줌이 충분히 가까울 때만 텍스트 출력
-            if (node && g_scale > 40.0f)
+            if (g_scale > 40.0f)
             {
                 std::wstringstream ss;
                 // [변경] 소수점 1자리 고정
                 ss << std::fixed << std::setprecision(1);
 
-                ss << L"F:" << node->f << L"\n";
-                ss << L"G:" << node->g << L"\n";
-                ss << L"H:" << node->h;
+                ss << L"F:" << node.g + node.h << L"\n";
+                ss << L"G:" << node.g << L"\n";
+                ss << L"H:" << node.h;
 
                 RECT textRect = cellRect;
                 textRect.left += 2; textRect.top += 2;
@@ -173,9 +212,9 @@ void Render(HDC hdc, HWND hWnd)
     }
 
     // 경로 그리기 (골드 색상)
-    const std::vector<Point>& path = g_pAStar->GetPath();
-    if (!path.empty())
+    if (frame && !frame->path.empty())
     {
+        const std::vector<Point>& path = frame->path;
         HPEN hPathPen = CreatePen(PS_SOLID, 4, RGB(255, 215, 0)); // 조금 더 두껍게(4)
         HPEN hOldPen = (HPEN)SelectObject(memDC, hPathPen);
 
@@ -209,6 +248,7 @@ void Render(HDC hdc, HWND hWnd)
     info << L"'E' + Click/Drag: Draw/Erase Wall\n";
     info << L"'X': Smooth Map\n";
     info << L"'R' / 'F': Random Map / Fit Screen\n";
+    info << L"'T': Animation / Full Speed\n";
     info << L"'[' / ']': Map Resize\n";
 
     // [▼▼▼ 여기에 상태 표시 코드 추가 ▼▼▼]
@@ -218,8 +258,10 @@ void Render(HDC hdc, HWND hWnd)
     info << L"[H] Heuristic: ";
     if (g_pAStar->GetHeuristicType() == AStar::HeuristicType::MANHATTAN)
         info << L"Manhattan (Grid)";
-    else
+    else if (g_pAStar->GetHeuristicType() == AStar::HeuristicType::EUCLIDEAN)
         info << L"Euclidean (Direct)";
+    else
+        info << L"Octile (Diagonal)";
     info << L"\n";
 
     // 현재 대각선 이동 허용 여부 표시
@@ -229,14 +271,32 @@ void Render(HDC hdc, HWND hWnd)
     else
         info << L"Blocked";
     info << L"\n";
+
+    // 늪 건너뛰기 상태 (켜져 있으면 이번 탐색에서 건너뛴 이웃 수)
+    info << L"[P] Swamp Skip: ";
+    if (g_search.GetSwampPruning())
+        info << L"On (" << (frame ? frame->swampSkipCount : 0) << L" skipped)";
+    else
+        info << L"Off";
+    info << L"\n";
+
+    // 뒤 스레드 탐색 속도 / 받은 프레임
+    info << L"[T] Speed: ";
+    if (g_search.GetStepsPerSecond() == 0)
+        info << L"Max";
+    else
+        info << g_search.GetStepsPerSecond() << L" steps/s";
+    if (frame)
+        info << L" (frame " << frame->number << L", " << frame->expandCount << L" expanded)";
+    info << L"\n";
     // [▲▲▲ 여기까지 추가 ▲▲▲]
 
-    RECT infoBgRect = { 10, 10, 360, 240 };
+    RECT infoBgRect = { 10, 10, 400, 300 };
     HBRUSH hSemiTransBrush = CreateSolidBrush(RGB(240, 240, 240));
     FillRect(memDC, &infoBgRect, hSemiTransBrush);
     DeleteObject(hSemiTransBrush);
 
-    RECT infoRect = { 15, 15, 400, 300 };
+    RECT infoRect = { 15, 15, 440, 340 };
     SetTextColor(memDC, RGB(0, 0, 0));
     DrawText(memDC, info.str().c_str(), -1, &infoRect, DT_LEFT);
 
@@ -258,6 +318,9 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
     case WM_CREATE:
         g_pAStar = new AStar(MAP_WIDTH, MAP_HEIGHT);
         g_pAStar->Initialize(MAP_WIDTH, MAP_HEIGHT);
+        g_pAStar->SetSearchTreeReuse(true); // Shift+클릭으로 목적지만 옮길 때 이전 탐색 이어서 사용
+        g_pAStar->SetDirtyTrackingEnabled(true); // 탐색 전 편집 화면은 바뀐 셀만 다시 그림
+        g_search.SetStepsPerSecond(ANIMATION_STEPS_PER_SECOND);
         SetTimer(hWnd, 1, 10, nullptr);
         break;
 
@@ -274,20 +337,14 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
             if (moved) InvalidateRect(hWnd, nullptr, FALSE);
         }
 
-        // 길찾기 애니메이션
-        if (g_pAStar->GetState() == AStar::State::SEARCHING)
-        {
-            for (int i = 0; i < 3; ++i)
-            {
-                g_pAStar->UpdatePathFinding();
-                if (g_pAStar->GetState() != AStar::State::SEARCHING) break;
-            }
+        // 길찾기 애니메이션: 탐색은 뒤 스레드에서 돌고, 새 프레임이 왔을 때만 다시 그림
+        if (g_searchShown && g_search.AcquireFrame())
             InvalidateRect(hWnd, nullptr, FALSE);
-        }
     }
     break;
 
     case WM_DESTROY:
+        g_search.Cancel();
         delete g_pAStar;
         PostQuitMessage(0);
         break;
@@ -316,11 +373,12 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
             {
                 g_startPos = p;
                 g_pAStar->SetObstacle(p.x, p.y, false);
+                if (g_searchShown) RestartSearch();
             }
             else if (GetKeyState(VK_SHIFT) & 0x8000)
             {
                 g_endPos = p;
-                g_pAStar->StartPathFinding(g_startPos, g_endPos);
+                RestartSearch();
             }
             // [수정] 'E' 키를 누르고 클릭하면 드래그 모드 결정
             else if (GetKeyState('E') & 0x8000) // A -> E로 변경
@@ -330,6 +388,7 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
                 g_isDrawingWalls = g_pAStar->IsWalkable(p.x, p.y);
 
                 g_pAStar->SetObstacle(p.x, p.y, g_isDrawingWalls);
+                if (g_searchShown) RestartSearch(); // 바뀐 맵으로 다시 탐색
             }
         }
         InvalidateRect(hWnd, nullptr, FALSE);
@@ -377,7 +436,9 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
                 if (GetKeyState('E') & 0x8000)
                 {
                     // 클릭했을 때 결정된 모드(설치/제거)를 계속 적용
+                    unsigned int version = g_pAStar->GetMapVersion();
                     g_pAStar->SetObstacle(p.x, p.y, g_isDrawingWalls);
+                    if (g_searchShown && g_pAStar->GetMapVersion() != version) RestartSearch();
                     InvalidateRect(hWnd, nullptr, FALSE);
                 }
             }
@@ -397,19 +458,31 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         if (wParam == 'F') FitMapToScreen(hWnd);
         else if (wParam == 'H')
         {
+            // Manhattan -> Euclidean -> Octile 순서로 순환
             auto current = g_pAStar->GetHeuristicType();
-            g_pAStar->SetHeuristicType(current == AStar::HeuristicType::MANHATTAN ? AStar::HeuristicType::EUCLIDEAN : AStar::HeuristicType::MANHATTAN);
+            if (current == AStar::HeuristicType::MANHATTAN) g_pAStar->SetHeuristicType(AStar::HeuristicType::EUCLIDEAN);
+            else if (current == AStar::HeuristicType::EUCLIDEAN) g_pAStar->SetHeuristicType(AStar::HeuristicType::OCTILE);
+            else g_pAStar->SetHeuristicType(AStar::HeuristicType::MANHATTAN);
         }
         else if (wParam == 'G') g_pAStar->SetAllowDiagonal(!g_pAStar->GetAllowDiagonal());
+        // 늪 전처리는 다음 탐색 시작 때 뒤 스레드에서
+        else if (wParam == 'P') g_search.SetSwampPruning(!g_search.GetSwampPruning());
         else if (wParam == 'R') g_pAStar->GenerateRandomMap(47);
         // [수정] Smooth Map 키 변경: S -> X
         else if (wParam == 'X') g_pAStar->SmoothMap();
+        // 애니메이션 속도 <-> 최대 속도 (진행 중인 탐색에도 바로 적용)
+        else if (wParam == 'T')
+            g_search.SetStepsPerSecond(g_search.GetStepsPerSecond() == 0 ? ANIMATION_STEPS_PER_SECOND : 0);
+
         else if (wParam == VK_OEM_4) // '['
         {
             if (MAP_WIDTH > 10)
             {
                 MAP_WIDTH -= 10; MAP_HEIGHT -= 10;
                 delete g_pAStar; g_pAStar = new AStar(MAP_WIDTH, MAP_HEIGHT);
+                g_pAStar->SetSearchTreeReuse(true);
+                g_pAStar->SetDirtyTrackingEnabled(true);
+                g_search.Cancel(); g_searchShown = false; // 이전 크기의 프레임은 그리지 않음
                 g_startPos = { 0, 0 }; g_endPos = { MAP_WIDTH - 1, MAP_HEIGHT - 1 };
                 g_pAStar->GenerateRandomMap(47);
             }
@@ -420,10 +493,17 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
             {
                 MAP_WIDTH += 10; MAP_HEIGHT += 10;
                 delete g_pAStar; g_pAStar = new AStar(MAP_WIDTH, MAP_HEIGHT);
+                g_pAStar->SetSearchTreeReuse(true);
+                g_pAStar->SetDirtyTrackingEnabled(true);
+                g_search.Cancel(); g_searchShown = false; // 이전 크기의 프레임은 그리지 않음
                 g_startPos = { 0, 0 }; g_endPos = { MAP_WIDTH - 1, MAP_HEIGHT - 1 };
                 FitMapToScreen(hWnd);
             }
         }
+
+        // 맵 / 탐색 설정이 바뀌었으면 보고 있던 탐색을 다시 시작
+        if (g_searchShown && (wParam == 'H' || wParam == 'G' || wParam == 'P' || wParam == 'R' || wParam == 'X'))
+            RestartSearch();
         InvalidateRect(hWnd, nullptr, FALSE);
     }
     break;
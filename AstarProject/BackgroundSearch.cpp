@@ -0,0 +1,170 @@
+﻿#include "MemoryPool.h"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include "AStar.h"
+#include "SwampMap.h"
+#include "TripleBuffer.h"
+#include "BackgroundSearch.h"
+
+BackgroundSearch::BackgroundSearch()
+    : _search(std::make_unique<AStar>(1, 1))
+    , _swamps(std::make_unique<SwampMap>())
+{
+}
+
+BackgroundSearch::~BackgroundSearch()
+{
+    Cancel();
+}
+
+void BackgroundSearch::Cancel()
+{
+    _cancel.store(true);
+    if (_thread.joinable()) _thread.join();
+    _cancel.store(false);
+}
+
+void BackgroundSearch::Start(const AStar& map, Point start, Point end)
+{
+    // 1. 이전 탐색을 끝내야 _search를 건드릴 수 있음
+    Cancel();
+
+    // 2. 벽 복사 (행마다 64칸씩 비트로 모아서 ReplaceObstacles 한 번)
+    //    맵이 그대로면 복사하지 않음 -> 목적지만 옮길 때 이전 탐색 트리를 이어 쓸 수 있음
+    int width = map.GetMapWidth();
+    int height = map.GetMapHeight();
+    bool sameMap = (&map == _sourceMap && map.GetMapVersion() == _sourceVersion &&
+        _search->GetMapWidth() == width && _search->GetMapHeight() == height);
+    if (!sameMap)
+    {
+        if (_search->GetMapWidth() != width || _search->GetMapHeight() != height)
+            _search->Initialize(width, height);
+
+        int wordsPerRow = (width + 63) / 64;
+        _wallMask.assign((size_t)wordsPerRow * height, 0);
+        for (int y = 0; y < height; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                if (!map.IsWalkable(x, y))
+                    _wallMask[(size_t)y * wordsPerRow + (x >> 6)] |= 1ull << (x & 63);
+            }
+        }
+        _search->ReplaceObstacles(_wallMask); // [수정] 지우기 + 칠하기를 변경 기록 한 건으로
+
+        _sourceMap = &map;
+        _sourceVersion = map.GetMapVersion();
+    }
+
+    // 3. 탐색 설정 복사
+    _search->SetHeuristicType(map.GetHeuristicType());
+    _search->SetHeuristicWeight(map.GetHeuristicWeight());
+    _search->SetAllowDiagonal(map.GetAllowDiagonal());
+    _search->SetSimdLevel(map.GetSimdLevel());
+    _search->SetSearchTreeReuse(map.GetSearchTreeReuse());
+
+    // 4. 뒤 스레드 시작
+    unsigned int searchId = ++_searchId;
+    _running.store(true, std::memory_order_release);
+    bool swampPruning = _swampPruning; // 탐색 도중 설정이 바뀌어도 이번 탐색은 그대로
+    _thread = std::thread([this, searchId, start, end, swampPruning]() { Run(searchId, start, end, swampPruning); });
+}
+
+void BackgroundSearch::Run(unsigned int searchId, Point start, Point end, bool swampPruning)
+{
+    using Clock = std::chrono::steady_clock;
+    AStar& search = *_search;
+
+    // 늪 전처리도 이 스레드에서 (UI는 기다리지 않음)
+    // 켜져 있는 동안의 맵 변경은 StartPathFinding의 SyncFrom이 반영하므로 켜고 끌 때만 연결을 바꿈
+    // (매번 다시 연결하면 탐색 트리 재사용이 끊김)
+    if (swampPruning != _swampAttached)
+    {
+        if (swampPruning) _swamps->Build(search);
+        search.SetSwampMap(swampPruning ? _swamps.get() : nullptr);
+        _swampAttached = swampPruning;
+    }
+
+    search.StartPathFinding(start, end);
+
+    long long steps = 0;
+    Clock::time_point begin = Clock::now();
+    Clock::time_point lastPublish = begin;
+    Publish(searchId, start, end, steps);
+
+    while (search.GetState() == AStar::State::SEARCHING && !_cancel.load(std::memory_order_relaxed))
+    {
+        search.UpdatePathFinding();
+        ++steps;
+
+        // 최대 속도일 때는 시계를 자주 읽지 않음
+        int stepsPerSecond = _stepsPerSecond.load(std::memory_order_relaxed);
+        if (stepsPerSecond == 0 && (steps & 255) != 0) continue;
+
+        Clock::time_point now = Clock::now();
+        if (now - lastPublish >= std::chrono::milliseconds(_publishIntervalMs.load(std::memory_order_relaxed)))
+        {
+            Publish(searchId, start, end, steps);
+            lastPublish = now;
+        }
+
+        // 애니메이션: 이번 단계가 끝나야 할 시각까지 쉼 (속도를 바꾸면 그 시점부터 다시 계산)
+        if (stepsPerSecond > 0)
+        {
+            Clock::time_point due = begin + std::chrono::microseconds(steps * 1000000 / stepsPerSecond);
+            if (due > now)
+            {
+                std::this_thread::sleep_until(due);
+            }
+            else if (now - due > std::chrono::milliseconds(100))
+            {
+                begin = now - std::chrono::microseconds(steps * 1000000 / stepsPerSecond);
+            }
+        }
+    }
+
+    Publish(searchId, start, end, steps);
+    _running.store(false, std::memory_order_release);
+}
+
+void BackgroundSearch::Publish(unsigned int searchId, Point start, Point end, long long stepCount)
+{
+    const AStar& search = *_search;
+    SearchFrame& frame = _frames.GetWriteBuffer();
+
+    frame.number = ++_frameNumber;
+    frame.searchId = searchId;
+    frame.width = search.GetMapWidth();
+    frame.height = search.GetMapHeight();
+    frame.start = start;
+    frame.end = end;
+    frame.state = search.GetState();
+    frame.stepCount = stepCount;
+    frame.expandCount = search.GetExpandCount();
+    frame.swampSkipCount = search.GetSwampSkipCount();
+
+    // 슬롯은 재사용되므로 매번 전부 다시 채움 (capacity는 남아 있음)
+    frame.cellTypes.resize((size_t)frame.width * frame.height);
+    for (int y = 0; y < frame.height; ++y)
+        for (int x = 0; x < frame.width; ++x)
+            frame.cellTypes[(size_t)y * frame.width + x] = (unsigned char)search.GetCellType(x, y);
+
+    frame.nodes.clear();
+    for (const Node* node : search.GetAllNodes())
+    {
+        int parentX = node->parent ? node->parent->x : -1;
+        int parentY = node->parent ? node->parent->y : -1;
+        frame.nodes.push_back({ node->x, node->y, parentX, parentY, node->g, node->h });
+    }
+
+    frame.path = search.GetPath();
+
+    _frames.Publish();
+    _publishedCount.fetch_add(1, std::memory_order_relaxed);
+}
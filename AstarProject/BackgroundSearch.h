@@ -0,0 +1,106 @@
+﻿#pragma once
+
+// -----------------------------------------------------------
+// SearchFrame (탐색 한 순간의 불변 스냅샷)
+//
+// BackgroundSearch가 뒤 스레드에서 채워 TripleBuffer로 넘깁니다.
+// 받은 쪽은 다음 Acquire 전까지 마음대로 읽어도 되고, Node*는 들어 있지 않습니다.
+// -----------------------------------------------------------
+struct SearchFrame
+{
+    // 만들어진 노드 하나 (부모 방향 / F G H 표시용)
+    struct FrameNode
+    {
+        int x;
+        int y;
+        int parentX; // 부모 없으면 -1
+        int parentY;
+        float g;
+        float h;
+    };
+
+    unsigned long long number = 0; // 발행 순서 (0이면 아직 아무것도 없음)
+    unsigned int searchId = 0;     // BackgroundSearch::Start마다 증가
+
+    int width = 0;
+    int height = 0;
+    Point start{ -1, -1 };
+    Point end{ -1, -1 };
+
+    AStar::State state = AStar::State::READY;
+    long long stepCount = 0;  // UpdatePathFinding 호출 수
+    int expandCount = 0;
+    int swampSkipCount = 0;
+
+    std::vector<unsigned char> cellTypes; // AStar::NodeType (벽 / 열림 / 닫힘 / 경로)
+    std::vector<FrameNode> nodes;
+    std::vector<Point> path;
+
+    AStar::NodeType GetCellType(int x, int y) const { return (AStar::NodeType)cellTypes[(size_t)y * width + x]; }
+};
+
+// -----------------------------------------------------------
+// BackgroundSearch (뒤 스레드 탐색 + 락 없는 스냅샷)
+//
+// 시각화 창은 WM_TIMER에서 UpdatePathFinding을 부르고 Render에서 Node*를 바로 읽었기 때문에
+// 확장 수를 늘리면 창이 멈추고, 탐색을 다른 스레드로 옮기면 읽기가 안전하지 않았습니다.
+// - Start: 맵의 벽과 탐색 설정을 전용 AStar에 복사하고 뒤 스레드에서 탐색 (진행 중인 탐색은 취소)
+// - 뒤 스레드는 일정 간격(기본 16ms)과 끝났을 때 SearchFrame을 채워 TripleBuffer로 발행
+//   발행은 원자 교환 한 번이라 읽는 쪽이 느려도 탐색은 기다리지 않음
+// - 읽는 쪽(UI / 헤드리스 감시 도구)은 AcquireFrame / GetFrame으로 가장 최근 프레임만 봄
+//
+// 읽는 쪽은 스레드 하나여야 합니다. (Start / Cancel도 같은 스레드에서)
+// -----------------------------------------------------------
+class BackgroundSearch
+{
+public:
+    BackgroundSearch();
+    ~BackgroundSearch();
+
+    // map의 벽 / 휴리스틱 / 가중치 / 대각선 / SIMD / 트리 재사용 설정을 복사해서 탐색 시작
+    // (같은 map이 그 뒤로 바뀌지 않았으면 벽은 다시 복사하지 않음)
+    void Start(const AStar& map, Point start, Point end);
+    // 진행 중인 탐색을 멈추고 스레드가 끝날 때까지 기다림 (마지막 프레임은 남음)
+    void Cancel();
+    bool IsRunning() const { return _running.load(std::memory_order_acquire); }
+
+    // 초당 확장 단계 수 (0이면 제한 없이 최대 속도). 애니메이션용
+    void SetStepsPerSecond(int steps) { _stepsPerSecond.store(steps < 0 ? 0 : steps); }
+    int GetStepsPerSecond() const { return _stepsPerSecond.load(); }
+    // 프레임 발행 간격
+    void SetPublishInterval(int milliseconds) { _publishIntervalMs.store(milliseconds < 1 ? 1 : milliseconds); }
+    // 뒤 스레드 탐색에 늪 건너뛰기 사용 (다음 Start부터, 전처리도 뒤 스레드에서)
+    void SetSwampPruning(bool enable) { _swampPruning = enable; }
+    bool GetSwampPruning() const { return _swampPruning; }
+
+    // 새 프레임이 있으면 받아오고 true. GetFrame은 다음 AcquireFrame 전까지 유효
+    bool AcquireFrame() { return _frames.Acquire(); }
+    const SearchFrame& GetFrame() const { return _frames.GetReadBuffer(); }
+
+    unsigned long long GetPublishedCount() const { return _publishedCount.load(std::memory_order_relaxed); }
+
+private:
+    void Run(unsigned int searchId, Point start, Point end, bool swampPruning);
+    void Publish(unsigned int searchId, Point start, Point end, long long stepCount);
+
+private:
+    std::unique_ptr<AStar> _search;    // 뒤 스레드 전용 (Start에서 스레드가 없을 때만 건드림)
+    std::unique_ptr<SwampMap> _swamps;
+    bool _swampPruning = false;
+    bool _swampAttached = false;       // _search에 _swamps가 연결되어 있는지 (뒤 스레드만 씀)
+
+    std::thread _thread;
+    std::atomic<bool> _cancel{ false };
+    std::atomic<bool> _running{ false };
+    std::atomic<int> _stepsPerSecond{ 0 };
+    std::atomic<int> _publishIntervalMs{ 16 };
+    unsigned int _searchId = 0;
+
+    TripleBuffer<SearchFrame> _frames;
+    std::atomic<unsigned long long> _publishedCount{ 0 };
+    unsigned long long _frameNumber = 0; // 뒤 스레드만 씀
+
+    std::vector<unsigned long long> _wallMask; // Start에서 벽 복사용 (재사용)
+    const AStar* _sourceMap = nullptr;         // 마지막으로 벽을 복사한 맵과 그때의 버전
+    unsigned int _sourceVersion = 0;
+};
@@ -0,0 +1,313 @@
+﻿#include "MemoryPool.h"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <unordered_map>
+#include <bit>
+#include "AStar.h"
+#include "ChunkedWorld.h"
+
+namespace
+{
+    // 좌표 -> 의사 난수 (같은 시드/좌표면 항상 같은 값)
+    unsigned int HashCell(unsigned int seed, int x, int y)
+    {
+        unsigned int h = seed ^ ((unsigned int)x * 0x27D4EB2Du) ^ ((unsigned int)y * 0x165667B1u);
+        h ^= h >> 15;
+        h *= 0x85EBCA6Bu;
+        h ^= h >> 13;
+        h *= 0xC2B2AE35u;
+        h ^= h >> 16;
+        return h;
+    }
+}
+
+// -----------------------------------------------------------
+// NoiseTileStore
+// -----------------------------------------------------------
+void NoiseTileStore::LoadTile(int tileX, int tileY, unsigned char* walls)
+{
+    for (int ly = 0; ly < TILE_SIZE; ++ly)
+    {
+        for (int lx = 0; lx < TILE_SIZE; ++lx)
+        {
+            int x = tileX * TILE_SIZE + lx;
+            int y = tileY * TILE_SIZE + ly;
+            walls[ly * TILE_SIZE + lx] = (int)(HashCell(_seed, x, y) % 100) < _fillPercent ? 1 : 0;
+        }
+    }
+}
+
+// -----------------------------------------------------------
+// ChunkedWorld
+// -----------------------------------------------------------
+ChunkedWorld::ChunkedWorld(ITileStore& store, int tilesX, int tilesY, size_t maxLoadedTiles)
+    : _store(store)
+    , _tilesX(tilesX)
+    , _tilesY(tilesY)
+    , _maxLoadedTiles(maxLoadedTiles < 16 ? 16 : maxLoadedTiles)
+{
+}
+
+ChunkedWorld::~ChunkedWorld()
+{
+    Flush();
+    for (auto& [key, tile] : _tiles)
+        _tilePool.Free(tile);
+}
+
+ChunkedWorld::Tile& ChunkedWorld::GetTile(int tileX, int tileY)
+{
+    long long key = TileKey(tileX, tileY);
+    if (key == _cachedKey) return *_cachedTile;
+
+    auto it = _tiles.find(key);
+    Tile* tile;
+    if (it != _tiles.end())
+    {
+        tile = it->second;
+    }
+    else
+    {
+        // 처음 접근 -> 저장소에서 로드 (한도를 넘으면 먼저 정리)
+        if (_tiles.size() >= _maxLoadedTiles)
+            EvictOldTiles();
+
+        tile = _tilePool.Alloc();
+        _store.LoadTile(tileX, tileY, tile->walls);
+        tile->dirty = false;
+        tile->pinned = false;
+        _tiles.emplace(key, tile);
+        ++_loadCount;
+    }
+
+    // 사용 시각은 타일이 바뀔 때만 갱신 (대략적인 LRU)
+    tile->lastUse = ++_useClock;
+    _cachedKey = key;
+    _cachedTile = tile;
+    return *tile;
+}
+
+bool ChunkedWorld::SaveForUnload(long long key, Tile& tile)
+{
+    if (tile.pinned) return false;
+    if (!tile.dirty || _store.SaveTile((int)(unsigned int)(key & 0xFFFFFFFF), (int)(key >> 32), tile.walls)) return true;
+
+    tile.pinned = true;
+    ++_pinnedCount;
+    return false;
+}
+
+void ChunkedWorld::EvictOldTiles()
+{
+    // 오래된 순으로 1/4을 한 번에 내림 (매번 하나씩 찾는 비용을 줄임). 고정된 타일은 후보에서 뺌
+    std::vector<std::pair<unsigned long long, long long>> ages;
+    ages.reserve(_tiles.size());
+    for (auto& [key, tile] : _tiles)
+    {
+        if (!tile->pinned) ages.push_back({ tile->lastUse, key });
+    }
+    if (ages.empty()) return; // 전부 저장하지 못한 수정 타일 -> 한도를 넘더라도 유지
+
+    size_t evictCount = std::max<size_t>(1, ages.size() / 4);
+    std::nth_element(ages.begin(), ages.begin() + (evictCount - 1), ages.end());
+
+    for (size_t i = 0; i < evictCount; ++i)
+    {
+        long long key = ages[i].second;
+        Tile* tile = _tiles[key];
+        if (!SaveForUnload(key, *tile)) continue;
+        _tilePool.Free(tile);
+        _tiles.erase(key);
+    }
+
+    _cachedKey = -1;
+    _cachedTile = nullptr;
+}
+
+void ChunkedWorld::Flush()
+{
+    for (auto it = _tiles.begin(); it != _tiles.end();)
+    {
+        if (!SaveForUnload(it->first, *it->second))
+        {
+            ++it;
+            continue;
+        }
+        _tilePool.Free(it->second);
+        it = _tiles.erase(it);
+    }
+    _cachedKey = -1;
+    _cachedTile = nullptr;
+}
+
+bool ChunkedWorld::IsWalkable(int x, int y)
+{
+    if (x < 0 || x >= GetWidth() || y < 0 || y >= GetHeight()) return false;
+    Tile& tile = GetTile(x >> TILE_SHIFT, y >> TILE_SHIFT);
+    return tile.walls[((y & (TILE_SIZE - 1)) << TILE_SHIFT) | (x & (TILE_SIZE - 1))] == 0;
+}
+
+void ChunkedWorld::SetObstacle(int x, int y, bool isWall)
+{
+    if (x < 0 || x >= GetWidth() || y < 0 || y >= GetHeight()) return;
+    Tile& tile = GetTile(x >> TILE_SHIFT, y >> TILE_SHIFT);
+    tile.walls[((y & (TILE_SIZE - 1)) << TILE_SHIFT) | (x & (TILE_SIZE - 1))] = isWall ? 1 : 0;
+    tile.dirty = true;
+}
+
+unsigned char ChunkedWorld::GetMoveMask(int x, int y, bool allowDiagonal)
+{
+    if (!IsWalkable(x, y)) return 0;
+
+    // 직선 4방향 먼저 (대각선 코너 규칙에 재사용)
+    unsigned char mask = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        if (IsWalkable(x + AStar::dx[i], y + AStar::dy[i]))
+            mask |= (unsigned char)(1 << i);
+    }
+    if (!allowDiagonal) return mask;
+
+    for (int i = 4; i < 8; ++i)
+    {
+        int nextX = x + AStar::dx[i];
+        int nextY = y + AStar::dy[i];
+        if (!IsWalkable(nextX, nextY)) continue;
+
+        // 대각선은 양쪽 직선 방향이 모두 벽일 때만 막음
+        if (!IsWalkable(x, nextY) && !IsWalkable(nextX, y)) continue;
+        mask |= (unsigned char)(1 << i);
+    }
+    return mask;
+}
+
+// -----------------------------------------------------------
+// ChunkedAStar
+// -----------------------------------------------------------
+ChunkedAStar::ChunkedAStar()
+{
+}
+
+ChunkedAStar::~ChunkedAStar()
+{
+    ReleaseStateTiles();
+}
+
+ChunkedAStar::StateTile& ChunkedAStar::GetStateTile(int x, int y)
+{
+    long long key = ((long long)(y >> ITileStore::TILE_SHIFT) << 32) | (unsigned int)(x >> ITileStore::TILE_SHIFT);
+    if (key == _cachedKey) return *_cachedTile;
+
+    StateTile*& slot = _stateTiles[key];
+    if (slot == nullptr)
+    {
+        // 처음 건드린 타일 -> 상태 할당 (미방문으로 초기화)
+        slot = _statePool.Alloc();
+        std::memset(slot->state, 0, sizeof(slot->state));
+    }
+
+    _cachedKey = key;
+    _cachedTile = slot;
+    return *slot;
+}
+
+void ChunkedAStar::ReleaseStateTiles()
+{
+    for (auto& [key, tile] : _stateTiles)
+        _statePool.Free(tile);
+    _stateTiles.clear();
+    _cachedKey = -1;
+    _cachedTile = nullptr;
+}
+
+float ChunkedAStar::CalculateH(int x, int y, Point end) const
+{
+    return AStar::HeuristicDistance(_heuristicType, { x, y }, end);
+}
+
+bool ChunkedAStar::FindPath(ChunkedWorld& world, Point start, Point end, std::vector<Point>& outPath, size_t maxExpansions)
+{
+    // 이전 탐색 상태 반납 (풀에 남아 다음 탐색이 재사용)
+    ReleaseStateTiles();
+    outPath.clear();
+    _openList.clear();
+    _expandedCount = 0;
+
+    if (!world.IsWalkable(start.x, start.y) || !world.IsWalkable(end.x, end.y)) return false;
+
+    const int LOCAL_MASK = ITileStore::TILE_SIZE - 1;
+    auto localIndex = [LOCAL_MASK](int x, int y) { return ((y & LOCAL_MASK) << ITileStore::TILE_SHIFT) | (x & LOCAL_MASK); };
+
+    StateTile& startTile = GetStateTile(start.x, start.y);
+    startTile.g[localIndex(start.x, start.y)] = 0.0f;
+    startTile.parentDir[localIndex(start.x, start.y)] = -1;
+    startTile.state[localIndex(start.x, start.y)] = 1;
+
+    float startH = CalculateH(start.x, start.y, end);
+    _openList.push_back({ startH, startH, start.x, start.y });
+
+    while (!_openList.empty())
+    {
+        std::pop_heap(_openList.begin(), _openList.end(), OpenEntryCompare());
+        OpenEntry current = _openList.back();
+        _openList.pop_back();
+
+        StateTile& tile = GetStateTile(current.x, current.y);
+        int local = localIndex(current.x, current.y);
+        if (tile.state[local] == 2) continue; // Lazy Deletion
+        tile.state[local] = 2;
+        float currentG = tile.g[local];
+        ++_expandedCount;
+
+        if (current.x == end.x && current.y == end.y)
+        {
+            // 부모 방향을 거슬러 올라가며 길이를 먼저 센 뒤 뒤에서부터 채움
+            size_t length = 1;
+            Point p = end;
+            for (int dir; (dir = GetStateTile(p.x, p.y).parentDir[localIndex(p.x, p.y)]) != -1; ++length)
+                p = { p.x - AStar::dx[dir], p.y - AStar::dy[dir] };
+
+            outPath.resize(length);
+            p = end;
+            for (;;)
+            {
+                outPath[--length] = p;
+                int dir = GetStateTile(p.x, p.y).parentDir[localIndex(p.x, p.y)];
+                if (dir == -1) break;
+                p = { p.x - AStar::dx[dir], p.y - AStar::dy[dir] };
+            }
+            return true;
+        }
+
+        if (maxExpansions != 0 && _expandedCount >= maxExpansions) break;
+
+        unsigned int mask = world.GetMoveMask(current.x, current.y, _allowDiagonal);
+        while (mask != 0)
+        {
+            int i = std::countr_zero(mask);
+            mask &= mask - 1;
+
+            int nextX = current.x + AStar::dx[i];
+            int nextY = current.y + AStar::dy[i];
+            StateTile& nextTile = GetStateTile(nextX, nextY);
+            int nextLocal = localIndex(nextX, nextY);
+            if (nextTile.state[nextLocal] == 2) continue;
+
+            float newG = currentG + AStar::cost[i];
+            if (nextTile.state[nextLocal] == 0 || newG < nextTile.g[nextLocal])
+            {
+                nextTile.state[nextLocal] = 1;
+                nextTile.g[nextLocal] = newG;
+                nextTile.parentDir[nextLocal] = (signed char)i;
+
+                float h = CalculateH(nextX, nextY, end);
+                _openList.push_back({ newG + h, h, nextX, nextY });
+                std::push_heap(_openList.begin(), _openList.end(), OpenEntryCompare());
+            }
+        }
+    }
+    return false;
+}
@@ -0,0 +1,157 @@
+﻿#pragma once
+
+// -----------------------------------------------------------
+// ChunkedWorld (희소 청크 맵 + 지연 타일 로딩)
+//
+// AStar는 W*H 크기의 _mapGrid / _nodeMap을 통째로 잡기 때문에
+// 메모리보다 큰 월드는 다룰 수 없습니다.
+// ChunkedWorld는 맵을 64x64 타일로 나누고, 처음 접근할 때 ITileStore에서 읽어옵니다.
+// 올라온 타일 수가 한도를 넘으면 오래 안 쓴 타일부터 내립니다 (수정된 타일은 저장).
+// 저장소가 저장하지 못하는 수정 타일은 내리지 않고 고정합니다 (내리면 편집이 사라지고 원본이 다시 올라오므로).
+// 그래서 그런 저장소에서는 편집한 타일 수만큼 한도를 넘을 수 있습니다.
+//
+// ChunkedAStar는 탐색 상태(g, 부모 방향, open/closed)도 "건드린 타일"에만
+// 할당하므로, 메모리는 탐색한 영역에 비례합니다.
+// -----------------------------------------------------------
+
+// 타일 원본 저장소 (파일, DB, 절차 생성 등)
+class ITileStore
+{
+public:
+    static constexpr int TILE_SHIFT = 6;
+    static constexpr int TILE_SIZE = 1 << TILE_SHIFT; // 64
+    static constexpr int TILE_CELLS = TILE_SIZE * TILE_SIZE;
+
+    virtual ~ITileStore() = default;
+
+    // walls[ly * TILE_SIZE + lx] = 1(벽) / 0(이동 가능)으로 채움
+    virtual void LoadTile(int tileX, int tileY, unsigned char* walls) = 0;
+
+    // 수정된 타일을 내릴 때 호출. 저장했으면 true
+    // 기본은 저장하지 못함(false): 그 타일은 ChunkedWorld가 내리지 않고 계속 올려둠
+    virtual bool SaveTile(int /*tileX*/, int /*tileY*/, const unsigned char* /*walls*/) { return false; }
+};
+
+// 시드 기반 해시 노이즈로 타일을 만들어내는 저장소 (무한에 가까운 테스트 월드용)
+class NoiseTileStore : public ITileStore
+{
+public:
+    NoiseTileStore(unsigned int seed, int fillPercent) : _seed(seed), _fillPercent(fillPercent) {}
+    void LoadTile(int tileX, int tileY, unsigned char* walls) override;
+
+private:
+    unsigned int _seed;
+    int _fillPercent;
+};
+
+class ChunkedWorld
+{
+public:
+    static constexpr int TILE_SHIFT = ITileStore::TILE_SHIFT;
+    static constexpr int TILE_SIZE = ITileStore::TILE_SIZE;
+
+public:
+    // 월드 크기는 타일 단위. maxLoadedTiles를 넘으면 오래된 타일부터 내림
+    ChunkedWorld(ITileStore& store, int tilesX, int tilesY, size_t maxLoadedTiles = 4096);
+    ~ChunkedWorld();
+
+    int GetWidth() const { return _tilesX * TILE_SIZE; }
+    int GetHeight() const { return _tilesY * TILE_SIZE; }
+
+    bool IsWalkable(int x, int y);
+    void SetObstacle(int x, int y, bool isWall);
+
+    // AStar::GetMoveMask와 같은 규칙의 8방향 마스크 (필요하면 이웃 타일도 로드)
+    unsigned char GetMoveMask(int x, int y, bool allowDiagonal);
+
+    size_t GetLoadedTileCount() const { return _tiles.size(); }
+    size_t GetLoadCount() const { return _loadCount; } // 누적 로드 횟수
+    size_t GetPinnedTileCount() const { return _pinnedCount; } // 저장하지 못해 고정된 수정 타일 수
+
+    // 수정된 타일을 모두 저장하고 내림 (저장하지 못한 수정 타일은 고정된 채 남음)
+    void Flush();
+
+private:
+    struct Tile
+    {
+        unsigned char walls[ITileStore::TILE_CELLS];
+        unsigned long long lastUse;
+        bool dirty;
+        bool pinned; // 저장소가 저장하지 못한 수정 타일 (내리지 않음)
+    };
+
+    static long long TileKey(int tileX, int tileY) { return ((long long)tileY << 32) | (unsigned int)tileX; }
+
+    Tile& GetTile(int tileX, int tileY);
+    void EvictOldTiles();
+    // 수정됐으면 저장하고 내릴 수 있는지 (저장하지 못하면 고정하고 false)
+    bool SaveForUnload(long long key, Tile& tile);
+
+private:
+    ITileStore& _store;
+    int _tilesX;
+    int _tilesY;
+    size_t _maxLoadedTiles;
+
+    std::unordered_map<long long, Tile*> _tiles;
+    procademy::CMemoryPool<Tile> _tilePool{ 64, false };
+    unsigned long long _useClock = 0;
+    size_t _loadCount = 0;
+    size_t _pinnedCount = 0;
+
+    // 직전에 접근한 타일 캐시 (같은 타일 연속 접근 시 해시 조회 생략)
+    long long _cachedKey = -1;
+    Tile* _cachedTile = nullptr;
+};
+
+class ChunkedAStar
+{
+public:
+    ChunkedAStar();
+    ~ChunkedAStar();
+
+    void SetHeuristicType(AStar::HeuristicType type) { _heuristicType = type; }
+    void SetAllowDiagonal(bool allow) { _allowDiagonal = allow; }
+
+    // 경로를 찾으면 outPath에 시작 -> 끝 순서로 채우고 true
+    // maxExpansions를 넘으면 포기 (0: 제한 없음)
+    bool FindPath(ChunkedWorld& world, Point start, Point end, std::vector<Point>& outPath, size_t maxExpansions = 0);
+
+    size_t GetExpandedCount() const { return _expandedCount; }
+    size_t GetTouchedTileCount() const { return _stateTiles.size(); }
+    // 마지막 탐색이 쓴 탐색 상태 메모리 (바이트)
+    size_t GetStateBytes() const { return _stateTiles.size() * sizeof(StateTile); }
+
+private:
+    // 타일 하나 분량의 탐색 상태
+    struct StateTile
+    {
+        float g[ITileStore::TILE_CELLS];
+        signed char parentDir[ITileStore::TILE_CELLS]; // 부모에서 온 방향 (-1: 시작)
+        unsigned char state[ITileStore::TILE_CELLS];   // 0: 미방문, 1: open, 2: closed
+    };
+
+    struct OpenEntry
+    {
+        float f;
+        float h;
+        int x;
+        int y;
+    };
+
+    StateTile& GetStateTile(int x, int y);
+    void ReleaseStateTiles();
+    float CalculateH(int x, int y, Point end) const;
+
+private:
+    AStar::HeuristicType _heuristicType = AStar::HeuristicType::MANHATTAN;
+    bool _allowDiagonal = true;
+
+    std::unordered_map<long long, StateTile*> _stateTiles;
+    procademy::CMemoryPool<StateTile> _statePool{ 16, false };
+    long long _cachedKey = -1;
+    StateTile* _cachedTile = nullptr;
+
+    std::vector<OpenEntry> _openList;
+    size_t _expandedCount = 0;
+};
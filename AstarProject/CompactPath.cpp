@@ -0,0 +1,113 @@
+﻿#include "MemoryPool.h"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include "AStar.h"
+#include "CompactPath.h"
+
+namespace
+{
+    const int MAX_RUN = 32;
+
+    // (ddx + 1) * 3 + (ddy + 1) -> 방향 인덱스
+    constexpr int DIRECTION_TABLE[9] = { 4, 2, 6, 0, -1, 1, 5, 3, 7 };
+}
+
+int CompactPath::DirectionOf(int ddx, int ddy)
+{
+    if (ddx < -1 || ddx > 1 || ddy < -1 || ddy > 1) return -1;
+    return DIRECTION_TABLE[(ddx + 1) * 3 + (ddy + 1)];
+}
+
+void CompactPath::Clear()
+{
+    _start = { -1, -1 };
+    _end = { -1, -1 };
+    _length = 0;
+    _runs.clear();
+}
+
+void CompactPath::AppendStep(int direction)
+{
+    if (!_runs.empty())
+    {
+        unsigned char& last = _runs.back();
+        if ((last >> 5) == direction && (last & 0x1F) < MAX_RUN - 1)
+        {
+            ++last;
+            return;
+        }
+    }
+    _runs.push_back((unsigned char)(direction << 5));
+}
+
+bool CompactPath::Assign(const std::vector<Point>& path)
+{
+    Clear();
+    if (path.empty()) return true;
+
+    for (size_t i = 1; i < path.size(); ++i)
+    {
+        int direction = DirectionOf(path[i].x - path[i - 1].x, path[i].y - path[i - 1].y);
+        if (direction < 0)
+        {
+            Clear();
+            return false;
+        }
+        AppendStep(direction);
+    }
+
+    _start = path.front();
+    _end = path.back();
+    _length = (int)path.size();
+    _runs.shrink_to_fit();
+    return true;
+}
+
+void CompactPath::AssignRuns(Point start, const unsigned char* runs, size_t runCount)
+{
+    _runs.assign(runs, runs + runCount);
+    _start = start;
+
+    // 끝 칸과 길이는 런을 훑어서 계산
+    _end = start;
+    _length = 1;
+    for (unsigned char run : _runs)
+    {
+        int dir = run >> 5;
+        int count = (run & 0x1F) + 1;
+        _end.x += AStar::dx[dir] * count;
+        _end.y += AStar::dy[dir] * count;
+        _length += count;
+    }
+}
+
+void CompactPath::BeginReverse(Point end)
+{
+    Clear();
+    _end = end;
+    _length = 1;
+}
+
+void CompactPath::PushReverse(int direction)
+{
+    // 거꾸로 쌓인 런은 FinishReverse에서 순서만 뒤집으면 됨 (런 안의 칸은 모두 같은 방향)
+    AppendStep(direction);
+    ++_length;
+}
+
+void CompactPath::FinishReverse(Point start)
+{
+    _start = start;
+    std::reverse(_runs.begin(), _runs.end());
+    _runs.shrink_to_fit(); // 경로를 오래 들고 있는 용도라 여유 공간은 돌려줌
+}
+
+void CompactPath::ToPoints(std::vector<Point>& out) const
+{
+    out.clear();
+    out.reserve(_length);
+    for (Point p : *this)
+        out.push_back(p);
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+﻿#pragma once
+
+// -----------------------------------------------------------
+// CompactPath (런 길이 인코딩 경로)
+//
+// std::vector<Point>는 칸마다 8바이트를 쓰므로 유닛 수천 개의 경로를 들고 있으면 부담이 큽니다.
+// 시작 칸 + (방향, 연속 칸 수) 런 목록만 저장합니다.
+// - 런 하나 = 1바이트 (상위 3비트: AStar::dx/dy 방향 인덱스, 하위 5비트: 칸 수 - 1)
+//   32칸보다 긴 직선은 런 여러 개로 나눔
+// - AStar의 parent 체인(끝 -> 시작)을 그대로 따라가며 만들 수 있도록 역순 입력을 지원
+// - 반복자는 런을 한 칸씩 풀어가며 Point를 돌려줌 (전체를 미리 풀지 않음)
+// -----------------------------------------------------------
+class CompactPath
+{
+public:
+    class Iterator
+    {
+    public:
+        Point operator*() const { return _pos; }
+        Iterator& operator++()
+        {
+            if (++_index >= _path->_length) return *this; // 끝 칸을 지나면 더 풀 런이 없음
+
+            unsigned char run = _path->_runs[_run];
+            int dir = run >> 5;
+            _pos.x += AStar::dx[dir];
+            _pos.y += AStar::dy[dir];
+            if (++_offset > (run & 0x1F))
+            {
+                ++_run;
+                _offset = 0;
+            }
+            return *this;
+        }
+        bool operator==(const Iterator& other) const { return _index == other._index; }
+        bool operator!=(const Iterator& other) const { return _index != other._index; }
+
+    private:
+        friend class CompactPath;
+        Iterator(const CompactPath* path, int index, Point pos) : _path(path), _index(index), _pos(pos) {}
+
+        const CompactPath* _path;
+        int _index;      // 몇 번째 칸인지 (0 = 시작 칸)
+        size_t _run = 0; // 다음 한 칸을 꺼낼 런
+        int _offset = 0; // 그 런에서 이미 지나온 칸 수
+        Point _pos;
+    };
+
+public:
+    void Clear();
+
+    // vector<Point>로부터 (이웃한 칸끼리만 이어져야 함. 아니면 false + 빈 경로)
+    bool Assign(const std::vector<Point>& path);
+
+    // 직렬화된 런 바이트로부터 (네트워크 / 파일로 주고받을 때)
+    void AssignRuns(Point start, const unsigned char* runs, size_t runCount);
+    const unsigned char* GetRunData() const { return _runs.data(); }
+
+    // 끝 칸부터 한 칸씩 거꾸로 입력: BeginReverse(end) -> PushReverse(이전 칸 -> 현재 칸 방향) ... -> FinishReverse(start)
+    void BeginReverse(Point end);
+    void PushReverse(int direction);
+    void FinishReverse(Point start);
+
+    // 한 칸 이동(ddx, ddy)에 해당하는 방향 인덱스 (이웃이 아니면 -1)
+    static int DirectionOf(int ddx, int ddy);
+
+    Iterator begin() const { return Iterator(this, 0, _start); }
+    Iterator end() const { return Iterator(this, _length, _end); }
+
+    void ToPoints(std::vector<Point>& out) const;
+
+    bool IsEmpty() const { return _length == 0; }
+    int GetLength() const { return _length; } // 시작 칸 포함 칸 수
+    Point GetStart() const { return _start; }
+    Point GetEnd() const { return _end; }
+    size_t GetRunCount() const { return _runs.size(); }
+    size_t GetByteSize() const { return sizeof(CompactPath) + _runs.capacity(); } // 실제 차지하는 메모리
+
+private:
+    void AppendStep(int direction); // 마지막 런에 붙이거나 새 런 시작
+
+private:
+    Point _start{ -1, -1 };
+    Point _end{ -1, -1 };
+    int _length = 0;
+    std::vector<unsigned char> _runs;
+};
\ No newline at end of file
@@ -0,0 +1,564 @@
+﻿#include "MemoryPool.h"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include "AStar.h"
+#include "CooperativeAStar.h"
+
+namespace
+{
+    const size_t INITIAL_TABLE_SIZE = 1024;
+    const float INF = std::numeric_limits<float>::infinity();
+
+    // 방향 i의 반대 방향 (AStar::dx/dy 순서 기준)
+    const int OPPOSITE[8] = { 1, 0, 3, 2, 7, 6, 5, 4 };
+
+    // [추가] 한 틱 계획 안에서 에이전트 하나가 남 때문에 다시 계획되는 최대 횟수 (서로 밀어내며 끝나지 않는 것 방지)
+    const int MAX_REPLANS = 4;
+
+    // 제자리 대기 비용 (직선 이동 한 칸과 같게 두어 휴리스틱이 일관되게 유지됨)
+    const float WAIT_COST = 1.0f;
+
+    size_t HashKey(unsigned long long key)
+    {
+        // 64비트 혼합 (splitmix64 마무리 단계)
+        key ^= key >> 31;
+        key *= 0x7fb5d329728ea185ULL;
+        key ^= key >> 27;
+        key *= 0x81dadef4bc2dd44dULL;
+        key ^= key >> 33;
+        return (size_t)key;
+    }
+}
+
+CooperativeAStar::CooperativeAStar(const AStar& map)
+    : _map(map)
+{
+    _reservations.resize(INITIAL_TABLE_SIZE);
+    _nodeIndex.resize(INITIAL_TABLE_SIZE);
+    _goalIndex.resize(INITIAL_TABLE_SIZE);
+    NextStamp(_reservations, _reservationStamp);
+    NextStamp(_nodeIndex, _nodeStamp);
+    NextStamp(_goalIndex, _goalStamp);
+    _goalMapVersion = map.GetMapVersion();
+}
+
+// -----------------------------------------------------------
+// 해시 테이블
+// -----------------------------------------------------------
+void CooperativeAStar::NextStamp(std::vector<Slot>& table, unsigned int& stamp)
+{
+    // 세대 번호가 한 바퀴 돌면 실제로 지워줌
+    if (++stamp == 0)
+    {
+        for (Slot& slot : table) slot.stamp = 0;
+        stamp = 1;
+    }
+}
+
+int* CooperativeAStar::Find(std::vector<Slot>& table, unsigned int stamp, unsigned long long key, bool insert)
+{
+    size_t mask = table.size() - 1;
+    for (size_t i = HashKey(key) & mask;; i = (i + 1) & mask)
+    {
+        Slot& slot = table[i];
+        if (slot.stamp != stamp)
+        {
+            if (!insert) return nullptr;
+            slot.key = key;
+            slot.stamp = stamp;
+            slot.value = NO_AGENT;
+            return &slot.value;
+        }
+        if (slot.key == key) return &slot.value;
+    }
+}
+
+const int* CooperativeAStar::Find(const std::vector<Slot>& table, unsigned int stamp, unsigned long long key)
+{
+    size_t mask = table.size() - 1;
+    for (size_t i = HashKey(key) & mask;; i = (i + 1) & mask)
+    {
+        const Slot& slot = table[i];
+        if (slot.stamp != stamp) return nullptr;
+        if (slot.key == key) return &slot.value;
+    }
+}
+
+void CooperativeAStar::Grow(std::vector<Slot>& table, unsigned int stamp)
+{
+    // 살아 있는 슬롯만 두 배 크기 테이블로 옮김 (새 테이블의 빈 칸은 stamp 0)
+    std::vector<Slot> old(table.size() * 2, Slot{ 0, 0, NO_AGENT });
+    old.swap(table);
+    for (const Slot& slot : old)
+    {
+        if (slot.stamp != stamp) continue;
+        *Find(table, stamp, slot.key, true) = slot.value;
+    }
+}
+
+// -----------------------------------------------------------
+// 예약
+// -----------------------------------------------------------
+void CooperativeAStar::ClearReservations()
+{
+    NextStamp(_reservations, _reservationStamp);
+    _reservationCount = 0;
+}
+
+int& CooperativeAStar::ReserveSlot(unsigned long long key)
+{
+    int* owner = Find(_reservations, _reservationStamp, key, false);
+    if (owner != nullptr) return *owner;
+
+    if ((_reservationCount + 1) * 2 > _reservations.size())
+        Grow(_reservations, _reservationStamp);
+    ++_reservationCount;
+    return *Find(_reservations, _reservationStamp, key, true);
+}
+
+void CooperativeAStar::ReserveCell(Point p, int t, int agentId)
+{
+    ReserveSlot(VertexKey(p.y * _map.GetMapWidth() + p.x, t)) = agentId;
+}
+
+int CooperativeAStar::GetCellOwner(int x, int y, int t) const
+{
+    const int* owner = Find(_reservations, _reservationStamp, VertexKey(y * _map.GetMapWidth() + x, t));
+    return owner ? *owner : NO_AGENT;
+}
+
+template <typename Func>
+void CooperativeAStar::ForEachPathKey(const std::vector<Point>& path, int fromTime, Func func) const
+{
+    if (path.empty()) return;
+
+    int width = _map.GetMapWidth();
+    int last = (std::min)((int)path.size() - 1, _window);
+    for (int t = fromTime; t <= last; ++t)
+    {
+        const Point& from = path[t];
+        func(VertexKey(from.y * width + from.x, t));
+        if (t == last) break;
+
+        // 간선: from -> to로 움직이면 같은 틱에 to -> from 이동을 막음
+        const Point& to = path[t + 1];
+        if (from.x == to.x && from.y == to.y) continue;
+        for (int i = 0; i < 8; ++i)
+        {
+            if (from.x + AStar::dx[i] != to.x || from.y + AStar::dy[i] != to.y) continue;
+            func(EdgeKey(to.y * width + to.x, OPPOSITE[i], t));
+            break;
+        }
+    }
+
+    // 창보다 일찍 끝난 경로는 마지막 칸에 머무름
+    const Point& rest = path.back();
+    for (int t = (std::max)(last + 1, fromTime); t <= _window; ++t)
+        func(VertexKey(rest.y * width + rest.x, t));
+}
+
+int CooperativeAStar::ReservePath(const std::vector<Point>& path, int agentId)
+{
+    return ReservePath(path, agentId, nullptr);
+}
+
+int CooperativeAStar::ReservePath(const std::vector<Point>& path, int agentId, std::vector<int>* blockers)
+{
+    if (blockers) blockers->clear();
+
+    // [수정] 다른 에이전트의 예약은 덮어쓰지 않음 (실패한 에이전트의 부분 경로가 먼저 계획된 경로를 지우던 문제)
+    int skipped = 0;
+    ForEachPathKey(path, 0, [&](unsigned long long key)
+    {
+        int& owner = ReserveSlot(key);
+        if (owner == NO_AGENT || owner == agentId)
+        {
+            owner = agentId;
+            return;
+        }
+        ++skipped;
+        if (blockers && std::find(blockers->begin(), blockers->end(), owner) == blockers->end())
+            blockers->push_back(owner);
+    });
+    return skipped;
+}
+
+void CooperativeAStar::ReleasePath(const std::vector<Point>& path, int agentId, int fromTime)
+{
+    // 슬롯은 남겨두고 주인만 비움 (개방 주소법이라 슬롯을 지우면 탐사 사슬이 끊김)
+    ForEachPathKey(path, fromTime, [&](unsigned long long key)
+    {
+        int* owner = Find(_reservations, _reservationStamp, key, false);
+        if (owner != nullptr && *owner == agentId) *owner = NO_AGENT;
+    });
+}
+
+bool CooperativeAStar::IsPathReserved(const std::vector<Point>& path, int agentId) const
+{
+    bool reserved = true;
+    ForEachPathKey(path, 0, [&](unsigned long long key)
+    {
+        const int* owner = Find(_reservations, _reservationStamp, key);
+        if (owner == nullptr || *owner != agentId) reserved = false;
+    });
+    return reserved;
+}
+
+bool CooperativeAStar::IsBlocked(unsigned long long key, int agentId) const
+{
+    const int* owner = Find(_reservations, _reservationStamp, key);
+    return owner != nullptr && *owner != NO_AGENT && *owner != agentId;
+}
+
+bool CooperativeAStar::IsFreeUntilWindow(int cell, int t, int agentId) const
+{
+    for (; t <= _window; ++t)
+    {
+        if (IsBlocked(VertexKey(cell, t), agentId)) return false;
+    }
+    return true;
+}
+
+// -----------------------------------------------------------
+// 휴리스틱 (목표별 실제 거리)
+// -----------------------------------------------------------
+CooperativeAStar::GoalDistance& CooperativeAStar::AcquireGoalDistance(int goalCell, Point origin)
+{
+    // 맵이 바뀌었으면 캐시된 거리는 전부 무효
+    if (_goalMapVersion != _map.GetMapVersion())
+    {
+        _goalMapVersion = _map.GetMapVersion();
+        _goalDistances.clear();
+        NextStamp(_goalIndex, _goalStamp);
+    }
+
+    int* index = Find(_goalIndex, _goalStamp, (unsigned long long)goalCell, false);
+    if (index != nullptr)
+    {
+        _goalDistances[*index].lastUsed = ++_useCounter;
+        return _goalDistances[*index];
+    }
+
+    // 1. [수정] 용량을 넘었으면 가장 오래 안 쓴 필드부터 버림 (필드 크기는 실제로 만든 블록 수에 따라 다름)
+    size_t usedBytes = 0;
+    for (const GoalDistance& field : _goalDistances) usedBytes += field.GetBytes();
+
+    bool evicted = false;
+    while (!_goalDistances.empty() && usedBytes > _heuristicCacheBytes)
+    {
+        int oldest = 0;
+        for (int i = 1; i < (int)_goalDistances.size(); ++i)
+        {
+            if (_goalDistances[i].lastUsed < _goalDistances[oldest].lastUsed) oldest = i;
+        }
+        usedBytes -= _goalDistances[oldest].GetBytes();
+        std::swap(_goalDistances[oldest], _goalDistances.back());
+        _goalDistances.pop_back();
+        evicted = true;
+    }
+    // 밀려난 목표를 인덱스에서 빼기 위해 인덱스를 다시 만듦 (개방 주소법이라 한 칸만 지울 수 없음)
+    if (evicted) RebuildGoalIndex();
+
+    int slot = (int)_goalDistances.size();
+    _goalDistances.emplace_back();
+    if ((_goalDistances.size() + 1) * 2 > _goalIndex.size())
+        Grow(_goalIndex, _goalStamp);
+
+    GoalDistance& field = _goalDistances[slot];
+
+    // 2. 목표에서 시작 (블록은 역방향 A*가 닿을 때 만듦)
+    int blocksX = (_map.GetMapWidth() + DISTANCE_BLOCK_SIZE - 1) >> DISTANCE_BLOCK_SHIFT;
+    int blocksY = (_map.GetMapHeight() + DISTANCE_BLOCK_SIZE - 1) >> DISTANCE_BLOCK_SHIFT;
+    field.goalCell = goalCell;
+    field.origin = origin;
+    field.lastUsed = ++_useCounter;
+    field.blockIndex.assign((size_t)blocksX * blocksY, -1);
+
+    int offset = 0;
+    TouchBlock(field, goalCell, offset).g[offset] = 0.0f;
+    field.heap.push_back({ CalculateOctile(goalCell, origin), goalCell });
+
+    *Find(_goalIndex, _goalStamp, (unsigned long long)goalCell, true) = slot;
+    return field;
+}
+
+void CooperativeAStar::RebuildGoalIndex()
+{
+    NextStamp(_goalIndex, _goalStamp);
+    for (int i = 0; i < (int)_goalDistances.size(); ++i)
+        *Find(_goalIndex, _goalStamp, (unsigned long long)_goalDistances[i].goalCell, true) = i;
+}
+
+CooperativeAStar::DistanceBlock* CooperativeAStar::FindBlock(GoalDistance& field, int cell, int& offset) const
+{
+    int width = _map.GetMapWidth();
+    int x = cell % width;
+    int y = cell / width;
+    int blocksX = (width + DISTANCE_BLOCK_SIZE - 1) >> DISTANCE_BLOCK_SHIFT;
+    offset = ((y & (DISTANCE_BLOCK_SIZE - 1)) << DISTANCE_BLOCK_SHIFT) | (x & (DISTANCE_BLOCK_SIZE - 1));
+
+    int block = field.blockIndex[(y >> DISTANCE_BLOCK_SHIFT) * blocksX + (x >> DISTANCE_BLOCK_SHIFT)];
+    return (block < 0) ? nullptr : &field.blocks[block];
+}
+
+CooperativeAStar::DistanceBlock& CooperativeAStar::TouchBlock(GoalDistance& field, int cell, int& offset) const
+{
+    DistanceBlock* found = FindBlock(field, cell, offset);
+    if (found != nullptr) return *found;
+
+    int width = _map.GetMapWidth();
+    int blocksX = (width + DISTANCE_BLOCK_SIZE - 1) >> DISTANCE_BLOCK_SHIFT;
+    int x = cell % width;
+    int y = cell / width;
+    field.blockIndex[(y >> DISTANCE_BLOCK_SHIFT) * blocksX + (x >> DISTANCE_BLOCK_SHIFT)] = (int)field.blocks.size();
+
+    field.blocks.emplace_back();
+    DistanceBlock& block = field.blocks.back();
+    std::fill(block.g, block.g + DISTANCE_BLOCK_CELLS, INF);
+    std::fill(block.closed, block.closed + DISTANCE_BLOCK_CELLS, (unsigned char)0);
+    return block;
+}
+
+float CooperativeAStar::ResumeDistance(GoalDistance& field, int cell)
+{
+    int offset = 0;
+    const DistanceBlock* target = FindBlock(field, cell, offset);
+    if (target != nullptr && target->closed[offset]) return target->g[offset];
+
+    // 이동 규칙이 대칭이므로 목표에서 거꾸로 도는 탐색도 같은 이동 마스크를 그대로 씀
+    int width = _map.GetMapWidth();
+    while (!field.heap.empty())
+    {
+        std::pop_heap(field.heap.begin(), field.heap.end(), DistEntryCompare());
+        int index = field.heap.back().second;
+        field.heap.pop_back();
+
+        // 힙에 들어간 칸은 이미 블록이 있음
+        DistanceBlock& current = *FindBlock(field, index, offset);
+        if (current.closed[offset]) continue; // Lazy Deletion
+        current.closed[offset] = 1;
+        float g = current.g[offset];
+
+        int x = index % width;
+        int y = index / width;
+        unsigned int mask = _map.GetMoveMask(x, y);
+        for (int i = 0; i < 8; ++i)
+        {
+            if ((mask & (1u << i)) == 0) continue;
+
+            // TouchBlock이 블록을 추가하면 current는 무효가 되므로 여기서부터는 쓰지 않음
+            int nextIndex = (y + AStar::dy[i]) * width + (x + AStar::dx[i]);
+            int nextOffset = 0;
+            DistanceBlock& next = TouchBlock(field, nextIndex, nextOffset);
+            float newG = g + AStar::cost[i];
+            if (!next.closed[nextOffset] && newG < next.g[nextOffset])
+            {
+                next.g[nextOffset] = newG;
+                field.heap.push_back({ newG + CalculateOctile(nextIndex, field.origin), nextIndex });
+                std::push_heap(field.heap.begin(), field.heap.end(), DistEntryCompare());
+            }
+        }
+
+        if (index == cell) return g;
+    }
+    return INF;
+}
+
+float CooperativeAStar::CalculateOctile(int cell, Point goal) const
+{
+    // 대기 비용(1)과 이동 비용에 대해 일관된 휴리스틱: 옥타일 / 맨해튼 거리
+    int width = _map.GetMapWidth();
+    return AStar::HeuristicDistance(AStar::GetConsistentHeuristic(_map.GetAllowDiagonal()), { cell % width, cell / width }, goal);
+}
+
+// -----------------------------------------------------------
+// 탐색
+// -----------------------------------------------------------
+bool CooperativeAStar::FindPath(Point start, Point goal, int agentId, std::vector<Point>& outPath)
+{
+    outPath.clear();
+
+    int width = _map.GetMapWidth();
+    int height = _map.GetMapHeight();
+    if (start.x < 0 || start.x >= width || start.y < 0 || start.y >= height) return false;
+    if (goal.x < 0 || goal.x >= width || goal.y < 0 || goal.y >= height) return false;
+    if (!_map.IsWalkable(start.x, start.y)) return false;
+
+    // 1. 노드 저장소 / 인덱스 초기화 (메모리는 그대로)
+    _nodes.clear();
+    _open.clear();
+    NextStamp(_nodeIndex, _nodeStamp);
+    _nodeIndexCount = 0;
+
+    int goalCell = goal.y * width + goal.x;
+    int startCell = start.y * width + start.x;
+
+    // 이미 목표에 있고 창 끝까지 머물 수 있으면 탐색 없이 끝 (도착한 에이전트가 대부분인 틱에서 중요)
+    if (startCell == goalCell && IsFreeUntilWindow(goalCell, 0, agentId))
+    {
+        outPath.assign(1, start);
+        return true;
+    }
+
+    // 목표까지 실제 거리. 목표가 벽이거나 다른 동굴이면 옥타일 거리로 목표 쪽으로만 다가감
+    GoalDistance* field = nullptr;
+    if (_map.IsWalkable(goal.x, goal.y))
+    {
+        field = &AcquireGoalDistance(goalCell, start);
+        if (std::isinf(ResumeDistance(*field, startCell))) field = nullptr;
+    }
+    auto calculateH = [&](int cell) { return field ? ResumeDistance(*field, cell) : CalculateOctile(cell, goal); };
+
+    auto addNode = [&](int cell, int t, float g, int parent)
+    {
+        if ((_nodeIndexCount + 1) * 2 > _nodeIndex.size())
+            Grow(_nodeIndex, _nodeStamp);
+
+        int* index = Find(_nodeIndex, _nodeStamp, VertexKey(cell, t), true);
+        if (*index != NO_AGENT)
+        {
+            // 이미 있는 상태: 더 짧을 때만 갱신 (닫힌 상태는 일관된 휴리스틱이라 다시 열 필요 없음)
+            SearchNode& node = _nodes[*index];
+            if (node.closed || g >= node.g) return;
+            node.g = g;
+            node.parent = parent;
+        }
+        else
+        {
+            *index = (int)_nodes.size();
+            _nodes.push_back({ g, parent, cell, t, false });
+            ++_nodeIndexCount;
+        }
+
+        float h = calculateH(cell);
+        _open.push_back({ g + h, h, *index });
+        std::push_heap(_open.begin(), _open.end(), OpenEntryCompare());
+    };
+
+    addNode(startCell, 0, 0.0f, -1);
+
+    // 2. (cell, t) 공간 A* (Lazy Deletion)
+    int found = -1;
+    int deepest = 0; // 실패했을 때 돌려줄, 충돌 없이 가장 멀리(늦게) 간 노드
+    while (!_open.empty())
+    {
+        std::pop_heap(_open.begin(), _open.end(), OpenEntryCompare());
+        OpenEntry entry = _open.back();
+        _open.pop_back();
+
+        SearchNode& node = _nodes[entry.node];
+        if (node.closed || entry.f - entry.h > node.g + 0.0001f) continue; // 낡은 항목
+        node.closed = true;
+        ++_expandedCount;
+        if (node.t > _nodes[deepest].t) deepest = entry.node;
+
+        // 목표 도착 + 창 끝까지 그 칸에 머물 수 있음 / 창 끝에 도달 -> 여기까지를 경로로
+        if ((node.cell == goalCell && IsFreeUntilWindow(goalCell, node.t, agentId)) || node.t >= _window)
+        {
+            found = entry.node;
+            break;
+        }
+
+        // push_back으로 node 참조가 무효화될 수 있으므로 값으로 복사해 둠
+        int cell = node.cell;
+        int t = node.t;
+        float g = node.g;
+        int x = cell % width;
+        int y = cell / width;
+
+        // 대기
+        if (!IsBlocked(VertexKey(cell, t + 1), agentId))
+            addNode(cell, t + 1, g + WAIT_COST, entry.node);
+
+        // 이동
+        unsigned int mask = _map.GetMoveMask(x, y);
+        for (int i = 0; i < 8; ++i)
+        {
+            if ((mask & (1u << i)) == 0) continue;
+
+            int nextCell = (y + AStar::dy[i]) * width + (x + AStar::dx[i]);
+            if (IsBlocked(VertexKey(nextCell, t + 1), agentId)) continue;
+            if (IsBlocked(EdgeKey(cell, i, t), agentId)) continue;
+
+            addNode(nextCell, t + 1, g + AStar::cost[i], entry.node);
+        }
+    }
+
+    bool success = found >= 0;
+    if (!success) found = deepest;
+
+    // 3. 경로 추출 (노드의 t가 곧 경로 인덱스)
+    outPath.resize(_nodes[found].t + 1);
+    for (int index = found; index != -1; index = _nodes[index].parent)
+    {
+        const SearchNode& node = _nodes[index];
+        outPath[node.t] = { node.cell % width, node.cell / width };
+    }
+    return success;
+}
+
+int CooperativeAStar::PlanAgents(const std::vector<Agent>& agents, std::vector<std::vector<Point>>& outPaths)
+{
+    ClearReservations();
+    _expandedCount = 0;
+    outPaths.resize(agents.size());
+
+    // 1. 모든 에이전트의 현재 칸을 t = 0에 예약 (아직 계획 안 된 에이전트를 밟지 않게)
+    for (int i = 0; i < (int)agents.size(); ++i)
+        ReserveCell(agents[i].start, 0, i);
+
+    // 2. 우선순위 순서대로 계획하고 바로 예약
+    std::vector<int> replans(agents.size(), 0);
+    std::vector<int> pending;
+    std::vector<int> blockers;
+    std::vector<int> victims;
+    for (int i = 0; i < (int)agents.size(); ++i)
+    {
+        FindPath(agents[i].start, agents[i].goal, i, outPaths[i]);
+        if (ReservePath(outPaths[i], i) == 0) continue;
+
+        // 3. 창 끝까지 갈 수 없음 = 충돌 없이 갈 수 있는 데까지 간 뒤 머물 칸에
+        //    먼저 계획된 에이전트가 들어오기로 함. 그 에이전트들의 예약을 풀고,
+        //    이 에이전트의 경로를 먼저 예약한 뒤 다시 계획
+        // [수정] 다시 계획한 에이전트도 막히면 같은 방법으로 이어서 풀어줌 (에이전트마다 MAX_REPLANS번까지)
+        pending.assign(1, i);
+        while (!pending.empty())
+        {
+            int agent = pending.back();
+            pending.pop_back();
+
+            ReservePath(outPaths[agent], agent, &blockers);
+            victims.clear();
+            for (int blocker : blockers)
+            {
+                if (replans[blocker] < MAX_REPLANS) victims.push_back(blocker);
+            }
+            if (victims.empty()) continue;
+
+            for (int victim : victims)
+            {
+                ReleasePath(outPaths[victim], victim, 1);
+                ++replans[victim];
+            }
+            ReservePath(outPaths[agent], agent);
+
+            for (int victim : victims)
+            {
+                // 다시 막히면 갈 수 있는 데까지만 (그 뒤는 이미 예약된 칸과 겹칠 수 있음)
+                FindPath(agents[victim].start, agents[victim].goal, victim, outPaths[victim]);
+                if (ReservePath(outPaths[victim], victim) > 0) pending.push_back(victim);
+            }
+        }
+    }
+
+    // 4. 예약 일부를 끝내 갖지 못한 에이전트 수 (그 칸에서 먼저 계획된 에이전트와 충돌할 수 있음)
+    int failedCount = 0;
+    for (int i = 0; i < (int)agents.size(); ++i)
+    {
+        if (!IsPathReserved(outPaths[i], i)) ++failedCount;
+    }
+    return failedCount;
+}
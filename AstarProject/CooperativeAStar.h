@@ -0,0 +1,186 @@
+﻿#pragma once
+
+// -----------------------------------------------------------
+// CooperativeAStar (WHCA*: 예약 테이블을 쓰는 다중 에이전트 탐색)
+//
+// AStar는 다른 유닛을 모르기 때문에 무리 지어 움직이면 서로 겹치는 경로가 나오고
+// 나중에 비싼 충돌 보정이 필요합니다.
+// 이 탐색기는 (x, y, t) 공간에서 탐색하고, 먼저 계획된 에이전트의 경로를
+// 예약 테이블에 남겨 뒤에 계획되는 에이전트가 피해가게 합니다.
+// - 행동: 8(4)방향 이동 + 제자리 대기. 모든 행동은 1틱
+// - 충돌: 같은 시각 같은 칸(정점) / 같은 틱에 두 에이전트가 자리를 맞바꾸는 이동(간선)
+// - 창(window): 탐색은 t = window까지만 보고, 그 이후는 휴리스틱으로 추정
+//   (호출자는 창의 일부만 진행하고 다음 틱에 다시 계획)
+// - 휴리스틱: 다른 에이전트를 무시한 목표까지의 실제 거리 (목표에서 거꾸로 도는 재개 가능한 A*, RRA*)
+//   직선 거리를 쓰면 창 끝에서 막다른 동굴 안쪽을 "가장 가까운 곳"으로 골라 갇혀버림
+//   목표별 거리 필드는 틱을 넘어 캐시하고, 필요한 칸까지만 넓혀감 (용량 초과 시 가장 오래 안 쓴 것부터 버림)
+//   거리는 탐색이 닿은 8x8 블록에만 저장하므로 필드 하나의 크기는 맵이 아니라 탐색한 넓이에 비례
+// - 예약 테이블과 탐색 노드 테이블은 해시(개방 주소법)이고 세대 번호로 비우므로
+//   틱마다 / 에이전트마다 메모리를 다시 잡지 않음
+// -----------------------------------------------------------
+class CooperativeAStar
+{
+public:
+    struct Agent
+    {
+        Point start;
+        Point goal;
+    };
+
+    static constexpr int DEFAULT_WINDOW = 16;
+    static constexpr int NO_AGENT = -1;
+
+public:
+    explicit CooperativeAStar(const AStar& map);
+
+    // 계획 창 길이 (틱 수, 1 이상)
+    void SetWindow(int window) { _window = (std::max)(window, 1); }
+    int GetWindow() const { return _window; }
+
+    // 목표별 거리 필드 캐시 용량 (바이트, 실제로 만든 블록 기준. 최소 필드 1개). 맵이 바뀌면 캐시는 자동으로 비워짐
+    // [수정] 새 목표가 들어올 때 용량을 넘었으면 가장 오래 안 쓴 필드부터 버림
+    void SetHeuristicCacheBytes(size_t bytes) { _heuristicCacheBytes = bytes; }
+
+    // 한 틱 분량 계획. agents의 순서가 곧 우선순위 (앞쪽이 먼저 길을 가짐)
+    // outPaths[i][t] = 에이전트 i의 시각 t 위치 (t = 0은 출발 칸, 길이는 최대 window + 1)
+    // 목표에 먼저 도착한 경로는 그 자리에서 끝남 (창 끝까지 목표 칸을 예약해 둠)
+    // 창 끝까지 갈 수 없는 에이전트는 그 칸으로 들어오려던 에이전트들을 다시 계획해서 제자리 대기 자리를 만들어 줌
+    // (다시 계획한 에이전트가 또 막히면 이어서 풀어줌, 에이전트마다 몇 번까지만)
+    // 반환: 그래도 경로 일부를 먼저 예약된 칸 때문에 예약하지 못한 에이전트 수
+    //       (그 에이전트는 경로 끝 이후 머무는 동안 충돌 가능. 다른 에이전트의 예약은 덮어쓰지 않음)
+    int PlanAgents(const std::vector<Agent>& agents, std::vector<std::vector<Point>>& outPaths);
+
+    // ---------------------------------------------------
+    // 저수준 API (PlanAgents가 내부에서 쓰는 단계들)
+    // ---------------------------------------------------
+
+    // 예약 전부 비우기 (테이블 메모리는 유지)
+    void ClearReservations();
+
+    // 칸 (x, y)를 시각 t에 agentId가 쓰는 것으로 예약 (같은 에이전트는 자기 예약에 막히지 않음)
+    void ReserveCell(Point p, int t, int agentId);
+    // 시각 t에 (x, y)를 예약한 에이전트. 없으면 NO_AGENT
+    int GetCellOwner(int x, int y, int t) const;
+
+    // path (시각 0부터)를 예약. 목표에 일찍 도착한 경로는 마지막 칸을 창 끝까지 예약
+    // 다른 에이전트가 이미 예약한 슬롯은 건너뜀. 반환: 건너뛴 슬롯 수
+    int ReservePath(const std::vector<Point>& path, int agentId);
+
+    // 현재 예약을 피하는 start -> goal 경로 (시각 0부터 한 칸씩)
+    // 창 끝까지 충돌 없이 갈 수 없으면 false이고, outPath에는 충돌 없이 갈 수 있는 가장 늦은 시각까지의 경로
+    bool FindPath(Point start, Point goal, int agentId, std::vector<Point>& outPath);
+
+    // 통계
+    int GetExpandedCount() const { return _expandedCount; }       // 마지막 PlanAgents / FindPath 누적 확장 수
+    size_t GetReservationCount() const { return _reservationCount; } // 이번 틱에 쓴 예약 슬롯 수
+
+private:
+    // 예약 / 탐색 노드 공용 해시 슬롯 (stamp가 현재 세대와 다르면 빈 칸)
+    struct Slot
+    {
+        unsigned long long key;
+        unsigned int stamp;
+        int value;
+    };
+
+    struct SearchNode
+    {
+        float g;
+        int parent; // _nodes 인덱스 (-1: 출발)
+        int cell;
+        int t;
+        bool closed;
+    };
+
+    struct OpenEntry
+    {
+        float f;
+        float h;
+        int node;
+    };
+
+    // [수정] 거리 필드의 블록 하나 (ChunkedWorld의 타일처럼 역방향 A*가 처음 닿을 때 만듦)
+    // 맵 전체 크기의 g / closed 배열을 목표마다 잡으면 에이전트가 많을 때 캐시가 맵 크기 x 목표 수만큼 커짐
+    static constexpr int DISTANCE_BLOCK_SHIFT = 3;
+    static constexpr int DISTANCE_BLOCK_SIZE = 1 << DISTANCE_BLOCK_SHIFT;
+    static constexpr int DISTANCE_BLOCK_CELLS = DISTANCE_BLOCK_SIZE * DISTANCE_BLOCK_SIZE;
+
+    struct DistanceBlock
+    {
+        float g[DISTANCE_BLOCK_CELLS];
+        unsigned char closed[DISTANCE_BLOCK_CELLS];
+    };
+
+    // 목표 하나의 거리 필드 (목표에서 처음 물어본 에이전트 쪽으로 A*, 이후 필요한 칸까지 재개)
+    // 일관된 휴리스틱이므로 닫힌 칸의 g는 탐색 순서와 상관없이 정확한 거리
+    struct GoalDistance
+    {
+        int goalCell = -1;
+        Point origin{ -1, -1 };                  // 역방향 A*가 향하는 칸
+        std::vector<int> blockIndex;             // 블록 번호 -> blocks 인덱스 (-1: 아직 닿지 않은 블록, 거리 무한대)
+        std::vector<DistanceBlock> blocks;
+        std::vector<std::pair<float, int>> heap; // (g + origin까지 옥타일, 셀) 최소 힙
+        unsigned long long lastUsed = 0;
+
+        size_t GetBytes() const
+        {
+            return blockIndex.capacity() * sizeof(int) + blocks.capacity() * sizeof(DistanceBlock) +
+                heap.capacity() * sizeof(std::pair<float, int>);
+        }
+    };
+
+    // 키: 정점은 (t, cell, 0), 간선은 (t, cell, 1 + 방향) -> "t에 cell에서 그 방향으로 이동 금지"
+    static unsigned long long VertexKey(int cell, int t) { return ((unsigned long long)t << 36) | ((unsigned long long)cell << 4); }
+    static unsigned long long EdgeKey(int cell, int dir, int t) { return VertexKey(cell, t) | (unsigned long long)(1 + dir); }
+
+    // 해시 테이블 공용 연산 (선형 탐사, 용량은 2의 거듭제곱, 부하율 1/2 이하 유지)
+    static int* Find(std::vector<Slot>& table, unsigned int stamp, unsigned long long key, bool insert);
+    static const int* Find(const std::vector<Slot>& table, unsigned int stamp, unsigned long long key);
+    static void Grow(std::vector<Slot>& table, unsigned int stamp);
+    static void NextStamp(std::vector<Slot>& table, unsigned int& stamp);
+
+    int& ReserveSlot(unsigned long long key); // 예약 슬롯 (없으면 만듦)
+    // path가 fromTime부터 쓰는 예약 키 (정점 / 간선 / 일찍 끝난 경로의 머무는 칸)마다 func(key)
+    template <typename Func>
+    void ForEachPathKey(const std::vector<Point>& path, int fromTime, Func func) const;
+    // ReservePath + 건너뛴 슬롯의 주인들 (blockers는 매번 비우고 채움)
+    int ReservePath(const std::vector<Point>& path, int agentId, std::vector<int>* blockers);
+    void ReleasePath(const std::vector<Point>& path, int agentId, int fromTime); // agentId의 예약만 해제
+    bool IsPathReserved(const std::vector<Point>& path, int agentId) const;    // path의 예약을 모두 agentId가 가졌는지
+
+    bool IsBlocked(unsigned long long key, int agentId) const;
+    bool IsFreeUntilWindow(int cell, int t, int agentId) const; // t..window 동안 cell이 비어 있는지
+    float CalculateOctile(int cell, Point goal) const;
+
+    GoalDistance& AcquireGoalDistance(int goalCell, Point origin); // 캐시에서 찾거나 새로 시작
+    float ResumeDistance(GoalDistance& field, int cell); // cell이 확정될 때까지 진행. 도달 불가면 무한대
+    // cell이 든 블록과 블록 안 위치. FindBlock은 없으면 nullptr, TouchBlock은 없으면 만듦 (blocks가 커지면 이전 참조는 무효)
+    DistanceBlock* FindBlock(GoalDistance& field, int cell, int& offset) const;
+    DistanceBlock& TouchBlock(GoalDistance& field, int cell, int& offset) const;
+    void RebuildGoalIndex();
+
+private:
+    const AStar& _map;
+    int _window = DEFAULT_WINDOW;
+
+    std::vector<Slot> _reservations;
+    unsigned int _reservationStamp = 0;
+    size_t _reservationCount = 0;
+
+    // 탐색마다 다시 쓰는 노드 저장소 + (cell, t) -> 노드 인덱스 해시
+    std::vector<SearchNode> _nodes;
+    std::vector<Slot> _nodeIndex;
+    unsigned int _nodeStamp = 0;
+    size_t _nodeIndexCount = 0;
+    std::vector<OpenEntry> _open; // 최소 힙
+
+    // 목표 셀 -> _goalDistances 인덱스
+    std::vector<GoalDistance> _goalDistances;
+    std::vector<Slot> _goalIndex;
+    unsigned int _goalStamp = 0;
+    unsigned int _goalMapVersion = 0;
+    unsigned long long _useCounter = 0;
+    size_t _heuristicCacheBytes = 256 * 1024 * 1024;
+
+    int _expandedCount = 0;
+};
@@ -0,0 +1,152 @@
+﻿#include "MemoryPool.h"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <bit>
+#include "AStar.h"
+#include "DistanceTable.h"
+
+namespace
+{
+    const float INF = std::numeric_limits<float>::infinity();
+}
+
+DistanceTable::DistanceTable(const AStar& map)
+    : _map(map)
+{
+}
+
+std::vector<float> DistanceTable::OneToMany(Point start, const std::vector<Point>& targets, float maxCost)
+{
+    std::vector<float> result(targets.size(), INF);
+    if (!targets.empty())
+        Search(start, targets, maxCost, result.data(), 1);
+    return result;
+}
+
+std::vector<float> DistanceTable::ManyToMany(const std::vector<Point>& sources, const std::vector<Point>& targets, float maxCost)
+{
+    int sourceCount = (int)sources.size();
+    int targetCount = (int)targets.size();
+    std::vector<float> result((size_t)sourceCount * targetCount, INF);
+    if (sourceCount == 0 || targetCount == 0) return result;
+
+    if (sourceCount <= targetCount)
+    {
+        // 행 하나 = 출발지 하나의 탐색
+        for (int s = 0; s < sourceCount; ++s)
+            Search(sources[s], targets, maxCost, &result[(size_t)s * targetCount], 1);
+    }
+    else
+    {
+        // 목적지에서 출발지들로 탐색 -> 열 단위로 기록
+        for (int t = 0; t < targetCount; ++t)
+            Search(targets[t], sources, maxCost, &result[t], targetCount);
+    }
+    return result;
+}
+
+void DistanceTable::BeginSearch()
+{
+    size_t cellCount = (size_t)_map.GetMapWidth() * _map.GetMapHeight();
+    if (_g.size() != cellCount)
+    {
+        _g.assign(cellCount, INF);
+        _visitStamp.assign(cellCount, 0);
+        _closedStamp.assign(cellCount, 0);
+        _targetStamp.assign(cellCount, 0);
+        _generation = 0;
+    }
+
+    // 세대 번호가 한 바퀴 돌면 실제로 지워줌
+    if (++_generation == 0)
+    {
+        std::fill(_visitStamp.begin(), _visitStamp.end(), 0);
+        std::fill(_closedStamp.begin(), _closedStamp.end(), 0);
+        std::fill(_targetStamp.begin(), _targetStamp.end(), 0);
+        _generation = 1;
+    }
+
+    _heap.clear();
+    _settledCount = 0;
+}
+
+void DistanceTable::Search(Point start, const std::vector<Point>& targets, float maxCost, float* out, int stride)
+{
+    BeginSearch();
+
+    int width = _map.GetMapWidth();
+    int height = _map.GetMapHeight();
+
+    if (start.x < 0 || start.x >= width || start.y < 0 || start.y >= height) return;
+    if (!_map.IsWalkable(start.x, start.y)) return;
+
+    // 1. 목적지 표시 (중복 / 벽 / 범위 밖 목적지는 세지 않음)
+    int remaining = 0;
+    for (const Point& target : targets)
+    {
+        if (target.x < 0 || target.x >= width || target.y < 0 || target.y >= height) continue;
+        if (!_map.IsWalkable(target.x, target.y)) continue;
+
+        int index = target.y * width + target.x;
+        if (_targetStamp[index] == _generation) continue;
+        _targetStamp[index] = _generation;
+        ++remaining;
+    }
+
+    // 2. Dijkstra (Lazy Deletion)
+    int startIndex = start.y * width + start.x;
+    _g[startIndex] = 0.0f;
+    _visitStamp[startIndex] = _generation;
+    _heap.push_back({ 0.0f, startIndex });
+
+    while (!_heap.empty() && remaining > 0)
+    {
+        std::pop_heap(_heap.begin(), _heap.end(), DistEntryCompare());
+        auto [g, index] = _heap.back();
+        _heap.pop_back();
+
+        if (_closedStamp[index] == _generation) continue;
+        if (g > maxCost) break; // 이후는 전부 비용 한도 초과
+
+        _closedStamp[index] = _generation;
+        ++_settledCount;
+
+        if (_targetStamp[index] == _generation)
+            --remaining;
+
+        int x = index % width;
+        int y = index / width;
+        unsigned int mask = _map.GetMoveMask(x, y);
+        while (mask != 0)
+        {
+            int i = std::countr_zero(mask);
+            mask &= mask - 1;
+
+            int nextIndex = (y + AStar::dy[i]) * width + (x + AStar::dx[i]);
+            if (_closedStamp[nextIndex] == _generation) continue;
+
+            float newG = g + AStar::cost[i];
+            if (_visitStamp[nextIndex] != _generation || newG < _g[nextIndex])
+            {
+                _visitStamp[nextIndex] = _generation;
+                _g[nextIndex] = newG;
+                _heap.push_back({ newG, nextIndex });
+                std::push_heap(_heap.begin(), _heap.end(), DistEntryCompare());
+            }
+        }
+    }
+
+    // 3. 확정된 목적지만 결과로 기록
+    for (size_t i = 0; i < targets.size(); ++i)
+    {
+        const Point& target = targets[i];
+        if (target.x < 0 || target.x >= width || target.y < 0 || target.y >= height) continue;
+
+        int index = target.y * width + target.x;
+        if (_closedStamp[index] == _generation)
+            out[i * stride] = _g[index];
+    }
+}
@@ -0,0 +1,50 @@
+﻿#pragma once
+
+// -----------------------------------------------------------
+// DistanceTable (일대다 / 다대다 거리 조회)
+//
+// 유닛 하나에서 후보 목적지 여러 개까지의 비용이 필요할 때
+// 목적지마다 StartPathFinding을 돌리는 대신, Dijkstra 한 번으로
+// 모든 목적지를 확정(settle)합니다.
+// - 모든 목적지가 확정되거나 maxCost를 넘으면 바로 종료
+// - 탐색 버퍼는 세대(stamp) 번호로 무효화하므로 쿼리마다 맵 크기만큼 지우지 않음
+//   (ManyToMany는 같은 버퍼를 출발지마다 그대로 재사용)
+// - ManyToMany는 작은 쪽 칸마다 Dijkstra를 따로 돌림. 확정된 거리는 출발지마다 다르므로 다음 출발지로 넘기지 않고
+//   재사용하는 것은 버퍼와 힙 메모리뿐 (행 수만큼 탐색, 각 탐색은 자기 목적지가 모두 확정되면 멈춤)
+// -----------------------------------------------------------
+class DistanceTable
+{
+public:
+    explicit DistanceTable(const AStar& map);
+
+    // start -> targets[i] 비용. 도달 불가 / maxCost 초과면 무한대
+    std::vector<float> OneToMany(Point start, const std::vector<Point>& targets,
+                                 float maxCost = std::numeric_limits<float>::infinity());
+
+    // result[s * targets.size() + t] = sources[s] -> targets[t] 비용
+    // (이동 규칙이 대칭이므로 출발지가 더 많으면 목적지 쪽에서 탐색하고 뒤집음)
+    std::vector<float> ManyToMany(const std::vector<Point>& sources, const std::vector<Point>& targets,
+                                  float maxCost = std::numeric_limits<float>::infinity());
+
+    // 마지막 쿼리에서 확정된 노드 수 (통계용)
+    int GetSettledCount() const { return _settledCount; }
+
+private:
+    // start에서 Dijkstra. targets[i]까지의 비용을 out[i * stride]에 기록
+    void Search(Point start, const std::vector<Point>& targets, float maxCost, float* out, int stride);
+
+    // 맵 크기에 맞게 버퍼 준비 + 새 세대 시작
+    void BeginSearch();
+
+private:
+    const AStar& _map;
+
+    std::vector<float> _g;
+    std::vector<unsigned int> _visitStamp;  // == _generation 이면 _g 유효
+    std::vector<unsigned int> _closedStamp; // == _generation 이면 확정됨
+    std::vector<unsigned int> _targetStamp; // == _generation 이면 아직 확정 안 된 목적지
+    unsigned int _generation = 0;
+
+    std::vector<std::pair<float, int>> _heap; // (g, 셀 인덱스) 최소 힙
+    int _settledCount = 0;
+};
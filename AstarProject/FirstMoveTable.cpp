@@ -0,0 +1,351 @@
+﻿#include "MemoryPool.h"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <fstream>
+#include <limits>
+#include <bit>
+#include "AStar.h"
+#include "ParallelFor.h"
+#include "FirstMoveTable.h"
+
+namespace
+{
+    const char CPD_MAGIC[4] = { 'A', 'C', 'P', 'D' };
+    const unsigned char WILDCARD = 0xFF; // 자기 자신 / 도달 불가 (어느 구간에 합쳐도 됨)
+
+    // 스레드 하나가 출발지들을 처리할 때 재사용하는 버퍼
+    struct BuildBuffers
+    {
+        std::vector<float> g;
+        std::vector<unsigned char> firstMove;
+        std::vector<unsigned char> closed;
+        std::vector<std::pair<float, int>> heap;
+        std::vector<unsigned char> symbols; // 순서 번호별 첫 이동
+    };
+
+    template <typename T>
+    void WriteValue(std::ofstream& file, const T& value)
+    {
+        file.write((const char*)&value, sizeof(T));
+    }
+
+    template <typename T>
+    bool ReadValue(std::ifstream& file, T& value)
+    {
+        return (bool)file.read((char*)&value, sizeof(T));
+    }
+
+    template <typename T>
+    void WriteArray(std::ofstream& file, const std::vector<T>& values)
+    {
+        unsigned long long size = values.size();
+        WriteValue(file, size);
+        file.write((const char*)values.data(), sizeof(T) * values.size());
+    }
+
+    // [수정] 개수가 maxCount나 남은 파일 크기를 넘으면 할당 전에 거부
+    template <typename T>
+    bool ReadArray(std::ifstream& file, std::vector<T>& values, unsigned long long maxCount, unsigned long long fileSize)
+    {
+        unsigned long long size;
+        if (!ReadValue(file, size)) return false;
+
+        std::streamoff position = file.tellg();
+        if (position < 0 || size > maxCount || size > (fileSize - (unsigned long long)position) / sizeof(T)) return false;
+        values.resize((size_t)size);
+        return (bool)file.read((char*)values.data(), sizeof(T) * values.size());
+    }
+}
+
+unsigned long long FirstMoveTable::ComputeChecksum(const AStar& map)
+{
+    // FNV-1a (벽 비트열)
+    unsigned long long hash = 1469598103934665603ull;
+    for (int y = 0; y < map.GetMapHeight(); ++y)
+    {
+        for (int x = 0; x < map.GetMapWidth(); ++x)
+        {
+            hash ^= map.IsWalkable(x, y) ? 0u : 1u;
+            hash *= 1099511628211ull;
+        }
+    }
+    return hash;
+}
+
+void FirstMoveTable::BuildOrdering(const AStar& map)
+{
+    int cellCount = _width * _height;
+    _ordinal.assign(cellCount, -1);
+    _component.assign(cellCount, -1);
+
+    // DFS 전위 순서: 가까운 셀끼리 번호가 붙어 있어 첫 이동 구간이 길어짐
+    int nextOrdinal = 0;
+    int componentCount = 0;
+    std::vector<int> stack;
+    for (int seed = 0; seed < cellCount; ++seed)
+    {
+        if (_ordinal[seed] != -1 || !map.IsWalkable(seed % _width, seed / _width)) continue;
+
+        stack.push_back(seed);
+        while (!stack.empty())
+        {
+            int index = stack.back();
+            stack.pop_back();
+            if (_ordinal[index] != -1) continue;
+
+            _ordinal[index] = nextOrdinal++;
+            _component[index] = componentCount;
+
+            int x = index % _width;
+            int y = index / _width;
+            unsigned int mask = map.GetMoveMask(x, y);
+            // 역순으로 넣어야 dx/dy 순서대로 먼저 방문
+            for (int i = 7; i >= 0; --i)
+            {
+                if ((mask & (1u << i)) == 0) continue;
+                int nextIndex = (y + AStar::dy[i]) * _width + (x + AStar::dx[i]);
+                if (_ordinal[nextIndex] == -1) stack.push_back(nextIndex);
+            }
+        }
+        ++componentCount;
+    }
+}
+
+void FirstMoveTable::Build(const AStar& map, int threadCount)
+{
+    _width = map.GetMapWidth();
+    _height = map.GetMapHeight();
+    _allowDiagonal = map.GetAllowDiagonal();
+    _checksum = ComputeChecksum(map);
+
+    BuildOrdering(map);
+
+    int cellCount = _width * _height;
+    std::vector<int> cellOfOrdinal;
+    for (int index = 0; index < cellCount; ++index)
+    {
+        if (_ordinal[index] != -1) cellOfOrdinal.push_back(index);
+    }
+    std::sort(cellOfOrdinal.begin(), cellOfOrdinal.end(),
+        [this](int a, int b) { return _ordinal[a] < _ordinal[b]; });
+    int walkableCount = (int)cellOfOrdinal.size();
+
+    // 출발지별 결과 (스레드마다 자기 출발지 칸에만 씀)
+    std::vector<std::vector<unsigned int>> runStarts(walkableCount);
+    std::vector<std::vector<unsigned char>> runMoves(walkableCount);
+
+    ParallelFor(walkableCount, threadCount, [&](int sourceOrdinal)
+    {
+        thread_local BuildBuffers buffers;
+        buffers.g.assign(cellCount, std::numeric_limits<float>::infinity());
+        buffers.firstMove.assign(cellCount, WILDCARD);
+        buffers.closed.assign(cellCount, 0);
+        buffers.heap.clear();
+
+        // 1. Dijkstra (첫 이동은 부모에게서 물려받음)
+        int source = cellOfOrdinal[sourceOrdinal];
+        buffers.g[source] = 0.0f;
+        buffers.heap.push_back({ 0.0f, source });
+        while (!buffers.heap.empty())
+        {
+            std::pop_heap(buffers.heap.begin(), buffers.heap.end(), DistEntryCompare());
+            auto [g, index] = buffers.heap.back();
+            buffers.heap.pop_back();
+            if (buffers.closed[index]) continue;
+            buffers.closed[index] = 1;
+
+            int x = index % _width;
+            int y = index / _width;
+            unsigned int mask = map.GetMoveMask(x, y);
+            while (mask != 0)
+            {
+                int i = std::countr_zero(mask);
+                mask &= mask - 1;
+
+                int nextIndex = (y + AStar::dy[i]) * _width + (x + AStar::dx[i]);
+                float newG = g + AStar::cost[i];
+                if (newG < buffers.g[nextIndex])
+                {
+                    buffers.g[nextIndex] = newG;
+                    buffers.firstMove[nextIndex] = (index == source) ? (unsigned char)i : buffers.firstMove[index];
+                    buffers.heap.push_back({ newG, nextIndex });
+                    std::push_heap(buffers.heap.begin(), buffers.heap.end(), DistEntryCompare());
+                }
+            }
+        }
+
+        // 2. 순서 번호대로 나열 후 RLE (상관없음 칸은 앞 구간에 합침)
+        std::vector<unsigned int>& starts = runStarts[sourceOrdinal];
+        std::vector<unsigned char>& moves = runMoves[sourceOrdinal];
+        for (int ordinal = 0; ordinal < walkableCount; ++ordinal)
+        {
+            unsigned char move = buffers.firstMove[cellOfOrdinal[ordinal]];
+            if (move == WILDCARD) continue;
+            if (!moves.empty() && moves.back() == move) continue;
+
+            // 첫 구간은 0부터 시작하도록 (앞쪽 상관없음 칸 흡수)
+            starts.push_back(moves.empty() ? 0u : (unsigned int)ordinal);
+            moves.push_back(move);
+        }
+    });
+
+    // 3. 하나의 배열로 합치기
+    _runOffsets.assign(walkableCount + 1, 0);
+    for (int s = 0; s < walkableCount; ++s)
+        _runOffsets[s + 1] = _runOffsets[s] + (unsigned int)runMoves[s].size();
+
+    _runStarts.resize(_runOffsets[walkableCount]);
+    _runMoves.resize(_runOffsets[walkableCount]);
+    for (int s = 0; s < walkableCount; ++s)
+    {
+        std::copy(runStarts[s].begin(), runStarts[s].end(), _runStarts.begin() + _runOffsets[s]);
+        std::copy(runMoves[s].begin(), runMoves[s].end(), _runMoves.begin() + _runOffsets[s]);
+    }
+}
+
+bool FirstMoveTable::IsConsistent(unsigned long long cellCount) const
+{
+    if (_ordinal.size() != cellCount || _component.size() != cellCount || _runOffsets.empty()) return false;
+
+    // 순서 번호는 걸을 수 있는 칸마다 0 ~ (출발지 수 - 1) 하나씩, 벽은 순서 / 영역 모두 -1
+    size_t sourceCount = _runOffsets.size() - 1;
+    std::vector<unsigned char> seen(sourceCount, 0);
+    for (size_t i = 0; i < cellCount; ++i)
+    {
+        if ((_ordinal[i] == -1) != (_component[i] == -1) || _component[i] < -1) return false;
+        if (_ordinal[i] == -1) continue;
+        if (_ordinal[i] < 0 || (size_t)_ordinal[i] >= sourceCount || seen[_ordinal[i]]) return false;
+        seen[_ordinal[i]] = 1;
+    }
+    if (std::find(seen.begin(), seen.end(), 0) != seen.end()) return false;
+
+    // 구간 오프셋: 0부터 감소하지 않고 마지막이 구간 수와 같음
+    if (_runOffsets.front() != 0 || _runOffsets.back() != _runStarts.size() || _runStarts.size() != _runMoves.size())
+        return false;
+    for (size_t s = 0; s < sourceCount; ++s)
+    {
+        if (_runOffsets[s] > _runOffsets[s + 1]) return false;
+
+        // 출발지 하나의 구간 시작은 증가 순 (upper_bound 전제)
+        for (unsigned int r = _runOffsets[s] + 1; r < _runOffsets[s + 1]; ++r)
+        {
+            if (_runStarts[r] <= _runStarts[r - 1]) return false;
+        }
+    }
+
+    // 이동 코드는 AStar::dx/dy 인덱스 (대각선을 안 쓰면 직선 4방향만)
+    unsigned char moveLimit = _allowDiagonal ? 8 : 4;
+    return std::all_of(_runMoves.begin(), _runMoves.end(), [moveLimit](unsigned char move) { return move < moveLimit; });
+}
+
+int FirstMoveTable::GetFirstMove(Point start, Point end) const
+{
+    if (start.x < 0 || start.x >= _width || start.y < 0 || start.y >= _height) return NO_MOVE;
+    if (end.x < 0 || end.x >= _width || end.y < 0 || end.y >= _height) return NO_MOVE;
+    if (start == end) return NO_MOVE;
+
+    int startIndex = start.y * _width + start.x;
+    int endIndex = end.y * _width + end.x;
+    if (_component[startIndex] == -1 || _component[startIndex] != _component[endIndex]) return NO_MOVE;
+
+    // 목적지 순서 번호를 포함하는 구간 찾기
+    int source = _ordinal[startIndex];
+    auto first = _runStarts.begin() + _runOffsets[source];
+    auto last = _runStarts.begin() + _runOffsets[source + 1];
+    auto it = std::upper_bound(first, last, (unsigned int)_ordinal[endIndex]);
+    if (it == first) return NO_MOVE;
+
+    return _runMoves[(it - _runStarts.begin()) - 1];
+}
+
+bool FirstMoveTable::ExtractPath(Point start, Point end, std::vector<Point>& outPath) const
+{
+    outPath.clear();
+    if (start.x < 0 || start.x >= _width || start.y < 0 || start.y >= _height) return false;
+    if (end.x < 0 || end.x >= _width || end.y < 0 || end.y >= _height) return false;
+
+    int startIndex = start.y * _width + start.x;
+    int endIndex = end.y * _width + end.x;
+    if (_component[startIndex] == -1 || _component[startIndex] != _component[endIndex]) return false;
+
+    outPath.push_back(start);
+    Point current = start;
+    while (current != end)
+    {
+        int move = GetFirstMove(current, end);
+        // 테이블이 맵과 어긋났을 때 무한 루프 방지
+        if (move == NO_MOVE || outPath.size() > (size_t)_width * _height) return false;
+
+        current = { current.x + AStar::dx[move], current.y + AStar::dy[move] };
+        outPath.push_back(current);
+    }
+    return true;
+}
+
+size_t FirstMoveTable::GetMemoryBytes() const
+{
+    return _ordinal.size() * sizeof(int) + _component.size() * sizeof(int)
+        + _runOffsets.size() * sizeof(unsigned int) + _runStarts.size() * sizeof(unsigned int)
+        + _runMoves.size();
+}
+
+bool FirstMoveTable::Save(const char* path) const
+{
+    std::ofstream file(path, std::ios::binary);
+    if (!file) return false;
+
+    file.write(CPD_MAGIC, 4);
+    WriteValue(file, _width);
+    WriteValue(file, _height);
+    WriteValue(file, (unsigned char)(_allowDiagonal ? 1 : 0));
+    WriteValue(file, _checksum);
+    WriteArray(file, _ordinal);
+    WriteArray(file, _component);
+    WriteArray(file, _runOffsets);
+    WriteArray(file, _runStarts);
+    WriteArray(file, _runMoves);
+    return file.good();
+}
+
+bool FirstMoveTable::Load(const char* path, const AStar& map)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) return false;
+    unsigned long long fileSize = (unsigned long long)file.tellg();
+    file.seekg(0);
+
+    char magic[4];
+    if (!file.read(magic, 4) || !std::equal(magic, magic + 4, CPD_MAGIC)) return false;
+
+    int width, height;
+    unsigned char allowDiagonal;
+    unsigned long long checksum;
+    if (!ReadValue(file, width) || !ReadValue(file, height) || !ReadValue(file, allowDiagonal) || !ReadValue(file, checksum))
+        return false;
+
+    // 다른 맵(또는 바뀐 맵)에서 만든 테이블이면 거부
+    if (width != map.GetMapWidth() || height != map.GetMapHeight()) return false;
+    if ((allowDiagonal != 0) != map.GetAllowDiagonal() || checksum != ComputeChecksum(map)) return false;
+
+    // 다 읽은 뒤에 교체 (중간에 실패해도 기존 테이블 유지)
+    unsigned long long cellCount = (unsigned long long)width * height;
+    FirstMoveTable loaded;
+    if (!ReadArray(file, loaded._ordinal, cellCount, fileSize) || !ReadArray(file, loaded._component, cellCount, fileSize)
+        || !ReadArray(file, loaded._runOffsets, cellCount + 1, fileSize)
+        || !ReadArray(file, loaded._runStarts, cellCount * cellCount, fileSize)
+        || !ReadArray(file, loaded._runMoves, cellCount * cellCount, fileSize))
+        return false;
+
+    loaded._width = width;
+    loaded._height = height;
+    loaded._allowDiagonal = allowDiagonal != 0;
+    loaded._checksum = checksum;
+
+    // [추가] 조회가 배열 밖을 읽지 않도록 구조 검증
+    if (!loaded.IsConsistent(cellCount)) return false;
+
+    *this = std::move(loaded);
+    return true;
+}
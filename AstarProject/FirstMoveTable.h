@@ -0,0 +1,62 @@
+﻿#pragma once
+
+// -----------------------------------------------------------
+// FirstMoveTable (압축 경로 데이터베이스, CPD)
+//
+// 정적인 맵에서 같은 분포의 쿼리를 수없이 반복할 때 쓰는 오프라인 전처리.
+// 모든 출발 셀 s에 대해 "t로 가는 최단 경로의 첫 이동 방향"을 모든 t에 대해 구하고,
+// 좋은 셀 순서(DFS 전위 순서)로 나열한 뒤 같은 방향이 이어지는 구간을 RLE로 압축합니다.
+// 쿼리는 이진 탐색 한 번으로 첫 이동을 얻고, 이를 반복하면 경로가 나옵니다.
+// (쿼리 시 Open List / 휴리스틱 계산이 전혀 없음)
+//
+// - 자기 자신 / 다른 연결 영역으로 가는 칸은 "상관없음"으로 보고 앞 구간에 합침
+//   (연결 영역 번호로 도달 가능 여부를 먼저 확인하므로 안전)
+// - 출발 셀마다 Dijkstra가 독립이므로 Build는 ParallelFor로 코어 수만큼 나눠 돌림
+// -----------------------------------------------------------
+class FirstMoveTable
+{
+public:
+    static constexpr int NO_MOVE = -1;
+
+public:
+    // map의 현재 벽/대각선 설정으로 테이블 생성 (threadCount <= 0: 하드웨어 스레드 수)
+    void Build(const AStar& map, int threadCount = 0);
+
+    // 저장 / 불러오기. Load는 map이 Build 때와 같은 맵인지(크기, 대각선, 벽 체크섬) 확인
+    bool Save(const char* path) const;
+    bool Load(const char* path, const AStar& map);
+
+    // start에서 end로 가는 첫 이동 방향 (AStar::dx/dy 인덱스). 도달 불가 / 같은 칸이면 NO_MOVE
+    int GetFirstMove(Point start, Point end) const;
+
+    // 테이블 조회만으로 경로 추출 (시작 -> 끝 순서). 도달 불가면 false
+    bool ExtractPath(Point start, Point end, std::vector<Point>& outPath) const;
+
+    size_t GetRunCount() const { return _runMoves.size(); }
+    size_t GetMemoryBytes() const;
+
+private:
+    // 맵 벽 상태 체크섬 (Load 검증용)
+    static unsigned long long ComputeChecksum(const AStar& map);
+
+    // [추가] 불러온 배열끼리 크기 / 범위가 맞는지 (Load 검증용)
+    bool IsConsistent(unsigned long long cellCount) const;
+
+    // DFS 전위 순서로 걸을 수 있는 셀에 번호 부여 + 연결 영역 번호 계산
+    void BuildOrdering(const AStar& map);
+
+private:
+    int _width = 0;
+    int _height = 0;
+    bool _allowDiagonal = true;
+    unsigned long long _checksum = 0;
+
+    std::vector<int> _ordinal;    // 셀 인덱스 -> 순서 번호 (벽은 -1)
+    std::vector<int> _component;  // 셀 인덱스 -> 연결 영역 번호 (벽은 -1)
+
+    // 출발지 순서 번호 s의 구간들: [_runOffsets[s], _runOffsets[s + 1])
+    // 구간 r은 순서 번호 _runStarts[r]부터 다음 구간 전까지 첫 이동이 _runMoves[r]
+    std::vector<unsigned int> _runOffsets;
+    std::vector<unsigned int> _runStarts;
+    std::vector<unsigned char> _runMoves;
+};
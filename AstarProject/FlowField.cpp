@@ -0,0 +1,242 @@
+﻿#include "MemoryPool.h"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <memory>
+#include "AStar.h"
+#include "ParallelFor.h"
+#include "FlowField.h"
+
+namespace
+{
+    const float INF = std::numeric_limits<float>::infinity();
+}
+
+void FlowField::Build(const AStar& map, const std::vector<Point>& goals, int threadCount)
+{
+    _width = map.GetMapWidth();
+    _height = map.GetMapHeight();
+    _tilesX = (_width + TILE_SIZE - 1) / TILE_SIZE;
+    _tilesY = (_height + TILE_SIZE - 1) / TILE_SIZE;
+    _roundCount = 0;
+    PreparePool(threadCount);
+
+    _dist.assign(_width * _height, INF);
+    _nextDist.assign(_width * _height, INF);
+    _direction.assign(_width * _height, (signed char)NO_DIRECTION);
+
+    // 1. 목적지 씨앗 심기 (맵 밖 / 벽 위의 목적지는 무시)
+    std::vector<char> active(_tilesX * _tilesY, 0);
+    for (const Point& goal : goals)
+    {
+        if (goal.x < 0 || goal.x >= _width || goal.y < 0 || goal.y >= _height) continue;
+        if (!map.IsWalkable(goal.x, goal.y)) continue;
+
+        int index = goal.y * _width + goal.x;
+        _dist[index] = 0.0f;
+        _nextDist[index] = 0.0f;
+        active[(goal.y / TILE_SIZE) * _tilesX + (goal.x / TILE_SIZE)] = 1;
+    }
+
+    // 2. 라운드 반복: 활성 타일 내부 Dijkstra -> 바뀐 타일의 이웃 활성화
+    std::vector<int> activeTiles;
+    std::vector<char> changed(_tilesX * _tilesY, 0);
+
+    for (;;)
+    {
+        activeTiles.clear();
+        for (int t = 0; t < (int)active.size(); ++t)
+        {
+            if (active[t]) activeTiles.push_back(t);
+        }
+        if (activeTiles.empty()) break;
+
+        ++_roundCount;
+        std::fill(changed.begin(), changed.end(), 0);
+
+        _pool->Run((int)activeTiles.size(), [&](int i, int worker)
+        {
+            // 힙 버퍼는 실행 스레드마다 하나씩 재사용
+            int tileIndex = activeTiles[i];
+            changed[tileIndex] = RelaxTile(map, tileIndex, _heaps[worker]) ? 1 : 0;
+        });
+
+        // 이번 라운드 결과 반영 + 다음 라운드 활성 타일 결정
+        std::fill(active.begin(), active.end(), 0);
+        for (int tileIndex : activeTiles)
+        {
+            if (!changed[tileIndex]) continue;
+
+            int tileX = tileIndex % _tilesX;
+            int tileY = tileIndex / _tilesX;
+            int x0 = tileX * TILE_SIZE;
+            int y0 = tileY * TILE_SIZE;
+            int x1 = std::min(x0 + TILE_SIZE, _width);
+            int y1 = std::min(y0 + TILE_SIZE, _height);
+
+            for (int y = y0; y < y1; ++y)
+            {
+                std::copy(_nextDist.begin() + y * _width + x0,
+                          _nextDist.begin() + y * _width + x1,
+                          _dist.begin() + y * _width + x0);
+            }
+
+            // 값이 바뀐 타일의 주변 8개 타일을 다시 검사
+            // (자기 자신은 이미 내부적으로 수렴했으므로 제외)
+            for (int ny = tileY - 1; ny <= tileY + 1; ++ny)
+            {
+                for (int nx = tileX - 1; nx <= tileX + 1; ++nx)
+                {
+                    if (nx < 0 || nx >= _tilesX || ny < 0 || ny >= _tilesY) continue;
+                    if (nx == tileX && ny == tileY) continue;
+                    active[ny * _tilesX + nx] = 1;
+                }
+            }
+        }
+    }
+
+    // 3. 거리장으로부터 방향장 계산
+    BuildDirections(map);
+}
+
+void FlowField::PreparePool(int threadCount)
+{
+    if (_pool && _poolRequest == threadCount) return;
+
+    _pool.reset(); // 이전 스레드를 먼저 정리
+    _pool = std::make_unique<WorkerPool>(threadCount);
+    _poolRequest = threadCount;
+    _heaps.resize(_pool->GetThreadCount());
+}
+
+bool FlowField::RelaxTile(const AStar& map, int tileIndex, std::vector<std::pair<float, int>>& heap)
+{
+    int tileX = tileIndex % _tilesX;
+    int tileY = tileIndex / _tilesX;
+    int x0 = tileX * TILE_SIZE;
+    int y0 = tileY * TILE_SIZE;
+    int x1 = std::min(x0 + TILE_SIZE, _width);
+    int y1 = std::min(y0 + TILE_SIZE, _height);
+
+    bool changed = false;
+    heap.clear();
+
+    // 1. 씨앗: 타일 내부의 기존 거리 + 타일 밖 이웃에서 들어오는 거리
+    //    (이동 규칙은 대칭이므로 c -> n 이 가능하면 n -> c 도 같은 비용으로 가능)
+    for (int y = y0; y < y1; ++y)
+    {
+        for (int x = x0; x < x1; ++x)
+        {
+            int index = y * _width + x;
+            float best = _dist[index];
+
+            bool onBorder = (x == x0 || x == x1 - 1 || y == y0 || y == y1 - 1);
+            if (onBorder)
+            {
+                unsigned int mask = map.GetMoveMask(x, y);
+                for (int i = 0; i < 8; ++i)
+                {
+                    if ((mask & (1u << i)) == 0) continue;
+                    int nextX = x + AStar::dx[i];
+                    int nextY = y + AStar::dy[i];
+                    if (nextX >= x0 && nextX < x1 && nextY >= y0 && nextY < y1) continue;
+
+                    float candidate = _dist[nextY * _width + nextX] + AStar::cost[i];
+                    if (candidate < best) best = candidate;
+                }
+            }
+
+            _nextDist[index] = best;
+            if (best < _dist[index]) changed = true;
+            if (best < INF) heap.push_back({ best, index });
+        }
+    }
+
+    std::make_heap(heap.begin(), heap.end(), DistEntryCompare());
+
+    // 2. 타일 내부 Dijkstra (Lazy Deletion)
+    while (!heap.empty())
+    {
+        std::pop_heap(heap.begin(), heap.end(), DistEntryCompare());
+        auto [d, index] = heap.back();
+        heap.pop_back();
+
+        if (d > _nextDist[index]) continue; // 이미 더 짧은 값으로 처리됨
+
+        int x = index % _width;
+        int y = index / _width;
+        unsigned int mask = map.GetMoveMask(x, y);
+        for (int i = 0; i < 8; ++i)
+        {
+            if ((mask & (1u << i)) == 0) continue;
+            int nextX = x + AStar::dx[i];
+            int nextY = y + AStar::dy[i];
+            if (nextX < x0 || nextX >= x1 || nextY < y0 || nextY >= y1) continue;
+
+            int nextIndex = nextY * _width + nextX;
+            float newDist = d + AStar::cost[i];
+            if (newDist < _nextDist[nextIndex])
+            {
+                _nextDist[nextIndex] = newDist;
+                changed = true;
+                heap.push_back({ newDist, nextIndex });
+                std::push_heap(heap.begin(), heap.end(), DistEntryCompare());
+            }
+        }
+    }
+
+    return changed;
+}
+
+void FlowField::BuildDirections(const AStar& map)
+{
+    // 행 단위로 나눠서 병렬 처리 (각 셀은 거리장을 읽기만 함)
+    _pool->Run(_height, [&](int y, int)
+    {
+        for (int x = 0; x < _width; ++x)
+        {
+            int index = y * _width + x;
+            if (_dist[index] == INF || _dist[index] == 0.0f) continue; // 도달 불가 / 목적지
+
+            // 이웃 거리 + 이동 비용이 가장 작은 방향이 다음 한 칸
+            float best = INF;
+            int bestDir = NO_DIRECTION;
+            unsigned int mask = map.GetMoveMask(x, y);
+            for (int i = 0; i < 8; ++i)
+            {
+                if ((mask & (1u << i)) == 0) continue;
+                int nextIndex = (y + AStar::dy[i]) * _width + (x + AStar::dx[i]);
+                float candidate = _dist[nextIndex] + AStar::cost[i];
+                if (candidate < best)
+                {
+                    best = candidate;
+                    bestDir = i;
+                }
+            }
+            _direction[index] = (signed char)bestDir;
+        }
+    });
+}
+
+float FlowField::GetDistance(int x, int y) const
+{
+    if (x < 0 || x >= _width || y < 0 || y >= _height) return INF;
+    return _dist[y * _width + x];
+}
+
+int FlowField::GetDirection(int x, int y) const
+{
+    if (x < 0 || x >= _width || y < 0 || y >= _height) return NO_DIRECTION;
+    return _direction[y * _width + x];
+}
+
+bool FlowField::GetNextStep(Point from, Point& next) const
+{
+    int dir = GetDirection(from.x, from.y);
+    if (dir == NO_DIRECTION) return false;
+
+    next = { from.x + AStar::dx[dir], from.y + AStar::dy[dir] };
+    return true;
+}
@@ -0,0 +1,71 @@
+﻿#pragma once
+
+// -----------------------------------------------------------
+// FlowField (다중 목적지 Dijkstra 맵)
+//
+// 하나 이상의 목적지로부터 맵 전체의 최단 거리와
+// 각 셀에서 다음에 이동할 방향을 한 번에 계산합니다.
+// 같은 목적지로 가는 에이전트가 많을 때, 에이전트마다 AStar를 돌리는 대신
+// Build 한 번 후 GetNextStep으로 O(1)에 다음 칸을 읽으면 됩니다.
+//
+// [병렬화]
+// 맵을 타일(TILE_SIZE x TILE_SIZE)로 나누고 라운드 단위로 처리합니다.
+// 각 라운드에서 활성 타일마다 (경계 바깥 이웃의 이전 라운드 거리를 씨앗으로)
+// 타일 내부 Dijkstra를 스레드별로 돌리고, 경계 값이 줄어든 타일의 이웃을
+// 다음 라운드에 활성화합니다. 더 이상 바뀌는 타일이 없으면 종료.
+// (한 라운드 안에서는 이전 라운드 값만 읽으므로 스레드 간 경쟁이 없음)
+// 스레드는 WorkerPool로 한 번만 만들어 모든 라운드 / 다음 Build까지 재사용합니다.
+// -----------------------------------------------------------
+class FlowField
+{
+public:
+    static constexpr int TILE_SIZE = 32;
+    static constexpr int NO_DIRECTION = -1;
+
+public:
+    FlowField() = default;
+
+    // goals로부터의 거리장 + 방향장 계산 (threadCount <= 0: 하드웨어 스레드 수)
+    // 맵의 벽/대각선 설정은 Build 시점의 AStar 상태를 사용합니다.
+    void Build(const AStar& map, const std::vector<Point>& goals, int threadCount = 0);
+
+    // 가장 가까운 목적지까지의 거리 (도달 불가 / 범위 밖이면 무한대)
+    float GetDistance(int x, int y) const;
+
+    // 다음 이동 방향 (AStar::dx/dy 인덱스, 목적지이거나 도달 불가면 NO_DIRECTION)
+    int GetDirection(int x, int y) const;
+
+    // from에서 한 칸 이동한 위치를 next에 기록. 더 이동할 곳이 없으면 false
+    bool GetNextStep(Point from, Point& next) const;
+
+    int GetWidth() const { return _width; }
+    int GetHeight() const { return _height; }
+
+    // 마지막 Build에 걸린 라운드 수 (튜닝/디버깅용)
+    int GetRoundCount() const { return _roundCount; }
+
+private:
+    // threadCount가 바뀌었거나 처음이면 풀을 새로 만듦
+    void PreparePool(int threadCount);
+
+    // 타일 하나의 내부 Dijkstra. 타일 내부 셀의 거리를 _nextDist에 기록하고
+    // 값이 바뀐 셀이 있으면 true 반환
+    bool RelaxTile(const AStar& map, int tileIndex, std::vector<std::pair<float, int>>& heap);
+
+    void BuildDirections(const AStar& map);
+
+private:
+    int _width = 0;
+    int _height = 0;
+    int _tilesX = 0;
+    int _tilesY = 0;
+    int _roundCount = 0;
+
+    std::vector<float> _dist;     // 이전 라운드까지 확정된 거리 (라운드 중 읽기 전용)
+    std::vector<float> _nextDist; // 이번 라운드 결과 (각 타일은 자기 셀만 씀)
+    std::vector<signed char> _direction;
+
+    std::unique_ptr<WorkerPool> _pool;
+    int _poolRequest = 0; // _pool을 만들 때 받은 threadCount
+    std::vector<std::vector<std::pair<float, int>>> _heaps; // 실행 스레드별 힙 버퍼 (Build 사이에도 유지)
+};
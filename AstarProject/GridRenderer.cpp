@@ -0,0 +1,323 @@
+﻿#include "MemoryPool.h"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <fstream>
+#include <array>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include "AStar.h"
+#include "TripleBuffer.h"
+#include "BackgroundSearch.h"
+#include "GridRenderer.h"
+
+namespace
+{
+    const unsigned int COLOR_START = 0x00FF00;  // 초록
+    const unsigned int COLOR_END = 0xFF0000;    // 빨강
+    const unsigned int COLOR_GRID = 0x000000;   // 검정 격자선
+
+    // -------------------------------------------------------
+    // PNG 저장용 헬퍼 (zlib 없이 무압축 deflate 블록 사용)
+    // -------------------------------------------------------
+    // 함수 안 static 초기화는 한 번만, 스레드 안전하게 실행됨
+    const std::array<unsigned int, 256>& GetCrcTable()
+    {
+        static const std::array<unsigned int, 256> table = []()
+        {
+            std::array<unsigned int, 256> result{};
+            for (unsigned int n = 0; n < 256; ++n)
+            {
+                unsigned int c = n;
+                for (int k = 0; k < 8; ++k)
+                    c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+                result[n] = c;
+            }
+            return result;
+        }();
+        return table;
+    }
+
+    unsigned int Crc32(const unsigned char* data, size_t size, unsigned int crc = 0)
+    {
+        const std::array<unsigned int, 256>& table = GetCrcTable();
+
+        crc = ~crc;
+        for (size_t i = 0; i < size; ++i)
+            crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        return ~crc;
+    }
+
+    void PushBE32(std::vector<unsigned char>& out, unsigned int value)
+    {
+        out.push_back((unsigned char)(value >> 24));
+        out.push_back((unsigned char)(value >> 16));
+        out.push_back((unsigned char)(value >> 8));
+        out.push_back((unsigned char)value);
+    }
+
+    void WriteChunk(std::ofstream& file, const char* type, const std::vector<unsigned char>& data)
+    {
+        std::vector<unsigned char> chunk;
+        PushBE32(chunk, (unsigned int)data.size());
+        chunk.insert(chunk.end(), type, type + 4);
+        chunk.insert(chunk.end(), data.begin(), data.end());
+
+        // CRC는 타입 + 데이터 구간
+        unsigned int crc = Crc32(chunk.data() + 4, chunk.size() - 4);
+        PushBE32(chunk, crc);
+        file.write((const char*)chunk.data(), chunk.size());
+    }
+}
+
+GridRenderer::GridRenderer(int cellPixels, bool drawGrid)
+    : _cellPixels(cellPixels < 1 ? 1 : cellPixels)
+    , _drawGrid(drawGrid && cellPixels >= 3)
+{
+}
+
+unsigned int GridRenderer::GetColor(AStar::NodeType type)
+{
+    switch (type)
+    {
+    case AStar::NodeType::WALL:   return 0x323232;
+    case AStar::NodeType::CLOSED: return 0xC8C8FF;
+    case AStar::NodeType::OPEN:   return 0xC8FFC8;
+    case AStar::NodeType::PATH:   return 0xFFEB96;
+    case AStar::NodeType::START:  return COLOR_START;
+    case AStar::NodeType::END:    return COLOR_END;
+    default:                      return 0xF0F0F0;
+    }
+}
+
+void GridRenderer::SetMarkers(Point start, Point end)
+{
+    if (start != _start)
+    {
+        _markerDirty.push_back(_start);
+        _markerDirty.push_back(start);
+        _start = start;
+    }
+    if (end != _end)
+    {
+        _markerDirty.push_back(_end);
+        _markerDirty.push_back(end);
+        _end = end;
+    }
+}
+
+int GridRenderer::Update(AStar& map)
+{
+    // 맵 크기가 바뀌면 버퍼 재할당 + 전체 다시 그리기
+    if (map.GetMapWidth() != _gridWidth || map.GetMapHeight() != _gridHeight)
+    {
+        _gridWidth = map.GetMapWidth();
+        _gridHeight = map.GetMapHeight();
+        _pixels.assign((size_t)GetPixelWidth() * GetPixelHeight(), 0);
+        _fullRedraw = true;
+    }
+
+    // 직전에 프레임을 그렸다면 맵의 바뀐 셀 목록과는 기준이 다르므로 전체
+    bool full = map.TakeDirtyCells(_dirtyCells) || _fullRedraw || !_drawnTypes.empty();
+    _fullRedraw = false;
+    _drawnTypes.clear();
+
+    int drawn = 0;
+    if (full)
+    {
+        for (int y = 0; y < _gridHeight; ++y)
+            for (int x = 0; x < _gridWidth; ++x)
+                DrawCell(x, y, map.GetCellType(x, y));
+        drawn = _gridWidth * _gridHeight;
+    }
+    else
+    {
+        for (int index : _dirtyCells)
+            DrawCell(index % _gridWidth, index / _gridWidth, map.GetCellType(index % _gridWidth, index / _gridWidth));
+        drawn = (int)_dirtyCells.size();
+
+        for (const Point& p : _markerDirty)
+        {
+            if (p.x < 0 || p.x >= _gridWidth || p.y < 0 || p.y >= _gridHeight) continue;
+            DrawCell(p.x, p.y, map.GetCellType(p.x, p.y));
+            ++drawn;
+        }
+    }
+    _markerDirty.clear();
+    return drawn;
+}
+
+int GridRenderer::Update(const SearchFrame& frame)
+{
+    if (frame.width != _gridWidth || frame.height != _gridHeight)
+    {
+        _gridWidth = frame.width;
+        _gridHeight = frame.height;
+        _pixels.assign((size_t)GetPixelWidth() * GetPixelHeight(), 0);
+        _fullRedraw = true;
+    }
+
+    // 프레임에는 바뀐 셀 목록이 없으므로 직전에 그린 상태와 비교
+    size_t cellCount = (size_t)_gridWidth * _gridHeight;
+    bool full = _fullRedraw || _drawnTypes.size() != cellCount;
+    _fullRedraw = false;
+    if (full) _drawnTypes.assign(frame.cellTypes.begin(), frame.cellTypes.end());
+
+    int drawn = 0;
+    for (size_t index = 0; index < cellCount; ++index)
+    {
+        unsigned char type = frame.cellTypes[index];
+        if (!full && _drawnTypes[index] == type) continue;
+
+        _drawnTypes[index] = type;
+        DrawCell((int)(index % _gridWidth), (int)(index / _gridWidth), (AStar::NodeType)type);
+        ++drawn;
+    }
+
+    if (!full)
+    {
+        for (const Point& p : _markerDirty)
+        {
+            if (p.x < 0 || p.x >= _gridWidth || p.y < 0 || p.y >= _gridHeight) continue;
+            DrawCell(p.x, p.y, frame.GetCellType(p.x, p.y));
+            ++drawn;
+        }
+    }
+    _markerDirty.clear();
+    return drawn;
+}
+
+void GridRenderer::DrawCell(int x, int y, AStar::NodeType type)
+{
+    unsigned int color;
+    if (x == _start.x && y == _start.y) color = COLOR_START;
+    else if (x == _end.x && y == _end.y) color = COLOR_END;
+    else color = GetColor(type);
+
+    int pixelWidth = GetPixelWidth();
+    unsigned int* row = &_pixels[(size_t)(y * _cellPixels) * pixelWidth + x * _cellPixels];
+
+    for (int py = 0; py < _cellPixels; ++py, row += pixelWidth)
+    {
+        std::fill(row, row + _cellPixels, color);
+        if (_drawGrid)
+        {
+            if (py == 0) std::fill(row, row + _cellPixels, COLOR_GRID);
+            else row[0] = COLOR_GRID;
+        }
+    }
+}
+
+bool GridRenderer::SavePPM(const char* path) const
+{
+    std::ofstream file(path, std::ios::binary);
+    if (!file) return false;
+
+    int width = GetPixelWidth();
+    int height = GetPixelHeight();
+    file << "P6\n" << width << " " << height << "\n255\n";
+
+    std::vector<unsigned char> row(width * 3);
+    for (int y = 0; y < height; ++y)
+    {
+        const unsigned int* src = &_pixels[(size_t)y * width];
+        for (int x = 0; x < width; ++x)
+        {
+            row[x * 3 + 0] = (unsigned char)(src[x] >> 16);
+            row[x * 3 + 1] = (unsigned char)(src[x] >> 8);
+            row[x * 3 + 2] = (unsigned char)src[x];
+        }
+        file.write((const char*)row.data(), row.size());
+    }
+
+    return file.good();
+}
+
+unsigned int GridRenderer::GetPixelChecksum() const
+{
+    // 행 단위로 RGB로 풀어서 이어서 계산
+    int width = GetPixelWidth();
+    std::vector<unsigned char> row(width * 3);
+    unsigned int crc = 0;
+    for (int y = 0; y < GetPixelHeight(); ++y)
+    {
+        const unsigned int* src = &_pixels[(size_t)y * width];
+        for (int x = 0; x < width; ++x)
+        {
+            row[x * 3 + 0] = (unsigned char)(src[x] >> 16);
+            row[x * 3 + 1] = (unsigned char)(src[x] >> 8);
+            row[x * 3 + 2] = (unsigned char)src[x];
+        }
+        crc = Crc32(row.data(), row.size(), crc);
+    }
+    return crc;
+}
+
+bool GridRenderer::SavePNG(const char* path) const
+{
+    int width = GetPixelWidth();
+    int height = GetPixelHeight();
+    if (width == 0 || height == 0) return false;
+
+    // 1. 원본 스캔라인 (필터 0 + RGB)
+    std::vector<unsigned char> raw;
+    raw.reserve((size_t)height * (width * 3 + 1));
+    for (int y = 0; y < height; ++y)
+    {
+        raw.push_back(0);
+        const unsigned int* src = &_pixels[(size_t)y * width];
+        for (int x = 0; x < width; ++x)
+        {
+            raw.push_back((unsigned char)(src[x] >> 16));
+            raw.push_back((unsigned char)(src[x] >> 8));
+            raw.push_back((unsigned char)src[x]);
+        }
+    }
+
+    // 2. zlib 스트림 (무압축 블록 최대 65535 바이트씩 + Adler-32)
+    std::vector<unsigned char> zlib = { 0x78, 0x01 };
+    size_t offset = 0;
+    do
+    {
+        size_t blockSize = std::min<size_t>(65535, raw.size() - offset);
+        bool last = (offset + blockSize == raw.size());
+        zlib.push_back(last ? 1 : 0);
+        zlib.push_back((unsigned char)blockSize);
+        zlib.push_back((unsigned char)(blockSize >> 8));
+        zlib.push_back((unsigned char)~blockSize);
+        zlib.push_back((unsigned char)(~blockSize >> 8));
+        zlib.insert(zlib.end(), raw.begin() + offset, raw.begin() + offset + blockSize);
+        offset += blockSize;
+    } while (offset < raw.size());
+
+    unsigned int a = 1, b = 0;
+    for (unsigned char c : raw)
+    {
+        a = (a + c) % 65521;
+        b = (b + a) % 65521;
+    }
+    PushBE32(zlib, (b << 16) | a);
+
+    // 3. 파일 쓰기
+    std::ofstream file(path, std::ios::binary);
+    if (!file) return false;
+
+    static const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    file.write((const char*)signature, sizeof(signature));
+
+    std::vector<unsigned char> header;
+    PushBE32(header, (unsigned int)width);
+    PushBE32(header, (unsigned int)height);
+    header.push_back(8); // 비트 깊이
+    header.push_back(2); // 컬러 타입: RGB
+    header.push_back(0); // 압축
+    header.push_back(0); // 필터
+    header.push_back(0); // 인터레이스 없음
+    WriteChunk(file, "IHDR", header);
+    WriteChunk(file, "IDAT", zlib);
+    WriteChunk(file, "IEND", {});
+
+    return file.good();
+}
@@ -0,0 +1,65 @@
+﻿#pragma once
+
+struct SearchFrame;
+
+// -----------------------------------------------------------
+// GridRenderer (플랫폼 독립 소프트웨어 렌더러)
+//
+// AStar의 셀 표시 상태를 32비트 픽셀 버퍼(0x00RRGGBB)에 그립니다.
+// 매 프레임 전체를 다시 그리지 않고, AStar::TakeDirtyCells로 받은
+// 바뀐 셀(+ 시작/도착 마커가 옮겨진 셀)만 다시 칠합니다.
+// (맵 쪽에서 SetDirtyTrackingEnabled(true)를 켜둬야 하며, 꺼져 있으면 매번 전체를 그림)
+//
+// - Win32 프런트엔드: GetPixels()를 32bpp DIB로 그대로 StretchDIBits
+// - 헤드리스(Linux 등): SavePPM / SavePNG로 프레임 덤프
+// -----------------------------------------------------------
+class GridRenderer
+{
+public:
+    // cellPixels: 셀 하나의 한 변 픽셀 수
+    // drawGrid: 셀 왼쪽/위쪽에 1픽셀 격자선을 그릴지 (cellPixels >= 3일 때만 적용)
+    explicit GridRenderer(int cellPixels = 1, bool drawGrid = false);
+
+    // 시작/도착 위치 표시 (바뀌면 이전/새 위치 셀을 다시 그림)
+    void SetMarkers(Point start, Point end);
+
+    // 바뀐 셀만 다시 그림. 다시 그린 셀 수 반환
+    int Update(AStar& map);
+    // [추가] BackgroundSearch의 프레임으로 그림 (직전에 그린 셀 상태와 비교해서 달라진 셀만)
+    int Update(const SearchFrame& frame);
+
+    // 다음 Update에서 전체를 다시 그리도록 표시
+    void Invalidate() { _fullRedraw = true; }
+
+    const std::vector<unsigned int>& GetPixels() const { return _pixels; }
+    int GetPixelWidth() const { return _gridWidth * _cellPixels; }
+    int GetPixelHeight() const { return _gridHeight * _cellPixels; }
+    int GetCellPixels() const { return _cellPixels; }
+
+    // 현재 프레임 저장 (실패 시 false)
+    bool SavePPM(const char* path) const;
+    bool SavePNG(const char* path) const;
+    // 픽셀 버퍼의 CRC-32 (PPM 본문과 같은 RGB 바이트 순서). 헤드리스 비교용
+    unsigned int GetPixelChecksum() const;
+
+    // 셀 상태별 색상 (0x00RRGGBB)
+    static unsigned int GetColor(AStar::NodeType type);
+
+private:
+    void DrawCell(int x, int y, AStar::NodeType type);
+
+private:
+    int _cellPixels;
+    bool _drawGrid;
+    int _gridWidth = 0;
+    int _gridHeight = 0;
+    bool _fullRedraw = true;
+
+    Point _start{ -1, -1 };
+    Point _end{ -1, -1 };
+    std::vector<Point> _markerDirty; // 마커 이동으로 다시 그려야 할 셀
+
+    std::vector<unsigned int> _pixels;
+    std::vector<int> _dirtyCells; // TakeDirtyCells 수신용 (재사용)
+    std::vector<unsigned char> _drawnTypes; // 프레임으로 그릴 때 직전에 그린 셀 상태 (맵으로 그리면 비움)
+};
@@ -19,7 +19,9 @@
 ----------------------------------------------------------------*/
 #ifndef  __PROCADEMY_MEMORY_POOL__
 #define  __PROCADEMY_MEMORY_POOL__
+#ifdef _MSC_VER
 #include <new.h>
+#endif
 #include <iostream>
 #include <vector>
 #include <new>
@@ -0,0 +1,329 @@
+﻿#include "MemoryPool.h"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <limits>
+#include <bit>
+#include <random>
+#include "ParallelFor.h"
+#include "AStar.h"
+#include "ParallelAStar.h"
+
+namespace
+{
+    const float INF = std::numeric_limits<float>::infinity();
+}
+
+ParallelAStar::ParallelAStar(const AStar& map)
+    : _map(map)
+{
+    SetThreadCount(0);
+}
+
+ParallelAStar::~ParallelAStar()
+{
+    _pool.reset();
+    ClearInboxes();
+}
+
+void ParallelAStar::SetThreadCount(int threadCount)
+{
+    if (threadCount <= 0)
+    {
+        threadCount = (int)std::thread::hardware_concurrency();
+        if (threadCount <= 0) threadCount = 1;
+    }
+
+    if (_pool && _threadCount == threadCount) return;
+
+    _pool.reset();
+    ClearInboxes();
+    _threadCount = threadCount;
+    _workers.clear();
+    for (int t = 0; t < threadCount; ++t)
+    {
+        _workers.push_back(std::make_unique<Worker>());
+        _workers.back()->outbox.resize(threadCount);
+    }
+    _pool = std::make_unique<WorkerPool>(threadCount);
+}
+
+long long ParallelAStar::GetExpandedCount() const
+{
+    long long total = 0;
+    for (const auto& worker : _workers) total += worker->expanded;
+    return total;
+}
+
+long long ParallelAStar::GetBusiestExpandedCount() const
+{
+    long long busiest = 0;
+    for (const auto& worker : _workers) busiest = (std::max)(busiest, worker->expanded);
+    return busiest;
+}
+
+long long ParallelAStar::GetMessageCount() const
+{
+    long long total = 0;
+    for (const auto& worker : _workers) total += worker->sent;
+    return total;
+}
+
+void ParallelAStar::BuildZobrist(int width, int height)
+{
+    size_t blocksX = ((size_t)width >> HASH_SHIFT) + 1;
+    size_t blocksY = ((size_t)height >> HASH_SHIFT) + 1;
+    if (_zobristX.size() == blocksX && _zobristY.size() == blocksY) return;
+
+    // 고정 시드: 같은 맵이면 실행마다 같은 분배
+    std::mt19937 random(0x5A0B1u);
+    _zobristX.resize(blocksX);
+    _zobristY.resize(blocksY);
+    for (unsigned int& value : _zobristX) value = random();
+    for (unsigned int& value : _zobristY) value = random();
+}
+
+int ParallelAStar::GetOwner(int x, int y) const
+{
+    // 곱셈 후 상위 비트 -> 나머지 연산 없이 스레드 수 범위로 고르게
+    unsigned int hash = _zobristX[x >> HASH_SHIFT] ^ _zobristY[y >> HASH_SHIFT];
+    return (int)(((unsigned long long)hash * (unsigned int)_threadCount) >> 32);
+}
+
+float ParallelAStar::GetGlobalMinF() const
+{
+    float minF = INF;
+    for (const auto& worker : _workers)
+        minF = (std::min)(minF, worker->minF.load(std::memory_order_relaxed));
+    return minF;
+}
+
+float ParallelAStar::CalculateH(int x, int y) const
+{
+    return AStar::HeuristicDistance(_heuristicType, { x, y }, _end);
+}
+
+void ParallelAStar::ClearInboxes()
+{
+    for (auto& worker : _workers)
+    {
+        Batch* batch = worker->inbox.exchange(nullptr);
+        while (batch)
+        {
+            Batch* next = batch->next;
+            delete batch;
+            batch = next;
+        }
+    }
+}
+
+bool ParallelAStar::FindPath(Point start, Point end, std::vector<Point>& outPath)
+{
+    outPath.clear();
+    _pathCost = 0.0f;
+    for (auto& worker : _workers)
+    {
+        worker->openList.clear();
+        worker->minF.store(INF, std::memory_order_relaxed);
+        worker->expanded = 0;
+        worker->sent = 0;
+    }
+
+    int width = _map.GetMapWidth();
+    int height = _map.GetMapHeight();
+    if (start.x < 0 || start.x >= width || start.y < 0 || start.y >= height) return false;
+    if (end.x < 0 || end.x >= width || end.y < 0 || end.y >= height) return false;
+    if (!_map.IsWalkable(start.x, start.y) || !_map.IsWalkable(end.x, end.y)) return false;
+
+    // 1. 셀 버퍼 준비 (세대 번호로 무효화)
+    size_t cellCount = (size_t)width * height;
+    if (_g.size() != cellCount)
+    {
+        _g.assign(cellCount, INF);
+        _parent.assign(cellCount, -1);
+        _visitStamp.assign(cellCount, 0);
+        _generation = 0;
+    }
+    if (++_generation == 0)
+    {
+        std::fill(_visitStamp.begin(), _visitStamp.end(), 0);
+        _generation = 1;
+    }
+
+    _width = width;
+    _end = end;
+    _endIndex = end.y * width + end.x;
+    _heuristicType = AStar::GetConsistentHeuristic(_map.GetAllowDiagonal());
+    _incumbent.store(INF);
+    BuildZobrist(width, height);
+
+    // 2. 시작 노드는 주인 스레드의 열린 목록에 넣어둠 (아직 다른 스레드가 없음)
+    int startIndex = start.y * width + start.x;
+    Relax(*_workers[GetOwner(start.x, start.y)], startIndex, -1, 0.0f);
+
+    // 3. 모든 스레드가 일하는 상태로 시작. 할 일이 없는 스레드는 바로 빠짐
+    //    RunWorker는 전체가 끝날 때까지 돌아오지 않으므로 풀의 스레드 하나가 정확히 번호 하나씩 맡음
+    _work.store(_threadCount);
+    _pool->Run(_threadCount, [this](int id, int) { RunWorker(id); });
+
+    // 4. 경로 복원 (모든 스레드가 끝났으므로 셀 상태를 그냥 읽어도 됨)
+    //    부모의 g가 나중에 더 줄었더라도 부모 쪽으로 갈수록 g가 줄어드므로 순환은 없음
+    if (_visitStamp[_endIndex] != _generation) return false;
+
+    _pathCost = _g[_endIndex];
+    size_t length = 0;
+    for (int trace = _endIndex; trace != -1; trace = _parent[trace]) ++length;
+    outPath.resize(length);
+    for (int trace = _endIndex; trace != -1; trace = _parent[trace])
+        outPath[--length] = { trace % width, trace / width };
+    return true;
+}
+
+void ParallelAStar::Relax(Worker& worker, int index, int parent, float g)
+{
+    if (_visitStamp[index] == _generation && g >= _g[index]) return;
+
+    _visitStamp[index] = _generation;
+    _g[index] = g;
+    _parent[index] = parent;
+
+    // 목적지는 펼칠 필요 없이 최선 해만 갱신
+    if (index == _endIndex)
+    {
+        float best = _incumbent.load(std::memory_order_relaxed);
+        while (g < best && !_incumbent.compare_exchange_weak(best, g, std::memory_order_relaxed)) {}
+        return;
+    }
+
+    float h = CalculateH(index % _width, index / _width);
+    if (g + h >= _incumbent.load(std::memory_order_relaxed)) return;
+
+    worker.openList.push_back({ g + h, h, g, index });
+    std::push_heap(worker.openList.begin(), worker.openList.end(), OpenEntryCompare());
+}
+
+void ParallelAStar::Flush(Worker& worker, int target)
+{
+    std::vector<Message>& pending = worker.outbox[target];
+    if (pending.empty()) return;
+
+    worker.sent += (long long)pending.size();
+    Batch* batch = new Batch{ nullptr, std::move(pending) };
+    pending.clear();
+    pending.reserve(BATCH_SIZE);
+
+    // 받는 쪽이 가져가기 전까지는 아직 끝나면 안 되므로 먼저 세고 보냄
+    _work.fetch_add(1);
+    std::atomic<Batch*>& inbox = _workers[target]->inbox;
+    batch->next = inbox.load(std::memory_order_relaxed);
+    while (!inbox.compare_exchange_weak(batch->next, batch, std::memory_order_release, std::memory_order_relaxed)) {}
+}
+
+void ParallelAStar::RunWorker(int id)
+{
+    Worker& worker = *_workers[id];
+    bool active = true;
+
+    for (;;)
+    {
+        // 1. 받은 묶음 처리 (일 없던 스레드는 먼저 일하는 상태로 바꾸고 나서 묶음 수를 뺌)
+        Batch* received = worker.inbox.exchange(nullptr, std::memory_order_acquire);
+        if (received)
+        {
+            if (!active)
+            {
+                _work.fetch_add(1);
+                active = true;
+            }
+
+            long long batchCount = 0;
+            while (received)
+            {
+                for (const Message& message : received->messages)
+                    Relax(worker, message.index, message.parent, message.g);
+
+                Batch* next = received->next;
+                delete received;
+                received = next;
+                ++batchCount;
+            }
+            _work.fetch_sub(batchCount);
+        }
+
+        // 2. 조금씩 확장 (사이사이 수신함을 확인해야 더 좋은 g가 빨리 반영됨)
+        //    맨 앞 f를 게시하고, 공유 최소 f보다 한참 큰 노드는 다른 스레드가 따라올 때까지 미룸
+        worker.minF.store(worker.openList.empty() ? INF : worker.openList.front().f, std::memory_order_relaxed);
+        float bound = _incumbent.load(std::memory_order_relaxed);
+        float limit = GetGlobalMinF() + THROTTLE_SLACK;
+        bool throttled = false;
+        for (int step = 0; step < FLUSH_INTERVAL && !worker.openList.empty(); ++step)
+        {
+            if (worker.openList.front().f > limit)
+            {
+                throttled = true;
+                break;
+            }
+
+            std::pop_heap(worker.openList.begin(), worker.openList.end(), OpenEntryCompare());
+            OpenEntry entry = worker.openList.back();
+            worker.openList.pop_back();
+
+            if (entry.g > _g[entry.index]) continue; // 더 좋은 g로 다시 들어온 낡은 항목
+            if (entry.f >= bound)
+            {
+                worker.openList.clear(); // 남은 것도 전부 최선 해보다 나쁨
+                break;
+            }
+            ++worker.expanded;
+
+            int x = entry.index % _width;
+            int y = entry.index / _width;
+            unsigned int mask = _map.GetMoveMask(x, y);
+            while (mask != 0)
+            {
+                int i = std::countr_zero(mask);
+                mask &= mask - 1;
+
+                int nextX = x + AStar::dx[i];
+                int nextY = y + AStar::dy[i];
+                int nextIndex = nextY * _width + nextX;
+                float newG = entry.g + AStar::cost[i];
+
+                int owner = GetOwner(nextX, nextY);
+                if (owner == id)
+                {
+                    Relax(worker, nextIndex, entry.index, newG);
+                    continue;
+                }
+
+                worker.outbox[owner].push_back({ nextIndex, entry.index, newG });
+                if ((int)worker.outbox[owner].size() >= BATCH_SIZE)
+                    Flush(worker, owner);
+            }
+        }
+
+        // 3. 모인 메시지는 쉬기 전에 모두 보냄
+        for (int target = 0; target < _threadCount; ++target)
+            Flush(worker, target);
+
+        if (!worker.openList.empty())
+        {
+            if (throttled) std::this_thread::yield();
+            continue;
+        }
+
+        // 4. 할 일 없음: 쉬는 상태로 바꾸고 전체가 끝났는지 확인
+        worker.minF.store(INF, std::memory_order_relaxed);
+        if (active)
+        {
+            _work.fetch_sub(1);
+            active = false;
+        }
+        if (_work.load() == 0) break;
+        std::this_thread::yield();
+    }
+}
@@ -0,0 +1,121 @@
+﻿#pragma once
+
+// -----------------------------------------------------------
+// ParallelAStar (해시 분배 병렬 A*, HDA*)
+//
+// 아주 큰 맵에서 쿼리 하나가 한 코어로 수백 ms 걸릴 때, 그 쿼리 하나를 여러 스레드로 나눠 풉니다.
+// - 셀마다 주인 스레드가 정해져 있음 (HASH_SHIFT 크기 블록 좌표의 Zobrist 해시). g / parent는 주인만 쓰고, 열린 목록도 스레드마다 따로
+//   Zobrist: 블록 x / y마다 난수를 하나씩 두고 XOR. 블록이 작아 탐색 앞쪽이 어디에 있든 모든 스레드에 고르게 나뉨
+//   (32x32처럼 큰 블록이면 앞쪽이 한두 블록에 걸려 그 주인만 바쁨)
+// - 이웃을 만들 때 주인이 다른 스레드면 (셀, g, 부모)를 모아서 그 스레드의 수신함으로 보냄
+//   수신함은 락 없는 단일 연결 리스트 (보낼 때 CAS로 앞에 붙이고, 받을 때 exchange로 통째로 가져옴)
+// - 전역 순서 없이 확장하므로 같은 셀이 더 나은 g로 다시 오면 다시 펼침
+//   목적지 g(현재 최선 해)보다 f가 크거나 같은 노드는 버림
+// - 공유 최소 f: 스레드마다 열린 목록 맨 앞 f를 게시하고, 그 최소값 + THROTTLE_SLACK보다 f가 큰 노드는 펼치지 않고 기다림
+//   (다른 스레드에서 더 좋은 g가 오기 전에 먼저 펼쳐버려 재확장이 되는 헛일을 줄임)
+//   최소값을 게시한 스레드 자신은 항상 펼칠 수 있으므로 멈추지 않음
+// - 스레드는 WorkerPool로 SetThreadCount에서 한 번만 만들고 FindPath마다 재사용
+// - 종료: _work = 일하는 스레드 수 + 아직 받지 않은 묶음 수. 0이 되면 더 생길 일이 없으므로 끝
+//   (일 없는 스레드는 묶음을 받아야만 다시 일하고, 묶음은 일하는 스레드만 보냄)
+//   이때 f < 최선 해인 노드가 어디에도 남지 않았으므로 최선 해가 최적
+//
+// 휴리스틱은 항상 허용(admissible)되는 것을 씀: 대각선 허용이면 옥타일, 아니면 맨해튼
+// 탐색 중에는 맵을 고치면 안 됩니다. (맵의 이동 마스크를 여러 스레드가 읽음)
+// -----------------------------------------------------------
+class ParallelAStar
+{
+public:
+    static constexpr int HASH_SHIFT = 3;          // 주인을 정하는 블록 크기 (8x8). 작을수록 고르게 나뉘지만 보내는 양이 늘어남
+    static constexpr float THROTTLE_SLACK = 1.0f; // 공유 최소 f보다 이만큼(직선 한 칸)까지 큰 노드는 바로 펼침. 클수록 재확장이 늘어남
+    static constexpr int BATCH_SIZE = 64;         // 한 스레드로 가는 메시지가 이만큼 모이면 바로 보냄
+    static constexpr int FLUSH_INTERVAL = 32;     // 이만큼 확장할 때마다 모인 메시지를 모두 보냄
+
+public:
+    explicit ParallelAStar(const AStar& map);
+    ~ParallelAStar();
+
+    // threadCount <= 0 이면 하드웨어 스레드 수. 호출한 스레드도 하나로 참여 (나머지 스레드를 여기서 만들어 둠)
+    void SetThreadCount(int threadCount);
+    int GetThreadCount() const { return _threadCount; }
+
+    // 경로를 찾으면 outPath에 시작 -> 끝 순서로 채우고 true
+    bool FindPath(Point start, Point end, std::vector<Point>& outPath);
+
+    // 마지막 쿼리 통계
+    float GetPathCost() const { return _pathCost; }
+    long long GetExpandedCount() const;                                      // 재확장 포함
+    long long GetMessageCount() const;                                       // 다른 스레드로 보낸 노드 수
+    long long GetExpandedCount(int thread) const { return _workers[thread]->expanded; } // 부하 분산 확인용
+    long long GetBusiestExpandedCount() const;                               // 가장 많이 확장한 스레드 (병렬 실행 시간을 정함)
+
+private:
+    struct Message
+    {
+        int index;
+        int parent;
+        float g;
+    };
+
+    struct Batch
+    {
+        Batch* next;
+        std::vector<Message> messages;
+    };
+
+    struct OpenEntry
+    {
+        float f;
+        float h;
+        float g;
+        int index;
+    };
+
+    // 스레드 하나의 상태 (수신함은 다른 스레드가 건드리므로 캐시 라인을 따로 씀)
+    struct alignas(64) Worker
+    {
+        std::atomic<Batch*> inbox{ nullptr };
+        std::atomic<float> minF{ 0.0f };          // 게시한 열린 목록 맨 앞 f (비었으면 무한대)
+        alignas(64) std::vector<OpenEntry> openList;
+        std::vector<std::vector<Message>> outbox; // 보낼 스레드별로 모으는 중인 메시지
+        long long expanded = 0;
+        long long sent = 0;
+    };
+
+    int GetOwner(int x, int y) const;
+    float CalculateH(int x, int y) const;
+
+    void BuildZobrist(int width, int height);
+    float GetGlobalMinF() const;
+
+    void RunWorker(int id);
+    // index 셀에 g로 도착 (주인 스레드에서만 호출)
+    void Relax(Worker& worker, int index, int parent, float g);
+    void Flush(Worker& worker, int target);
+    void ClearInboxes();
+
+private:
+    const AStar& _map;
+    int _threadCount = 1;
+    std::vector<std::unique_ptr<Worker>> _workers;
+    std::unique_ptr<WorkerPool> _pool; // _workers보다 뒤에 선언 (먼저 정리되도록)
+
+    // 블록 x / y별 난수 (맵 크기가 바뀔 때만 다시 만듦)
+    std::vector<unsigned int> _zobristX;
+    std::vector<unsigned int> _zobristY;
+
+    // 셀별 탐색 상태 (각 칸은 주인 스레드만 씀)
+    std::vector<float> _g;
+    std::vector<int> _parent;
+    std::vector<unsigned int> _visitStamp;
+    unsigned int _generation = 0;
+
+    // 이번 쿼리
+    int _width = 0;
+    Point _end{ -1, -1 };
+    int _endIndex = -1;
+    AStar::HeuristicType _heuristicType = AStar::HeuristicType::OCTILE; // 대각선 허용이면 옥타일, 아니면 맨해튼
+    std::atomic<float> _incumbent{ 0.0f }; // 지금까지 찾은 목적지 g 중 최소
+    std::atomic<long long> _work{ 0 };
+
+    float _pathCost = 0.0f;
+};
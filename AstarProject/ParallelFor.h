@@ -0,0 +1,174 @@
+﻿#pragma once
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+// -----------------------------------------------------------
+// ParallelFor
+// [0, count) 범위의 작업을 여러 스레드가 하나씩 가져가며 처리합니다.
+// (작업 크기가 들쭉날쭉해도 원자 카운터로 나눠 가지므로 부하가 고르게 분산됨)
+//
+// threadCount <= 0 이면 하드웨어 스레드 수를 사용합니다.
+// 호출한 스레드도 작업에 참여하며, 모든 작업이 끝나야 반환됩니다.
+// -----------------------------------------------------------
+template <typename Func>
+void ParallelFor(int count, int threadCount, Func&& func)
+{
+    if (count <= 0) return;
+
+    if (threadCount <= 0)
+    {
+        threadCount = (int)std::thread::hardware_concurrency();
+        if (threadCount <= 0) threadCount = 1;
+    }
+    if (threadCount > count) threadCount = count;
+
+    // 스레드 하나면 그냥 순서대로 처리
+    if (threadCount == 1)
+    {
+        for (int i = 0; i < count; ++i) func(i);
+        return;
+    }
+
+    std::atomic<int> next{ 0 };
+    auto worker = [&]()
+    {
+        for (;;)
+        {
+            int i = next.fetch_add(1, std::memory_order_relaxed);
+            if (i >= count) break;
+            func(i);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+    for (int t = 0; t < threadCount - 1; ++t)
+        threads.emplace_back(worker);
+
+    worker();
+
+    for (std::thread& th : threads)
+        th.join();
+}
+
+// -----------------------------------------------------------
+// WorkerPool
+// ParallelFor와 같은 방식으로 나눠 처리하지만 스레드를 한 번만 만들어 두고 Run마다 재사용합니다.
+// FlowField처럼 짧은 라운드를 여러 번 도는 작업은 라운드마다 스레드를 만들고 join하는 비용이 큼
+//
+// func(i, worker): worker는 [0, GetThreadCount()) 범위의 실행 스레드 번호 (호출 스레드 = 0)
+// 스레드별 작업 버퍼를 worker 번호로 골라 쓰면 Run 사이에도 그대로 재사용됩니다.
+// Run은 한 번에 한 스레드에서만 부를 수 있습니다.
+// -----------------------------------------------------------
+class WorkerPool
+{
+public:
+    explicit WorkerPool(int threadCount = 0)
+    {
+        if (threadCount <= 0)
+        {
+            threadCount = (int)std::thread::hardware_concurrency();
+            if (threadCount <= 0) threadCount = 1;
+        }
+        _threadCount = threadCount;
+
+        for (int worker = 1; worker < threadCount; ++worker)
+            _threads.emplace_back([this, worker]() { WorkerMain(worker); });
+    }
+
+    ~WorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _wake.notify_all();
+        for (std::thread& thread : _threads)
+            thread.join();
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    int GetThreadCount() const { return _threadCount; }
+
+    template <typename Func>
+    void Run(int count, Func&& func)
+    {
+        if (count <= 0) return;
+
+        // 스레드 하나 / 작업 하나면 깨우지 않고 바로 처리
+        if (_threads.empty() || count == 1)
+        {
+            for (int i = 0; i < count; ++i) func(i, 0);
+            return;
+        }
+
+        // 작업 등록은 잠금 안에서 (깨어난 스레드는 같은 잠금을 거쳐 읽으므로 순서 보장)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _job = [&func](int i, int worker) { func(i, worker); };
+            _count = count;
+            _next.store(0, std::memory_order_relaxed);
+            _pending = (int)_threads.size();
+            ++_generation;
+        }
+        _wake.notify_all();
+
+        Execute(0);
+
+        // 모든 스레드가 이번 작업을 끝내야 반환 (다음 Run이 이전 작업을 덮어쓰지 않게)
+        std::unique_lock<std::mutex> lock(_mutex);
+        _done.wait(lock, [this]() { return _pending == 0; });
+        _job = nullptr;
+    }
+
+private:
+    void Execute(int worker)
+    {
+        for (;;)
+        {
+            int i = _next.fetch_add(1, std::memory_order_relaxed);
+            if (i >= _count) break;
+            _job(i, worker);
+        }
+    }
+
+    void WorkerMain(int worker)
+    {
+        unsigned long long seen = 0;
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _wake.wait(lock, [&]() { return _stop || _generation != seen; });
+                if (_stop) return;
+                seen = _generation;
+            }
+
+            Execute(worker);
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (--_pending == 0) _done.notify_one();
+        }
+    }
+
+private:
+    int _threadCount = 1;
+    std::vector<std::thread> _threads;
+
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::condition_variable _done;
+    bool _stop = false;
+    unsigned long long _generation = 0;
+    int _pending = 0;
+
+    std::function<void(int, int)> _job;
+    int _count = 0;
+    std::atomic<int> _next{ 0 };
+};
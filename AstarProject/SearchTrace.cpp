@@ -0,0 +1,270 @@
+﻿#include "MemoryPool.h"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <fstream>
+#include <iterator>
+#include "AStar.h"
+#include "SearchTrace.h"
+
+namespace
+{
+    const char TRACE_MAGIC[4] = { 'A', 'S', 'T', 'R' };
+    const unsigned char TRACE_VERSION = 1;
+
+    // [추가] 헤더를 믿고 할당하지 않도록 상한 (셀 상태 1바이트씩 = 최대 256MB)
+    const unsigned long long TRACE_MAX_CELLS = 1ull << 28;
+
+    void PutVarint(std::vector<unsigned char>& out, unsigned long long value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back((unsigned char)(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back((unsigned char)value);
+    }
+
+    bool GetVarint(const std::vector<unsigned char>& in, size_t& cursor, unsigned long long& value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            if (cursor >= in.size()) return false;
+            unsigned char byte = in[cursor++];
+            value |= (unsigned long long)(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) return true;
+        }
+        return false;
+    }
+
+    long long UnZigZag(unsigned long long value)
+    {
+        return (long long)(value >> 1) ^ -(long long)(value & 1);
+    }
+}
+
+// -----------------------------------------------------------
+// SearchTraceRecorder
+// -----------------------------------------------------------
+void SearchTraceRecorder::Begin(int width, int height, Point start, Point end)
+{
+    _width = width;
+    _height = height;
+    _start = start;
+    _end = end;
+    _lastExpand = start.y * width + start.x;
+    _eventCount = 0;
+    _data.clear();
+}
+
+bool SearchTraceRecorder::Save(const char* path) const
+{
+    std::ofstream file(path, std::ios::binary);
+    if (!file) return false;
+
+    std::vector<unsigned char> header(TRACE_MAGIC, TRACE_MAGIC + 4);
+    header.push_back(TRACE_VERSION);
+    PutVarint(header, (unsigned long long)_width);
+    PutVarint(header, (unsigned long long)_height);
+    PutVarint(header, (unsigned long long)_start.x);
+    PutVarint(header, (unsigned long long)_start.y);
+    PutVarint(header, (unsigned long long)_end.x);
+    PutVarint(header, (unsigned long long)_end.y);
+    PutVarint(header, _eventCount);
+    PutVarint(header, _data.size());
+
+    file.write((const char*)header.data(), header.size());
+    file.write((const char*)_data.data(), _data.size());
+    return file.good();
+}
+
+// -----------------------------------------------------------
+// SearchTraceReplay
+// -----------------------------------------------------------
+bool SearchTraceReplay::Load(const char* path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+
+    std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (bytes.size() < 5 || !std::equal(TRACE_MAGIC, TRACE_MAGIC + 4, bytes.begin())) return false;
+    if (bytes[4] != TRACE_VERSION) return false;
+
+    size_t cursor = 5;
+    unsigned long long fields[8];
+    for (unsigned long long& field : fields)
+    {
+        if (!GetVarint(bytes, cursor, field)) return false;
+    }
+    if (bytes.size() - cursor != fields[7]) return false;
+
+    // [추가] 크기 / 출발 / 도착이 격자 안인지 (손상되거나 조작된 파일로 범위 밖을 읽지 않도록)
+    unsigned long long width = fields[0], height = fields[1];
+    if (width == 0 || height == 0 || width > TRACE_MAX_CELLS || height > TRACE_MAX_CELLS) return false;
+    if (width * height > TRACE_MAX_CELLS) return false;
+    if (fields[2] >= width || fields[3] >= height || fields[4] >= width || fields[5] >= height) return false;
+
+    _width = (int)fields[0];
+    _height = (int)fields[1];
+    _start = { (int)fields[2], (int)fields[3] };
+    _end = { (int)fields[4], (int)fields[5] };
+    _eventCount = (size_t)fields[6];
+    _data.assign(bytes.begin() + cursor, bytes.end());
+
+    Reset();
+    return true;
+}
+
+void SearchTraceReplay::Reset()
+{
+    _cursor = 0;
+    _lastExpand = _start.y * _width + _start.x;
+    _expansions = 0;
+    _closedCount = 0;
+    _cellState.assign((size_t)_width * _height, (unsigned char)CellState::NONE);
+
+    // 시작 노드는 Begin 시점에 이미 Open
+    _cellState[_lastExpand] = (unsigned char)CellState::OPEN;
+    _openCount = 1;
+    _heapSize = 1;
+}
+
+bool SearchTraceReplay::Decode(size_t& cursor, int& lastExpand, SearchTraceRecorder::EventType& type, int& index) const
+{
+    unsigned long long value;
+    if (!GetVarint(_data, cursor, value)) return false;
+
+    // [수정] 범위 밖 방향 / 인덱스는 손상된 기록으로 보고 중단 (끝과 같이 false)
+    long long cellCount = (long long)_width * _height;
+    long long next;
+    type = (SearchTraceRecorder::EventType)(value & 3);
+    if (type == SearchTraceRecorder::EventType::EXPAND || type == SearchTraceRecorder::EventType::STALE_POP)
+    {
+        long long delta = UnZigZag(value >> 2);
+        if (delta < -cellCount || delta > cellCount) return false;
+        next = lastExpand + delta;
+    }
+    else
+    {
+        unsigned long long direction = value >> 2;
+        if (direction > 7) return false;
+        int x = lastExpand % _width + AStar::dx[direction];
+        if (x < 0 || x >= _width) return false;
+        next = lastExpand + (long long)AStar::dy[direction] * _width + AStar::dx[direction];
+    }
+    if (next < 0 || next >= cellCount) return false;
+
+    index = (int)next;
+    if (type == SearchTraceRecorder::EventType::EXPAND) lastExpand = index;
+    return true;
+}
+
+bool SearchTraceReplay::Step()
+{
+    SearchTraceRecorder::EventType type;
+    int index;
+    if (!Decode(_cursor, _lastExpand, type, index)) return false;
+
+    unsigned char& state = _cellState[index];
+    switch (type)
+    {
+    case SearchTraceRecorder::EventType::EXPAND:
+        if (_heapSize == 0) return false; // [추가] 빈 힙에서 꺼냄 -> 손상된 기록
+        --_heapSize;
+        if (state == (unsigned char)CellState::OPEN) --_openCount;
+        state = (unsigned char)CellState::CLOSED;
+        ++_closedCount;
+        ++_expansions;
+        break;
+    case SearchTraceRecorder::EventType::STALE_POP:
+        if (_heapSize == 0) return false;
+        --_heapSize;
+        break;
+    case SearchTraceRecorder::EventType::PUSH:
+        ++_heapSize;
+        state = (unsigned char)CellState::OPEN;
+        ++_openCount;
+        break;
+    case SearchTraceRecorder::EventType::DECREASE:
+        ++_heapSize; // Lazy Deletion이므로 중복 삽입
+        break;
+    }
+    return true;
+}
+
+void SearchTraceReplay::SeekToExpansion(size_t step)
+{
+    if (step < _expansions) Reset();
+
+    while (_expansions < step)
+    {
+        if (!Step()) break;
+    }
+}
+
+SearchTraceReplay::Summary SearchTraceReplay::Summarize(int tileSize, int sampleCount, int topK) const
+{
+    Summary summary;
+    if (tileSize < 1) tileSize = 1;
+    if (sampleCount < 1) sampleCount = 1;
+
+    int tilesX = (_width + tileSize - 1) / tileSize;
+    int tilesY = (_height + tileSize - 1) / tileSize;
+    std::vector<int> revisits((size_t)tilesX * tilesY, 0);
+
+    // 1차: 이벤트 종류별 개수 (샘플 간격을 정하기 위해 확장 수가 필요)
+    size_t cursor = 0;
+    int lastExpand = _start.y * _width + _start.x;
+    SearchTraceRecorder::EventType type;
+    int index;
+    while (Decode(cursor, lastExpand, type, index))
+    {
+        switch (type)
+        {
+        case SearchTraceRecorder::EventType::EXPAND: ++summary.expansions; break;
+        case SearchTraceRecorder::EventType::PUSH: ++summary.pushes; break;
+        case SearchTraceRecorder::EventType::DECREASE: ++summary.decreases; break;
+        case SearchTraceRecorder::EventType::STALE_POP: ++summary.stalePops; break;
+        }
+        if (type == SearchTraceRecorder::EventType::DECREASE || type == SearchTraceRecorder::EventType::STALE_POP)
+            ++revisits[(index / _width / tileSize) * tilesX + (index % _width) / tileSize];
+    }
+
+    // 2차: 힙 크기 변화
+    size_t interval = std::max<size_t>(1, (summary.expansions + sampleCount - 1) / sampleCount);
+    size_t heapSize = 1;
+    size_t expansions = 0;
+    summary.maxHeapSize = 1;
+    cursor = 0;
+    lastExpand = _start.y * _width + _start.x;
+    while (Decode(cursor, lastExpand, type, index))
+    {
+        if (type == SearchTraceRecorder::EventType::PUSH || type == SearchTraceRecorder::EventType::DECREASE)
+        {
+            ++heapSize;
+            summary.maxHeapSize = std::max(summary.maxHeapSize, heapSize);
+        }
+        else
+        {
+            if (heapSize == 0) break;
+            --heapSize;
+            if (type == SearchTraceRecorder::EventType::EXPAND && ++expansions % interval == 0)
+                summary.heapSamples.push_back(heapSize);
+        }
+    }
+
+    // 핫스팟: 재방문이 많은 타일 상위 topK
+    for (int t = 0; t < (int)revisits.size(); ++t)
+    {
+        if (revisits[t] > 0)
+            summary.hotspots.push_back({ t % tilesX, t / tilesX, revisits[t] });
+    }
+    std::sort(summary.hotspots.begin(), summary.hotspots.end(),
+        [](const Hotspot& a, const Hotspot& b) { return a.revisits > b.revisits; });
+    if ((int)summary.hotspots.size() > topK)
+        summary.hotspots.resize(topK);
+
+    return summary;
+}
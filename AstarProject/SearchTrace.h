@@ -0,0 +1,150 @@
+﻿#pragma once
+
+// -----------------------------------------------------------
+// SearchTrace (탐색 기록 / 오프라인 재생)
+//
+// AStar::SetTraceRecorder로 연결하면 UpdatePathFinding이 하는 일
+// (확장, 삽입, 비용 갱신, 이미 닫힌 노드 꺼냄)을 바이너리로 기록합니다.
+//
+// [인코딩] 이벤트 하나 = varint 하나 (하위 2비트 = 이벤트 종류)
+// - EXPAND / STALE_POP : 직전 확장 셀과의 인덱스 차이 (zigzag)
+// - PUSH / DECREASE    : 직전 확장 셀 기준 방향 (0~7) -> 항상 1바이트
+// 시작 노드 삽입은 Begin에 포함되어 따로 기록하지 않습니다.
+// -----------------------------------------------------------
+class SearchTraceRecorder
+{
+public:
+    enum class EventType : unsigned char { EXPAND, PUSH, DECREASE, STALE_POP };
+
+public:
+    // 새 탐색 기록 시작 (이전 기록은 지워짐)
+    void Begin(int width, int height, Point start, Point end);
+
+    void RecordExpand(int index)
+    {
+        WriteVarint((ZigZag(index - _lastExpand) << 2) | (unsigned long long)EventType::EXPAND);
+        _lastExpand = index;
+        ++_eventCount;
+    }
+    void RecordStalePop(int index)
+    {
+        WriteVarint((ZigZag(index - _lastExpand) << 2) | (unsigned long long)EventType::STALE_POP);
+        ++_eventCount;
+    }
+    void RecordPush(int direction)
+    {
+        _data.push_back((unsigned char)((direction << 2) | (int)EventType::PUSH));
+        ++_eventCount;
+    }
+    void RecordDecrease(int direction)
+    {
+        _data.push_back((unsigned char)((direction << 2) | (int)EventType::DECREASE));
+        ++_eventCount;
+    }
+
+    // 헤더 + 이벤트 바이트를 파일로 저장
+    bool Save(const char* path) const;
+
+    size_t GetEventCount() const { return _eventCount; }
+    size_t GetByteCount() const { return _data.size(); }
+
+private:
+    static unsigned long long ZigZag(long long value)
+    {
+        return ((unsigned long long)value << 1) ^ (unsigned long long)(value >> 63);
+    }
+
+    void WriteVarint(unsigned long long value)
+    {
+        while (value >= 0x80)
+        {
+            _data.push_back((unsigned char)(value | 0x80));
+            value >>= 7;
+        }
+        _data.push_back((unsigned char)value);
+    }
+
+private:
+    int _width = 0;
+    int _height = 0;
+    Point _start{ -1, -1 };
+    Point _end{ -1, -1 };
+
+    int _lastExpand = 0;
+    size_t _eventCount = 0;
+    std::vector<unsigned char> _data;
+};
+
+// -----------------------------------------------------------
+// SearchTraceReplay
+// 저장된 기록을 읽어 임의의 확장 단계에서의 Open/Closed 상태를 복원하고,
+// 힙 크기 변화 / 재방문이 몰린 영역(핫스팟)을 요약합니다.
+// -----------------------------------------------------------
+class SearchTraceReplay
+{
+public:
+    enum class CellState : unsigned char { NONE, OPEN, CLOSED };
+
+    struct Hotspot
+    {
+        int tileX;
+        int tileY;
+        int revisits; // DECREASE + STALE_POP 횟수
+    };
+
+    struct Summary
+    {
+        size_t expansions = 0;
+        size_t pushes = 0;
+        size_t decreases = 0;
+        size_t stalePops = 0;
+        size_t maxHeapSize = 0;
+        std::vector<size_t> heapSamples; // 일정 확장 간격마다의 힙 크기
+        std::vector<Hotspot> hotspots;   // 재방문이 많은 타일 순
+    };
+
+public:
+    // 헤더(크기 / 출발 / 도착)가 맞지 않으면 false
+    bool Load(const char* path);
+
+    int GetWidth() const { return _width; }
+    int GetHeight() const { return _height; }
+    Point GetStart() const { return _start; }
+    Point GetEnd() const { return _end; }
+    size_t GetEventCount() const { return _eventCount; }
+
+    // 확장 step번을 마친 직후 상태로 이동 (뒤로 가면 처음부터 다시 재생)
+    void SeekToExpansion(size_t step);
+    size_t GetExpansionCount() const { return _expansions; }
+
+    CellState GetCellState(int x, int y) const { return (CellState)_cellState[y * _width + x]; }
+    size_t GetOpenCount() const { return _openCount; }
+    size_t GetClosedCount() const { return _closedCount; }
+    size_t GetHeapSize() const { return _heapSize; }
+
+    // 전체 기록 요약 (현재 재생 위치와 무관)
+    Summary Summarize(int tileSize = 16, int sampleCount = 64, int topK = 10) const;
+
+private:
+    void Reset();
+    // 이벤트 하나 디코딩. 끝이거나 방향 / 인덱스가 격자 밖이면 false
+    bool Decode(size_t& cursor, int& lastExpand, SearchTraceRecorder::EventType& type, int& index) const;
+    bool Step();
+
+private:
+    int _width = 0;
+    int _height = 0;
+    Point _start{ -1, -1 };
+    Point _end{ -1, -1 };
+    size_t _eventCount = 0;
+    std::vector<unsigned char> _data;
+
+    // 재생 상태
+    size_t _cursor = 0;
+    int _lastExpand = 0;
+    size_t _expansions = 0;
+    size_t _openCount = 0;
+    size_t _closedCount = 0;
+    size_t _heapSize = 0;
+    std::vector<unsigned char> _cellState;
+};
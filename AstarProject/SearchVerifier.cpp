@@ -0,0 +1,224 @@
+﻿#include "MemoryPool.h"
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <fstream>
+#include <sstream>
+#include "AStar.h"
+#include "SearchVerifier.h"
+
+// -----------------------------------------------------------
+// ReferenceDijkstra
+// -----------------------------------------------------------
+bool ReferenceDijkstra::CanMove(const AStar& map, int x, int y, int stepX, int stepY, bool allowDiagonal)
+{
+    if (!map.IsWalkable(x + stepX, y + stepY)) return false;
+    if (stepX == 0 || stepY == 0) return true;
+    if (!allowDiagonal) return false;
+    return map.IsWalkable(x + stepX, y) || map.IsWalkable(x, y + stepY);
+}
+
+void ReferenceDijkstra::Run(const AStar& map, Point start, bool allowDiagonal)
+{
+    _width = map.GetMapWidth();
+    _height = map.GetMapHeight();
+    _cost.assign((size_t)_width * _height, -1.0);
+    _heap.clear();
+    if (!map.IsWalkable(start.x, start.y)) return;
+
+    // 확정된 칸은 _cost >= 0, 후보 비용은 힙에만 (같은 칸이 여러 번 들어갈 수 있음)
+    auto greater = std::greater<std::pair<double, int>>();
+    _heap.push_back({ 0.0, start.y * _width + start.x });
+
+    while (!_heap.empty())
+    {
+        std::pop_heap(_heap.begin(), _heap.end(), greater);
+        auto [cost, index] = _heap.back();
+        _heap.pop_back();
+        if (_cost[index] >= 0.0) continue;
+        _cost[index] = cost;
+
+        int x = index % _width;
+        int y = index / _width;
+        for (int stepY = -1; stepY <= 1; ++stepY)
+        {
+            for (int stepX = -1; stepX <= 1; ++stepX)
+            {
+                if (stepX == 0 && stepY == 0) continue;
+                if (!CanMove(map, x, y, stepX, stepY, allowDiagonal)) continue;
+
+                int next = (y + stepY) * _width + (x + stepX);
+                if (_cost[next] >= 0.0) continue;
+
+                double stepCost = (stepX != 0 && stepY != 0) ? AStar::cost[4] : AStar::cost[0];
+                _heap.push_back({ cost + stepCost, next });
+                std::push_heap(_heap.begin(), _heap.end(), greater);
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------
+// SearchVerifier
+// -----------------------------------------------------------
+const char* SearchVerifier::GetErrorName(PathError error)
+{
+    switch (error) {
+    case PathError::NONE: return "ok";
+    case PathError::MISSED: return "missed";
+    case PathError::PHANTOM: return "phantom";
+    case PathError::WRONG_ENDPOINT: return "wrong endpoint";
+    case PathError::NOT_ADJACENT: return "not adjacent";
+    case PathError::WALL: return "wall";
+    case PathError::CORNER_CUT: return "corner cut";
+    case PathError::SUBOPTIMAL: return "suboptimal";
+    }
+    return "?";
+}
+
+double SearchVerifier::GetCostBound(AStar::HeuristicType heuristic, bool allowDiagonal, float weight)
+{
+    double overestimate = 1.0;
+    if (allowDiagonal && heuristic == AStar::HeuristicType::MANHATTAN)
+        overestimate = 2.0 / AStar::cost[4];
+    else if (allowDiagonal && heuristic == AStar::HeuristicType::EUCLIDEAN)
+        overestimate = std::sqrt(2.0) / AStar::cost[4];
+
+    return (std::max)(1.0, (double)weight * overestimate);
+}
+
+double SearchVerifier::PathCost(const std::vector<Point>& path)
+{
+    double total = 0.0;
+    for (size_t i = 1; i < path.size(); ++i)
+        total += (path[i].x != path[i - 1].x && path[i].y != path[i - 1].y) ? AStar::cost[4] : AStar::cost[0];
+    return total;
+}
+
+SearchVerifier::PathError SearchVerifier::CheckPath(const AStar& map, const ReferenceDijkstra& reference, Point start, Point end,
+    bool found, const std::vector<Point>& path, bool allowDiagonal, double bound)
+{
+    // 1. 도달 가능 여부가 기준과 같은지
+    bool reachable = map.IsWalkable(end.x, end.y) && reference.IsReachable(end.x, end.y);
+    if (!found) return reachable ? PathError::MISSED : PathError::NONE;
+    if (!reachable) return PathError::PHANTOM;
+
+    // 2. 경로 모양
+    if (path.empty() || path.front().x != start.x || path.front().y != start.y ||
+        path.back().x != end.x || path.back().y != end.y)
+        return PathError::WRONG_ENDPOINT;
+
+    for (size_t i = 0; i < path.size(); ++i)
+    {
+        if (!map.IsWalkable(path[i].x, path[i].y)) return PathError::WALL;
+        if (i == 0) continue;
+
+        int stepX = path[i].x - path[i - 1].x;
+        int stepY = path[i].y - path[i - 1].y;
+        if (std::abs(stepX) > 1 || std::abs(stepY) > 1 || (stepX == 0 && stepY == 0))
+            return PathError::NOT_ADJACENT;
+        if (!ReferenceDijkstra::CanMove(map, path[i - 1].x, path[i - 1].y, stepX, stepY, allowDiagonal))
+            return PathError::CORNER_CUT;
+    }
+
+    // 3. 비용 (AStar는 g를 float로 누적하므로 길이에 비례한 오차 + 고정 여유)
+    double optimal = reference.GetCost(end.x, end.y);
+    double cost = PathCost(path);
+    if (cost > bound * optimal + optimal * 1e-5 + 0.01) return PathError::SUBOPTIMAL;
+
+    return PathError::NONE;
+}
+
+// -----------------------------------------------------------
+// SearchBaseline
+// -----------------------------------------------------------
+void SearchBaseline::Set(const std::string& name, long long expansions, double milliseconds)
+{
+    for (Entry& entry : _entries)
+    {
+        if (entry.name != name) continue;
+        entry.expansions = expansions;
+        entry.milliseconds = milliseconds;
+        return;
+    }
+    _entries.push_back({ name, expansions, milliseconds });
+}
+
+const SearchBaseline::Entry* SearchBaseline::Find(const std::string& name) const
+{
+    for (const Entry& entry : _entries)
+    {
+        if (entry.name == name) return &entry;
+    }
+    return nullptr;
+}
+
+bool SearchBaseline::Load(const char* path)
+{
+    std::ifstream file(path);
+    if (!file) return false;
+
+    _params.clear();
+    _entries.clear();
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#') continue;
+
+        if (line.compare(0, 7, "params ") == 0)
+        {
+            _params = line.substr(7);
+            continue;
+        }
+
+        // 밀리초가 없는 줄은 시간 0 (비교하지 않음)
+        std::istringstream fields(line);
+        Entry entry;
+        if (!(fields >> entry.name >> entry.expansions)) return false;
+        if (!(fields >> entry.milliseconds)) entry.milliseconds = 0.0;
+        _entries.push_back(entry);
+    }
+    return true;
+}
+
+bool SearchBaseline::Save(const char* path, bool withTimes) const
+{
+    std::ofstream file(path);
+    if (!file) return false;
+
+    file << (withTimes ? "# AstarTool verify baseline: <name> <expansions> <milliseconds>\n"
+                       : "# AstarTool verify baseline: <name> <expansions>\n");
+    file << "params " << _params << "\n";
+    for (const Entry& entry : _entries)
+    {
+        file << entry.name << " " << entry.expansions;
+        if (withTimes) file << " " << entry.milliseconds;
+        file << "\n";
+    }
+    return (bool)file;
+}
+
+std::vector<SearchBaseline::Regression> SearchBaseline::Compare(const SearchBaseline& current, double expansionTolerance,
+    double timeTolerance, double minTimeSlackMs) const
+{
+    std::vector<Regression> regressions;
+    for (const Entry& entry : current._entries)
+    {
+        const Entry* base = Find(entry.name);
+        if (base == nullptr) continue;
+
+        if (entry.expansions > base->expansions * (1.0 + expansionTolerance))
+            regressions.push_back({ entry.name, true, (double)base->expansions, (double)entry.expansions });
+
+        if (base->milliseconds <= 0.0) continue; // 시간이 없는 기준선
+
+        // 짧은 측정은 잡음이 비율로 크므로 절대 여유도 넘어야 함
+        double limit = (std::max)(base->milliseconds * (1.0 + timeTolerance), base->milliseconds + minTimeSlackMs);
+        if (entry.milliseconds > limit)
+            regressions.push_back({ entry.name, false, base->milliseconds, entry.milliseconds });
+    }
+    return regressions;
+}
@@ -0,0 +1,106 @@
+﻿#pragma once
+
+// -----------------------------------------------------------
+// SearchVerifier (탐색 결과 검증 / 성능 기준선)
+//
+// 빠른 탐색 모드(SIMD, 늪 건너뛰기, 트리 재사용, 가중치 등)가 늘어날수록
+// 결과가 맞는지 따로 확인할 기준이 필요합니다.
+// - ReferenceDijkstra: AStar의 이동 마스크를 쓰지 않고 IsWalkable만으로 같은 이동 규칙을 다시 구현한 다익스트라
+// - CheckPath: 경로 하나가 끝점 / 인접 / 벽 / 코너 규칙 / 비용 상한을 지키는지 검사
+// - GetCostBound: 휴리스틱 / 대각선 / 가중치 조합에서 보장되는 "경로 비용 <= bound * 최적 비용"
+// - SearchBaseline: 설정별 확장 수 / 시간을 텍스트 파일로 저장해 두고 이후 실행과 비교
+// -----------------------------------------------------------
+class ReferenceDijkstra
+{
+public:
+    // start에서 모든 칸까지의 최단 비용 (비용은 AStar::cost와 같음, 합은 double로)
+    void Run(const AStar& map, Point start, bool allowDiagonal);
+
+    bool IsReachable(int x, int y) const { return _cost[(size_t)y * _width + x] >= 0.0; }
+    double GetCost(int x, int y) const { return _cost[(size_t)y * _width + x]; } // 못 가면 -1
+
+    // 코너 규칙: 대각선은 양쪽 직선 칸이 모두 벽일 때만 막힘
+    static bool CanMove(const AStar& map, int x, int y, int stepX, int stepY, bool allowDiagonal);
+
+private:
+    int _width = 0;
+    int _height = 0;
+    std::vector<double> _cost;
+    std::vector<std::pair<double, int>> _heap; // (비용, 칸), 재사용
+};
+
+class SearchVerifier
+{
+public:
+    enum class PathError
+    {
+        NONE,
+        MISSED,         // 갈 수 있는데 FAILED
+        PHANTOM,        // 갈 수 없는데 경로가 나옴
+        WRONG_ENDPOINT, // 첫 칸 / 마지막 칸이 출발 / 도착이 아님
+        NOT_ADJACENT,   // 이웃하지 않은 칸으로 건너뜀
+        WALL,           // 벽 칸을 지남
+        CORNER_CUT,     // 양쪽이 막힌 대각선 / 대각선 금지인데 대각선
+        SUBOPTIMAL,     // 비용이 bound * 최적을 넘음
+    };
+
+    static const char* GetErrorName(PathError error);
+
+    // h <= e * h*(실제 남은 비용)이면 가중치 w로 찾은 경로 비용 <= max(1, w * e) * 최적 비용
+    // e: 맨해튼 + 대각선 = 2 / 1.414, 유클리드 + 대각선 = sqrt(2) / 1.414 (대각선 비용이 sqrt(2)보다 조금 작음), 그 외 1
+    static double GetCostBound(AStar::HeuristicType heuristic, bool allowDiagonal, float weight);
+
+    // found: 탐색이 FINISHED였는지. reference는 start에서 실행된 상태여야 함
+    // 비용 비교에는 float 누적 오차만큼 여유를 둠
+    static PathError CheckPath(const AStar& map, const ReferenceDijkstra& reference, Point start, Point end,
+        bool found, const std::vector<Point>& path, bool allowDiagonal, double bound);
+
+    static double PathCost(const std::vector<Point>& path);
+};
+
+// -----------------------------------------------------------
+// SearchBaseline
+// 한 줄에 설정 하나: "<이름> <확장 수> [밀리초]" ('#'으로 시작하는 줄은 주석)
+// 첫 줄 "params ..."는 측정 조건 (맵 크기 / 시드 등). 조건이 다르면 비교하지 않음
+// 확장 수는 기계와 무관하고, 시간은 기준선을 만든 기계에서만 의미가 있음
+// [수정] 밀리초는 생략 가능 (저장소에 올리는 기준선은 확장 수만 두고, 시간 비교는 건너뜀)
+// -----------------------------------------------------------
+class SearchBaseline
+{
+public:
+    struct Entry
+    {
+        std::string name;
+        long long expansions = 0;
+        double milliseconds = 0.0;
+    };
+
+    struct Regression
+    {
+        std::string name;
+        bool expansions; // true: 확장 수, false: 시간
+        double baseline;
+        double current;
+    };
+
+public:
+    void SetParams(const std::string& params) { _params = params; }
+    const std::string& GetParams() const { return _params; }
+
+    void Set(const std::string& name, long long expansions, double milliseconds);
+    const Entry* Find(const std::string& name) const;
+    const std::vector<Entry>& GetEntries() const { return _entries; }
+
+    bool Load(const char* path);
+    bool Save(const char* path, bool withTimes = true) const; // withTimes가 false면 밀리초 열을 쓰지 않음
+
+    // current의 각 항목을 이 기준선과 비교. 확장 수가 expansionTolerance 비율,
+    // 시간이 timeTolerance 비율과 minTimeSlackMs를 모두 넘게 늘어난 항목을 돌려줌 (기준선에 없는 항목은 건너뜀)
+    // 기준선에 시간이 없는 항목은 확장 수만 비교
+    std::vector<Regression> Compare(const SearchBaseline& current, double expansionTolerance,
+        double timeTolerance, double minTimeSlackMs = 1.0) const;
+
+private:
+    std::string _params;
+    std::vector<Entry> _entries;
+};
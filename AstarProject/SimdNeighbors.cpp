@@ -0,0 +1,179 @@
+﻿#include "MemoryPool.h"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include "AStar.h"
+#include "SimdNeighbors.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SIMD_NEIGHBORS_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// GCC / Clang은 함수 단위로 명령어 집합을 켜야 AVX 내장 함수를 쓸 수 있음 (MSVC는 필요 없음)
+#if defined(SIMD_NEIGHBORS_X86) && defined(__GNUC__)
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define SIMD_TARGET_AVX2
+#endif
+
+namespace
+{
+    // AStar::dx / dy / cost를 float로 (벡터 로드용)
+    alignas(32) const float DX[8] = { (float)AStar::dx[0], (float)AStar::dx[1], (float)AStar::dx[2], (float)AStar::dx[3],
+                                      (float)AStar::dx[4], (float)AStar::dx[5], (float)AStar::dx[6], (float)AStar::dx[7] };
+    alignas(32) const float DY[8] = { (float)AStar::dy[0], (float)AStar::dy[1], (float)AStar::dy[2], (float)AStar::dy[3],
+                                      (float)AStar::dy[4], (float)AStar::dy[5], (float)AStar::dy[6], (float)AStar::dy[7] };
+    alignas(32) const float COST[8] = { AStar::cost[0], AStar::cost[1], AStar::cost[2], AStar::cost[3],
+                                        AStar::cost[4], AStar::cost[5], AStar::cost[6], AStar::cost[7] };
+
+    // 옥타일 거리의 대각선 보정 계수 (CalculateH와 같은 값)
+    const float OCTILE_K = AStar::cost[4] - 1.0f;
+
+    void EvaluateScalar(int x, int y, float g, Point end, AStar::HeuristicType type, float weight, SimdNeighbors::Result& out)
+    {
+        float baseX = (float)(x - end.x);
+        float baseY = (float)(y - end.y);
+        for (int i = 0; i < 8; ++i)
+        {
+            float dx = std::fabs(baseX + DX[i]);
+            float dy = std::fabs(baseY + DY[i]);
+
+            float h = 0.0f;
+            switch (type) {
+            case AStar::HeuristicType::MANHATTAN:
+                h = dx + dy;
+                break;
+            case AStar::HeuristicType::EUCLIDEAN:
+                h = std::sqrt(dx * dx + dy * dy);
+                break;
+            case AStar::HeuristicType::OCTILE:
+                h = (std::max)(dx, dy) + OCTILE_K * (std::min)(dx, dy);
+                break;
+            }
+            out.g[i] = g + COST[i];
+            out.h[i] = h * weight;
+        }
+    }
+
+#ifdef SIMD_NEIGHBORS_X86
+    // 4칸씩 두 번 (x64에서는 SSE2가 항상 있음)
+    void EvaluateSse2(int x, int y, float g, Point end, AStar::HeuristicType type, float weight, SimdNeighbors::Result& out)
+    {
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+        const __m128 baseX = _mm_set1_ps((float)(x - end.x));
+        const __m128 baseY = _mm_set1_ps((float)(y - end.y));
+        const __m128 baseG = _mm_set1_ps(g);
+        const __m128 w = _mm_set1_ps(weight);
+        const __m128 k = _mm_set1_ps(OCTILE_K);
+
+        for (int half = 0; half < 8; half += 4)
+        {
+            __m128 dx = _mm_andnot_ps(signMask, _mm_add_ps(baseX, _mm_load_ps(DX + half)));
+            __m128 dy = _mm_andnot_ps(signMask, _mm_add_ps(baseY, _mm_load_ps(DY + half)));
+
+            __m128 h;
+            switch (type) {
+            case AStar::HeuristicType::MANHATTAN:
+                h = _mm_add_ps(dx, dy);
+                break;
+            case AStar::HeuristicType::EUCLIDEAN:
+                h = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)));
+                break;
+            default:
+                h = _mm_add_ps(_mm_max_ps(dx, dy), _mm_mul_ps(k, _mm_min_ps(dx, dy)));
+                break;
+            }
+            _mm_store_ps(out.g + half, _mm_add_ps(baseG, _mm_load_ps(COST + half)));
+            _mm_store_ps(out.h + half, _mm_mul_ps(h, w));
+        }
+    }
+
+    // 8칸을 레지스터 하나로
+    SIMD_TARGET_AVX2
+    void EvaluateAvx2(int x, int y, float g, Point end, AStar::HeuristicType type, float weight, SimdNeighbors::Result& out)
+    {
+        const __m256 signMask = _mm256_set1_ps(-0.0f);
+        __m256 dx = _mm256_andnot_ps(signMask, _mm256_add_ps(_mm256_set1_ps((float)(x - end.x)), _mm256_load_ps(DX)));
+        __m256 dy = _mm256_andnot_ps(signMask, _mm256_add_ps(_mm256_set1_ps((float)(y - end.y)), _mm256_load_ps(DY)));
+
+        __m256 h;
+        switch (type) {
+        case AStar::HeuristicType::MANHATTAN:
+            h = _mm256_add_ps(dx, dy);
+            break;
+        case AStar::HeuristicType::EUCLIDEAN:
+            h = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)));
+            break;
+        default:
+            h = _mm256_add_ps(_mm256_max_ps(dx, dy), _mm256_mul_ps(_mm256_set1_ps(OCTILE_K), _mm256_min_ps(dx, dy)));
+            break;
+        }
+        _mm256_store_ps(out.g, _mm256_add_ps(_mm256_set1_ps(g), _mm256_load_ps(COST)));
+        _mm256_store_ps(out.h, _mm256_mul_ps(h, _mm256_set1_ps(weight)));
+    }
+
+    bool CpuHasAvx2()
+    {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+
+        // CPU가 AVX를 지원하고, OS가 YMM 레지스터를 저장해 주는지 (OSXSAVE + XCR0)
+        __cpuid(info, 1);
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) return false;
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+#endif
+    }
+#endif
+}
+
+AStar::SimdLevel SimdNeighbors::DetectLevel()
+{
+#ifdef SIMD_NEIGHBORS_X86
+    static const AStar::SimdLevel level = CpuHasAvx2() ? AStar::SimdLevel::AVX2 : AStar::SimdLevel::SSE2;
+    return level;
+#else
+    return AStar::SimdLevel::SCALAR;
+#endif
+}
+
+const char* SimdNeighbors::GetLevelName(AStar::SimdLevel level)
+{
+    switch (level) {
+    case AStar::SimdLevel::SCALAR: return "scalar";
+    case AStar::SimdLevel::SSE2: return "sse2";
+    case AStar::SimdLevel::AVX2: return "avx2";
+    }
+    return "?";
+}
+
+void SimdNeighbors::Evaluate(AStar::SimdLevel level, int x, int y, float g, Point end,
+                             AStar::HeuristicType type, float weight, Result& out)
+{
+#ifdef SIMD_NEIGHBORS_X86
+    switch (level) {
+    case AStar::SimdLevel::AVX2:
+        EvaluateAvx2(x, y, g, end, type, weight, out);
+        return;
+    case AStar::SimdLevel::SSE2:
+        EvaluateSse2(x, y, g, end, type, weight, out);
+        return;
+    default:
+        break;
+    }
+#endif
+    EvaluateScalar(x, y, g, end, type, weight, out);
+}
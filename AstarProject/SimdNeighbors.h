@@ -0,0 +1,29 @@
+﻿#pragma once
+
+// -----------------------------------------------------------
+// SimdNeighbors (이웃 8칸의 g / h를 한 번에 계산)
+//
+// UpdatePathFinding은 새 이웃마다 CalculateH를 따로 불러서
+// switch 분기와 sqrt를 이웃 수만큼 반복합니다.
+// 여기서는 8방향 이웃의 좌표 차이 / g / h를 벡터 레지스터 하나(AVX2) 또는 두 개(SSE2)에 담아
+// 분기 없이 한 번에 계산하고, AStar는 켜진 방향의 값만 꺼내 씁니다.
+// - 구현은 실행 중에 CPU를 검사해서 고름 (x86이 아니면 스칼라만)
+// - 세 구현 모두 CalculateH와 같은 순서로 연산하므로 결과가 비트 단위로 같음
+//   (FMA를 쓰지 않는 이유)
+// -----------------------------------------------------------
+namespace SimdNeighbors
+{
+    struct Result
+    {
+        alignas(32) float g[8]; // current->g + AStar::cost[i]
+        alignas(32) float h[8]; // 가중치가 곱해진 휴리스틱
+    };
+
+    // 이 CPU에서 쓸 수 있는 가장 높은 단계 (처음 한 번만 검사)
+    AStar::SimdLevel DetectLevel();
+    const char* GetLevelName(AStar::SimdLevel level);
+
+    // (x, y)에서 AStar::dx/dy 순서의 8방향 이웃 평가 (벽 / 범위 밖 이웃도 계산만 함)
+    void Evaluate(AStar::SimdLevel level, int x, int y, float g, Point end,
+                  AStar::HeuristicType type, float weight, Result& out);
+}
@@ -0,0 +1,260 @@
+﻿#include "MemoryPool.h"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <bit>
+#include "AStar.h"
+#include "SwampMap.h"
+
+void SwampMap::Build(const AStar& map, int maxMouthWidth, int maxRegionCells)
+{
+    _width = map.GetMapWidth();
+    _height = map.GetMapHeight();
+    _maxMouthWidth = (std::max)(maxMouthWidth, 1);
+    _maxRegionCells = (std::max)(maxRegionCells, 1);
+    _syncedMapVersion = map.GetMapVersion();
+    ++_revision;
+
+    size_t cellCount = (size_t)_width * _height;
+    _swampOf.assign(cellCount, 0);
+    _swamps.assign(1, Swamp());
+    _liveSwampCount = 0;
+    _swampCellCount = 0;
+    _fillStamp.assign(cellCount, 0);
+    _fillGeneration = 0;
+
+    // 가로 / 세로로 벽에서 벽까지 이어진 짧은 구간을 입구 후보로
+    std::vector<int> mouth;
+    for (int orientation = 0; orientation < 2; ++orientation)
+    {
+        bool horizontal = (orientation == 0);
+        int stepX = horizontal ? 1 : 0;
+        int stepY = horizontal ? 0 : 1;
+
+        for (int y = 0; y < _height; ++y)
+        {
+            for (int x = 0; x < _width; ++x)
+            {
+                // 구간의 첫 칸: 자신은 걸을 수 있고 바로 앞은 벽(또는 맵 밖)
+                if (!map.IsWalkable(x, y) || map.IsWalkable(x - stepX, y - stepY)) continue;
+
+                mouth.clear();
+                int cx = x, cy = y;
+                while (map.IsWalkable(cx, cy) && (int)mouth.size() <= _maxMouthWidth)
+                {
+                    mouth.push_back(cy * _width + cx);
+                    cx += stepX;
+                    cy += stepY;
+                }
+                if ((int)mouth.size() > _maxMouthWidth) continue;
+
+                // 이미 늪 안인 입구는 건너뜀 (늪 번호가 부모 -> 자식 순서로 커지지 않게)
+                bool insideSwamp = false;
+                for (int index : mouth) insideSwamp |= (_swampOf[index] != 0);
+                if (insideSwamp) continue;
+
+                if (!TryAddSwamp(map, mouth, horizontal, -1))
+                    TryAddSwamp(map, mouth, horizontal, +1);
+            }
+        }
+    }
+
+    _openStamp.assign(_swamps.size(), 0);
+    _queryStamp = 0;
+}
+
+bool SwampMap::TryAddSwamp(const AStar& map, const std::vector<int>& mouth, bool horizontal, int side)
+{
+    // 1. 세대 번호: 입구 = generation, 채운 칸 = generation + 1, 반대쪽 시작 칸 = generation + 2
+    if (_fillGeneration > 0xFFFFFFF0u)
+    {
+        std::fill(_fillStamp.begin(), _fillStamp.end(), 0);
+        _fillGeneration = 0;
+    }
+    unsigned int mouthMark = ++_fillGeneration;
+    unsigned int fillMark = ++_fillGeneration;
+    unsigned int otherMark = ++_fillGeneration;
+    for (int index : mouth) _fillStamp[index] = mouthMark;
+
+    // 2. 입구에서 양쪽으로 한 걸음 나간 칸 (side쪽은 채우기 시작점, 반대쪽은 닿으면 실패)
+    _fillCells.clear();
+    for (int index : mouth)
+    {
+        int x = index % _width;
+        int y = index / _width;
+        // 대각선 허용 여부와 상관없이 8방향 기준 마스크를 씀
+        // 8방향에서 떨어진 주머니는 4방향에서도 떨어져 있으므로 설정을 바꿔도 늪이 그대로 유효함
+        unsigned int mask = map.GetRawMoveMask(x, y);
+        for (int i = 0; i < 8; ++i)
+        {
+            if ((mask & (1u << i)) == 0) continue;
+
+            int offset = horizontal ? AStar::dy[i] : AStar::dx[i];
+            if (offset == 0) continue; // 입구를 따라가는 방향
+
+            int next = (y + AStar::dy[i]) * _width + (x + AStar::dx[i]);
+            if (_fillStamp[next] == mouthMark || _fillStamp[next] == fillMark) continue;
+            if (offset == side)
+            {
+                _fillStamp[next] = fillMark;
+                _fillCells.push_back(next);
+            }
+            else
+            {
+                _fillStamp[next] = otherMark;
+            }
+        }
+    }
+    if (_fillCells.empty()) return false;
+
+    // 3. 입구를 빼고 채우기. 크기 한도를 넘거나 반대쪽에 닿으면 주머니가 아님
+    for (size_t head = 0; head < _fillCells.size(); ++head)
+    {
+        int index = _fillCells[head];
+        int x = index % _width;
+        int y = index / _width;
+        unsigned int mask = map.GetRawMoveMask(x, y);
+        while (mask != 0)
+        {
+            int i = std::countr_zero(mask);
+            mask &= mask - 1;
+
+            int next = (y + AStar::dy[i]) * _width + (x + AStar::dx[i]);
+            unsigned int stamp = _fillStamp[next];
+            if (stamp == mouthMark || stamp == fillMark) continue;
+            if (stamp == otherMark) return false;
+
+            _fillStamp[next] = fillMark;
+            _fillCells.push_back(next);
+            if ((int)_fillCells.size() > _maxRegionCells) return false;
+        }
+    }
+
+    // 4. 등록 (이미 더 안쪽 늪인 칸은 그 늪에 그대로 둠)
+    int id = (int)_swamps.size();
+    Swamp swamp;
+    swamp.mouthCell = mouth[0];
+    swamp.mouthLength = (int)mouth.size();
+    swamp.horizontal = horizontal;
+    for (int index : _fillCells)
+    {
+        if (_swampOf[index] != 0) continue;
+        _swampOf[index] = id;
+        swamp.cells.push_back(index);
+    }
+    if (swamp.cells.empty()) return false;
+
+    // 이미 늪인 칸에 닿았으면 그 늪을 감싸고 있음: 그 늪의 가장 바깥 조상의 부모가 됨
+    for (int index : _fillCells)
+    {
+        int inner = _swampOf[index];
+        if (inner == id) continue;
+        while (_swamps[inner].parent != 0 && _swamps[inner].parent != id)
+            inner = _swamps[inner].parent;
+        if (_swamps[inner].parent == 0) _swamps[inner].parent = id;
+    }
+
+    _swampCellCount += swamp.cells.size();
+    ++_liveSwampCount;
+    _swamps.push_back(std::move(swamp));
+    return true;
+}
+
+int SwampMap::RemoveSwamp(int id)
+{
+    // 자식 늪은 그대로 유효 (자식의 조건은 자기 입구에만 의존)
+    // 반대로 부모는 자식 영역까지 감싸야 성립하므로, 자식이 깨지면 조상도 전부 지움
+    int removed = 0;
+    while (id != 0 && !_swamps[id].cells.empty())
+    {
+        Swamp& swamp = _swamps[id];
+        for (int index : swamp.cells) _swampOf[index] = 0;
+        _swampCellCount -= swamp.cells.size();
+        --_liveSwampCount;
+        swamp.cells.clear();
+        swamp.cells.shrink_to_fit();
+        ++removed;
+
+        id = swamp.parent;
+    }
+    return removed;
+}
+
+int SwampMap::SyncFrom(const AStar& map)
+{
+    std::vector<AStar::MapChange> changes;
+    bool sameSize = _width == map.GetMapWidth() && _height == map.GetMapHeight();
+    bool rebuild = !sameSize || !map.GetChangesSince(_syncedMapVersion, changes);
+
+    // 맵 전체가 바뀐 경우(GenerateRandomMap / SmoothMap)는 지울 것만 남으므로 처음부터 다시 찾음
+    for (const AStar::MapChange& change : changes)
+        rebuild |= (change.width >= _width && change.height >= _height);
+
+    if (rebuild)
+    {
+        int removed = _liveSwampCount;
+        Build(map, _maxMouthWidth, _maxRegionCells);
+        return removed;
+    }
+    _syncedMapVersion = map.GetMapVersion();
+
+    // 늪 칸 / 입구 칸 또는 그 바로 옆(벽이 뚫리면 새 통로, 입구 끝 벽이 뚫리면 입구가 아니게 됨)이
+    // 바뀌면 조건이 깨질 수 있으므로 바뀐 사각형을 한 칸 넓혀서 확인
+    int removed = 0;
+    for (const AStar::MapChange& change : changes)
+    {
+        int x0 = change.x - 1;
+        int y0 = change.y - 1;
+        int x1 = change.x + change.width;
+        int y1 = change.y + change.height;
+
+        for (int y = (std::max)(y0, 0); y <= (std::min)(y1, _height - 1); ++y)
+        {
+            for (int x = (std::max)(x0, 0); x <= (std::min)(x1, _width - 1); ++x)
+            {
+                int id = _swampOf[y * _width + x];
+                if (id == 0) continue;
+                removed += RemoveSwamp(id);
+            }
+        }
+
+        for (int id = 1; id < (int)_swamps.size(); ++id)
+        {
+            const Swamp& swamp = _swamps[id];
+            if (swamp.cells.empty()) continue;
+
+            int mx0 = swamp.mouthCell % _width;
+            int my0 = swamp.mouthCell / _width;
+            int mx1 = mx0 + (swamp.horizontal ? swamp.mouthLength - 1 : 0);
+            int my1 = my0 + (swamp.horizontal ? 0 : swamp.mouthLength - 1);
+            if (mx1 < x0 || mx0 > x1 || my1 < y0 || my0 > y1) continue;
+
+            removed += RemoveSwamp(id);
+        }
+    }
+    if (removed > 0) ++_revision;
+    return removed;
+}
+
+void SwampMap::BeginQuery(Point start, Point end)
+{
+    if (++_queryStamp == 0)
+    {
+        std::fill(_openStamp.begin(), _openStamp.end(), 0);
+        _queryStamp = 1;
+    }
+
+    // 끝점이 든 늪에서 부모를 따라 바깥 늪으로 (번호가 항상 커지므로 끝이 있음)
+    for (Point p : { start, end })
+    {
+        for (int id = GetSwampId(p.x, p.y); id != 0; id = _swamps[id].parent)
+            _openStamp[id] = _queryStamp;
+    }
+}
+
+int SwampMap::GetSwampId(int x, int y) const
+{
+    if (x < 0 || x >= _width || y < 0 || y >= _height) return 0;
+    return _swampOf[y * _width + x];
+}
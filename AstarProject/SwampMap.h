@@ -0,0 +1,86 @@
+﻿#pragma once
+
+// -----------------------------------------------------------
+// SwampMap (막다른 주머니 영역 전처리)
+//
+// SmoothMap으로 만든 동굴에는 좁은 입구 하나로만 이어진 주머니가 많고,
+// 출발/도착이 그 안에 있지 않으면 최적 경로가 그 안으로 들어갈 일이 없는데도
+// A*는 휴리스틱이 그쪽을 가리키면 주머니 안을 다 훑고 나옵니다.
+//
+// [찾는 방법] 벽에서 벽까지 이어진 가로/세로 직선 구간(입구, 길이 maxMouthWidth 이하)을 떼어냈을 때
+// 한쪽이 maxRegionCells 이하의 작은 영역으로 떨어지면 그 영역을 늪(swamp)으로 표시합니다.
+// 늪의 경계는 전부 입구 위에 있고, 입구 위 두 칸 사이는 입구를 따라 가는 게 항상 가장 짧으므로
+// (옥타일 거리 = 실제 최단 거리) 늪을 지나가는 경로는 같은 비용으로 입구를 따라 가는 경로로 바꿀 수 있습니다.
+// - 나중에 찾은 늪의 채우기가 앞서 찾은 늪의 칸에 닿으면 그 늪을 통째로 감싸므로 부모가 됨. 출발/도착이 든 늪과 그 조상은 열어둠
+//   [수정] 입구 첫 칸이 든 늪을 부모로 보면, 입구 일부만 바깥 늪 안이고 첫 칸은 바깥 늪의 입구 위일 때 부모를 놓쳐서
+//   출발/도착이 든 늪에서 나가는 길이 닫힐 수 있었음
+// - 맵 편집은 AStar의 변경 기록(GetChangesSince)으로 받아서 근처 늪만 지움 (새 주머니는 Build에서만 찾음)
+//
+// AStar::SetSwampMap으로 연결하면 탐색 시작마다 SyncFrom / BeginQuery를 대신 호출합니다.
+// -----------------------------------------------------------
+class SwampMap
+{
+public:
+    static constexpr int DEFAULT_MAX_MOUTH_WIDTH = 3;
+    static constexpr int DEFAULT_MAX_REGION_CELLS = 2048;
+
+public:
+    // map 전체에서 늪 찾기 (이전 결과는 버림)
+    void Build(const AStar& map, int maxMouthWidth = DEFAULT_MAX_MOUTH_WIDTH, int maxRegionCells = DEFAULT_MAX_REGION_CELLS);
+
+    // 마지막으로 반영한 뒤의 맵 편집을 반영. 편집 근처 늪은 지움 (기록이 없거나 맵 전체가 바뀌었으면 전체 Build)
+    // 지운 늪 수 반환
+    int SyncFrom(const AStar& map);
+
+    // 탐색 하나 준비: start / end가 든 늪과 그 조상 늪은 열어둠
+    void BeginQuery(Point start, Point end);
+
+    // BeginQuery 이후, 이 셀이 이번 탐색에서 건너뛸 늪 안인지
+    bool IsPruned(int index) const
+    {
+        int id = _swampOf[index];
+        return id != 0 && _openStamp[id] != _queryStamp;
+    }
+
+    int GetSwampId(int x, int y) const; // 0이면 늪 아님
+    int GetSwampCount() const { return _liveSwampCount; }
+    size_t GetSwampCellCount() const { return _swampCellCount; }
+
+    // Build / 늪 제거가 있을 때마다 증가 (AStar가 탐색 트리 재사용 여부 판단에 씀)
+    unsigned int GetRevision() const { return _revision; }
+
+private:
+    struct Swamp
+    {
+        std::vector<int> cells;
+        int mouthCell = -1; // 입구의 첫 칸
+        int parent = 0;     // 이 늪을 감싸는 늪 (0: 없음). 항상 이 늪보다 번호가 큼
+        int mouthLength = 0;
+        bool horizontal = true;
+    };
+
+    // 입구 segment의 side쪽(-1/+1) 영역을 채워보고 작으면 늪으로 등록
+    bool TryAddSwamp(const AStar& map, const std::vector<int>& mouth, bool horizontal, int side);
+    int RemoveSwamp(int id); // 지운 늪 수 (조상 포함)
+
+private:
+    int _width = 0;
+    int _height = 0;
+    int _maxMouthWidth = DEFAULT_MAX_MOUTH_WIDTH;
+    int _maxRegionCells = DEFAULT_MAX_REGION_CELLS;
+    unsigned int _syncedMapVersion = 0;
+    unsigned int _revision = 0;
+
+    std::vector<int> _swampOf;    // 셀 -> 늪 번호 (0: 없음)
+    std::vector<Swamp> _swamps;   // 0번은 비워둠
+    int _liveSwampCount = 0;
+    size_t _swampCellCount = 0;
+
+    std::vector<unsigned int> _openStamp; // 늪 번호 -> == _queryStamp면 이번 탐색에서 열림
+    unsigned int _queryStamp = 0;
+
+    // 채우기용 (세대 번호로 초기화)
+    std::vector<unsigned int> _fillStamp;
+    unsigned int _fillGeneration = 0;
+    std::vector<int> _fillCells;
+};
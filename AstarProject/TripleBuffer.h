@@ -0,0 +1,49 @@
+﻿#pragma once
+#include <atomic>
+
+// -----------------------------------------------------------
+// TripleBuffer (쓰는 쪽 하나 / 읽는 쪽 하나, 락 없음)
+//
+// 슬롯 3개: 쓰는 쪽 전용 / 읽는 쪽 전용 / 가운데(최근에 발행된 것).
+// - Publish: 다 쓴 슬롯을 가운데와 맞바꾸고 "새 것" 표시
+// - Acquire: 새 것이 있으면 읽던 슬롯을 가운데와 맞바꿈
+// 양쪽 모두 원자 교환 한 번이라 서로 기다리지 않습니다.
+// 읽는 쪽이 느리면 중간 프레임은 건너뛰고 항상 가장 최근 것을 받습니다.
+//
+// 슬롯은 재사용되므로 쓰는 쪽은 GetWriteBuffer의 내용을 매번 전부 다시 채워야 합니다.
+// (벡터 capacity는 그대로 남으므로 몇 프레임 뒤에는 할당이 없음)
+// -----------------------------------------------------------
+template <typename T>
+class TripleBuffer
+{
+public:
+    // 쓰는 쪽
+    T& GetWriteBuffer() { return _slots[_writeIndex]; }
+    void Publish()
+    {
+        unsigned int previous = _shared.exchange(_writeIndex | FRESH_BIT, std::memory_order_acq_rel);
+        _writeIndex = previous & INDEX_MASK;
+    }
+
+    // 읽는 쪽. 새로 발행된 것이 있으면 true (없으면 이전 것을 계속 읽음)
+    bool Acquire()
+    {
+        if ((_shared.load(std::memory_order_relaxed) & FRESH_BIT) == 0) return false;
+
+        unsigned int previous = _shared.exchange(_readIndex, std::memory_order_acq_rel);
+        _readIndex = previous & INDEX_MASK;
+        return true;
+    }
+    const T& GetReadBuffer() const { return _slots[_readIndex]; }
+
+private:
+    static constexpr unsigned int INDEX_MASK = 0x3;
+    static constexpr unsigned int FRESH_BIT = 0x4;
+
+    T _slots[3];
+
+    // 쓰는 쪽 / 읽는 쪽 인덱스는 각자만 건드림 (캐시 라인 분리)
+    alignas(64) std::atomic<unsigned int> _shared{ 1 };
+    alignas(64) unsigned int _writeIndex = 0;
+    alignas(64) unsigned int _readIndex = 2;
+};
@@ -0,0 +1,283 @@
+﻿#include "MemoryPool.h"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <bit>
+#include "AStar.h"
+#include "VersionedGrid.h"
+
+namespace
+{
+    // 스냅샷 안에서 (x, y)의 이동 마스크 계산 (AStar::ComputeMoveMask와 같은 규칙)
+    unsigned char ComputeMoveMask(const GridSnapshot& grid, int x, int y)
+    {
+        if (!grid.IsWalkable(x, y)) return 0;
+
+        unsigned char mask = 0;
+        for (int i = 0; i < 8; ++i)
+        {
+            int nextX = x + AStar::dx[i];
+            int nextY = y + AStar::dy[i];
+
+            if (!grid.IsWalkable(nextX, nextY)) continue;
+
+            // 대각선은 양쪽 직선 방향이 모두 벽일 때만 막음
+            if (i >= 4 && !grid.IsWalkable(x, nextY) && !grid.IsWalkable(nextX, y))
+                continue;
+
+            mask |= (unsigned char)(1 << i);
+        }
+        return mask;
+    }
+}
+
+// -----------------------------------------------------------
+// VersionedGrid
+// -----------------------------------------------------------
+VersionedGrid::VersionedGrid(int width, int height)
+{
+    _current.store(BuildTiles(width, height, [](int, int) { return false; }));
+}
+
+VersionedGrid::VersionedGrid(const AStar& map)
+{
+    _current.store(BuildTiles(map.GetMapWidth(), map.GetMapHeight(),
+        [&map](int x, int y) { return !map.IsWalkable(x, y); }));
+    _syncedMapVersion = map.GetMapVersion();
+}
+
+std::shared_ptr<GridSnapshot> VersionedGrid::BuildTiles(int width, int height, const std::function<bool(int, int)>& isWall)
+{
+    auto snapshot = std::make_shared<GridSnapshot>();
+    snapshot->_width = width;
+    snapshot->_height = height;
+    snapshot->_tilesX = (width + GridSnapshot::TILE_SIZE - 1) / GridSnapshot::TILE_SIZE;
+    snapshot->_tilesY = (height + GridSnapshot::TILE_SIZE - 1) / GridSnapshot::TILE_SIZE;
+    snapshot->_version = 1;
+
+    // 1. 벽 채우기
+    std::vector<std::shared_ptr<GridSnapshot::Tile>> tiles(snapshot->_tilesX * snapshot->_tilesY);
+    for (int t = 0; t < (int)tiles.size(); ++t)
+    {
+        auto tile = std::make_shared<GridSnapshot::Tile>();
+        int x0 = (t % snapshot->_tilesX) * GridSnapshot::TILE_SIZE;
+        int y0 = (t / snapshot->_tilesX) * GridSnapshot::TILE_SIZE;
+        for (int ly = 0; ly < GridSnapshot::TILE_SIZE; ++ly)
+        {
+            for (int lx = 0; lx < GridSnapshot::TILE_SIZE; ++lx)
+            {
+                int x = x0 + lx;
+                int y = y0 + ly;
+                bool outside = (x >= width || y >= height);
+                tile->wall[(ly << GridSnapshot::TILE_SHIFT) | lx] = (outside || isWall(x, y)) ? 1 : 0;
+            }
+        }
+        tiles[t] = tile;
+        snapshot->_tiles.push_back(tile);
+    }
+
+    // 2. 이동 마스크 (벽이 모두 채워진 뒤에 계산해야 타일 경계가 맞음)
+    for (int t = 0; t < (int)tiles.size(); ++t)
+    {
+        int x0 = (t % snapshot->_tilesX) * GridSnapshot::TILE_SIZE;
+        int y0 = (t / snapshot->_tilesX) * GridSnapshot::TILE_SIZE;
+        for (int ly = 0; ly < GridSnapshot::TILE_SIZE; ++ly)
+            for (int lx = 0; lx < GridSnapshot::TILE_SIZE; ++lx)
+                tiles[t]->moveMask[(ly << GridSnapshot::TILE_SHIFT) | lx] = ComputeMoveMask(*snapshot, x0 + lx, y0 + ly);
+    }
+    return snapshot;
+}
+
+unsigned long long VersionedGrid::Publish(const std::vector<Edit>& edits)
+{
+    std::shared_ptr<const GridSnapshot> current = _current.load(std::memory_order_acquire);
+
+    for (;;)
+    {
+        // 1. 타일 포인터 배열만 복사 (타일 자체는 공유)
+        auto next = std::make_shared<GridSnapshot>(*current);
+        next->_version = current->_version + 1;
+
+        // 이번 버전에서 이미 복사한 타일은 그대로 수정
+        std::vector<GridSnapshot::Tile*> owned(next->_tiles.size(), nullptr);
+        auto mutableTile = [&](int x, int y) -> GridSnapshot::Tile&
+        {
+            int t = (y >> GridSnapshot::TILE_SHIFT) * next->_tilesX + (x >> GridSnapshot::TILE_SHIFT);
+            if (owned[t] == nullptr)
+            {
+                auto copy = std::make_shared<GridSnapshot::Tile>(*next->_tiles[t]);
+                owned[t] = copy.get();
+                next->_tiles[t] = std::move(copy);
+            }
+            return *owned[t];
+        };
+
+        // 2. 벽 반영
+        std::vector<Point> changed;
+        for (const Edit& edit : edits)
+        {
+            if (edit.x < 0 || edit.x >= next->_width || edit.y < 0 || edit.y >= next->_height) continue;
+            if (next->IsWalkable(edit.x, edit.y) == !edit.isWall) continue; // 변화 없음
+
+            mutableTile(edit.x, edit.y).wall[GridSnapshot::LocalIndex(edit.x, edit.y)] = edit.isWall ? 1 : 0;
+            changed.push_back({ edit.x, edit.y });
+        }
+
+        // 3. 바뀐 칸 주변 3x3 마스크 갱신 (이웃 타일도 필요하면 복사)
+        for (const Point& p : changed)
+        {
+            for (int y = p.y - 1; y <= p.y + 1; ++y)
+            {
+                for (int x = p.x - 1; x <= p.x + 1; ++x)
+                {
+                    if (x < 0 || x >= next->_width || y < 0 || y >= next->_height) continue;
+                    unsigned char mask = ComputeMoveMask(*next, x, y);
+                    if (next->GetTile(x, y).moveMask[GridSnapshot::LocalIndex(x, y)] != mask)
+                        mutableTile(x, y).moveMask[GridSnapshot::LocalIndex(x, y)] = mask;
+                }
+            }
+        }
+
+        // 4. 발행. 그 사이 다른 작성자가 먼저 발행했다면 current가 최신으로 바뀌고 다시 시도
+        std::shared_ptr<const GridSnapshot> published = next;
+        if (_current.compare_exchange_strong(current, published, std::memory_order_acq_rel, std::memory_order_acquire))
+            return published->_version;
+    }
+}
+
+unsigned long long VersionedGrid::SyncFrom(const AStar& map)
+{
+    std::shared_ptr<const GridSnapshot> current = Acquire();
+    std::vector<AStar::MapChange> changes;
+
+    bool sameSize = current->GetWidth() == map.GetMapWidth() && current->GetHeight() == map.GetMapHeight();
+    if (!sameSize || !map.GetChangesSince(_syncedMapVersion, changes))
+    {
+        // [수정] 새 스냅샷을 다 만든 뒤 Publish와 같은 CAS로 발행 (그 사이 다른 작성자가 발행했으면
+        // 관찰한 최신 버전 + 1로 번호만 다시 매기고 재시도 -> 덮어쓴 발행 없이 버전이 겹치지 않음)
+        std::shared_ptr<GridSnapshot> rebuilt = BuildTiles(map.GetMapWidth(), map.GetMapHeight(),
+            [&map](int x, int y) { return !map.IsWalkable(x, y); });
+        _syncedMapVersion = map.GetMapVersion();
+
+        for (;;)
+        {
+            rebuilt->_version = current->_version + 1;
+            std::shared_ptr<const GridSnapshot> published = rebuilt;
+            if (_current.compare_exchange_strong(current, published, std::memory_order_acq_rel, std::memory_order_acquire))
+                return rebuilt->_version;
+        }
+    }
+    _syncedMapVersion = map.GetMapVersion();
+    if (changes.empty()) return current->GetVersion();
+
+    // 바뀐 사각형 안의 칸을 편집으로 옮김 (실제로 달라진 칸만 Publish에서 반영됨)
+    std::vector<Edit> edits;
+    for (const AStar::MapChange& change : changes)
+    {
+        for (int y = change.y; y < change.y + change.height; ++y)
+        {
+            for (int x = change.x; x < change.x + change.width; ++x)
+            {
+                bool isWall = !map.IsWalkable(x, y);
+                if (current->IsWalkable(x, y) == isWall)
+                    edits.push_back({ x, y, isWall });
+            }
+        }
+    }
+    if (edits.empty()) return current->GetVersion();
+    return Publish(edits);
+}
+
+// -----------------------------------------------------------
+// SnapshotPathFinder
+// -----------------------------------------------------------
+float SnapshotPathFinder::CalculateH(int x, int y, Point end) const
+{
+    return AStar::HeuristicDistance(_heuristicType, { x, y }, end);
+}
+
+bool SnapshotPathFinder::FindPath(const GridSnapshot& grid, Point start, Point end, std::vector<Point>& outPath)
+{
+    outPath.clear();
+    _openList.clear();
+    _expandedCount = 0;
+
+    int width = grid.GetWidth();
+    size_t cellCount = (size_t)width * grid.GetHeight();
+    if (_g.size() != cellCount)
+    {
+        _g.assign(cellCount, 0.0f);
+        _parent.assign(cellCount, -1);
+        _visitStamp.assign(cellCount, 0);
+        _closedStamp.assign(cellCount, 0);
+        _generation = 0;
+    }
+    if (++_generation == 0)
+    {
+        std::fill(_visitStamp.begin(), _visitStamp.end(), 0);
+        std::fill(_closedStamp.begin(), _closedStamp.end(), 0);
+        _generation = 1;
+    }
+
+    if (!grid.IsWalkable(start.x, start.y) || !grid.IsWalkable(end.x, end.y)) return false;
+
+    int startIndex = start.y * width + start.x;
+    int endIndex = end.y * width + end.x;
+    _g[startIndex] = 0.0f;
+    _parent[startIndex] = -1;
+    _visitStamp[startIndex] = _generation;
+    float startH = CalculateH(start.x, start.y, end);
+    _openList.push_back({ startH, startH, startIndex });
+
+    while (!_openList.empty())
+    {
+        std::pop_heap(_openList.begin(), _openList.end(), OpenEntryCompare());
+        int index = _openList.back().index;
+        _openList.pop_back();
+
+        if (_closedStamp[index] == _generation) continue; // Lazy Deletion
+        _closedStamp[index] = _generation;
+        ++_expandedCount;
+
+        if (index == endIndex)
+        {
+            // 경로 길이를 먼저 세고 뒤에서부터 채움 (reverse 불필요)
+            size_t length = 0;
+            for (int trace = index; trace != -1; trace = _parent[trace]) ++length;
+            outPath.resize(length);
+            for (int trace = index; trace != -1; trace = _parent[trace])
+                outPath[--length] = { trace % width, trace / width };
+            return true;
+        }
+
+        int x = index % width;
+        int y = index / width;
+        unsigned int mask = grid.GetMoveMask(x, y, _allowDiagonal);
+        while (mask != 0)
+        {
+            int i = std::countr_zero(mask);
+            mask &= mask - 1;
+
+            int nextX = x + AStar::dx[i];
+            int nextY = y + AStar::dy[i];
+            int nextIndex = nextY * width + nextX;
+            if (_closedStamp[nextIndex] == _generation) continue;
+
+            float newG = _g[index] + AStar::cost[i];
+            if (_visitStamp[nextIndex] != _generation || newG < _g[nextIndex])
+            {
+                _visitStamp[nextIndex] = _generation;
+                _g[nextIndex] = newG;
+                _parent[nextIndex] = index;
+
+                float h = CalculateH(nextX, nextY, end);
+                _openList.push_back({ newG + h, h, nextIndex });
+                std::push_heap(_openList.begin(), _openList.end(), OpenEntryCompare());
+            }
+        }
+    }
+    return false;
+}
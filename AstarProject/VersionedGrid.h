@@ -0,0 +1,153 @@
+﻿#pragma once
+
+// -----------------------------------------------------------
+// VersionedGrid (타일 단위 Copy-On-Write 맵 버전)
+//
+// AStar::SetObstacle은 _mapGrid를 제자리에서 고치므로 탐색과 편집이
+// 같은 스레드(UI 스레드)에 있을 때만 안전합니다.
+// VersionedGrid는 맵을 TILE_SIZE x TILE_SIZE 타일로 나눠 불변 스냅샷으로 관리합니다.
+//
+// - 읽기: Acquire()로 현재 스냅샷을 잡으면(원자적 load) 탐색이 끝날 때까지
+//         그 버전만 봅니다. 탐색 중에는 공유 상태를 건드리지 않습니다.
+// - 쓰기: Publish()가 바뀌는 타일만 복사한 새 스냅샷을 만들어 CAS로 교체합니다.
+//         다른 작성자와 겹치면 최신 버전 기준으로 다시 만듭니다.
+// [수정] std::atomic<std::shared_ptr>는 lock-free가 아닙니다 (MSVC / libstdc++ 모두 내부 스핀락).
+//        load / CAS 순간에만 짧게 잡히고 탐색이나 타일 복사 동안에는 잡히지 않으므로,
+//        "락 없음"이 아니라 "임계 구역이 포인터 교체 하나뿐"이라는 의미입니다.
+// - 회수: 타일은 shared_ptr로 공유되므로 어떤 스냅샷도 잡고 있지 않으면 해제됩니다.
+// -----------------------------------------------------------
+class GridSnapshot
+{
+public:
+    static constexpr int TILE_SHIFT = 6;
+    static constexpr int TILE_SIZE = 1 << TILE_SHIFT; // 64
+
+    struct Tile
+    {
+        unsigned char wall[TILE_SIZE * TILE_SIZE];     // 1: 벽 (맵 밖 패딩 칸도 벽)
+        unsigned char moveMask[TILE_SIZE * TILE_SIZE]; // AStar와 같은 8방향 이동 마스크
+
+        // 살아 있는 타일 수를 셈 (회수 확인용. 타일은 발행할 때만 만들어지므로 탐색 비용과 무관)
+        Tile() { _liveTileCount.fetch_add(1, std::memory_order_relaxed); }
+        Tile(const Tile& other) : Tile()
+        {
+            std::copy(other.wall, other.wall + TILE_SIZE * TILE_SIZE, wall);
+            std::copy(other.moveMask, other.moveMask + TILE_SIZE * TILE_SIZE, moveMask);
+        }
+        ~Tile() { _liveTileCount.fetch_sub(1, std::memory_order_relaxed); }
+        Tile& operator=(const Tile&) = delete;
+    };
+
+    // 모든 VersionedGrid를 통틀어 아직 해제되지 않은 타일 수
+    static long long GetLiveTileCount() { return _liveTileCount.load(std::memory_order_relaxed); }
+    int GetTileCount() const { return (int)_tiles.size(); }
+
+public:
+    int GetWidth() const { return _width; }
+    int GetHeight() const { return _height; }
+    unsigned long long GetVersion() const { return _version; }
+
+    bool IsWalkable(int x, int y) const
+    {
+        if (x < 0 || x >= _width || y < 0 || y >= _height) return false;
+        return GetTile(x, y).wall[LocalIndex(x, y)] == 0;
+    }
+
+    // 대각선 이동 마스크 (allowDiagonal이 false면 직선 4방향만)
+    unsigned char GetMoveMask(int x, int y, bool allowDiagonal) const
+    {
+        unsigned char mask = GetTile(x, y).moveMask[LocalIndex(x, y)];
+        return allowDiagonal ? mask : (unsigned char)(mask & 0x0F);
+    }
+
+private:
+    friend class VersionedGrid;
+
+    const Tile& GetTile(int x, int y) const { return *_tiles[(y >> TILE_SHIFT) * _tilesX + (x >> TILE_SHIFT)]; }
+    static int LocalIndex(int x, int y) { return ((y & (TILE_SIZE - 1)) << TILE_SHIFT) | (x & (TILE_SIZE - 1)); }
+
+private:
+    int _width = 0;
+    int _height = 0;
+    int _tilesX = 0;
+    int _tilesY = 0;
+    unsigned long long _version = 0;
+    std::vector<std::shared_ptr<const Tile>> _tiles;
+
+    static inline std::atomic<long long> _liveTileCount{ 0 };
+};
+
+class VersionedGrid
+{
+public:
+    struct Edit
+    {
+        int x;
+        int y;
+        bool isWall;
+    };
+
+public:
+    VersionedGrid(int width, int height);
+    explicit VersionedGrid(const AStar& map); // 현재 AStar 맵을 버전 1로
+
+    // 현재 버전 스냅샷 (탐색 스레드는 이걸 끝까지 들고 있으면 됨)
+    std::shared_ptr<const GridSnapshot> Acquire() const { return _current.load(std::memory_order_acquire); }
+
+    // edits를 한 번에 반영한 새 버전 발행. 새 버전 번호 반환
+    unsigned long long Publish(const std::vector<Edit>& edits);
+    unsigned long long SetObstacle(int x, int y, bool isWall) { return Publish({ { x, y, isWall } }); }
+
+    // [추가] AStar 맵의 변경 기록을 따라가 바뀐 사각형만 새 버전으로 발행 (현재 버전 번호 반환)
+    // 기록이 잘렸거나 맵 크기가 바뀌었으면 전체 타일을 새로 만들어 Publish와 같은 CAS로 교체
+    // (이때는 맵이 기준이므로 그 사이 다른 작성자가 발행한 편집도 맵 내용으로 덮임)
+    // SyncFrom끼리는 한 스레드에서만 호출 (_syncedMapVersion). Publish와는 동시에 불러도 됨
+    unsigned long long SyncFrom(const AStar& map);
+
+private:
+    // 모든 타일을 새로 만든 스냅샷 (버전 1, 발행은 호출자가)
+    static std::shared_ptr<GridSnapshot> BuildTiles(int width, int height, const std::function<bool(int, int)>& isWall);
+
+private:
+    std::atomic<std::shared_ptr<const GridSnapshot>> _current;
+    unsigned int _syncedMapVersion = 0; // SyncFrom으로 마지막에 반영한 AStar 맵 버전
+};
+
+// -----------------------------------------------------------
+// SnapshotPathFinder
+// 스냅샷 하나를 읽어서 A*를 끝까지 수행합니다. (읽기 스레드마다 하나씩)
+// 탐색 버퍼는 세대(stamp) 번호로 재사용합니다.
+// -----------------------------------------------------------
+class SnapshotPathFinder
+{
+public:
+    void SetHeuristicType(AStar::HeuristicType type) { _heuristicType = type; }
+    void SetAllowDiagonal(bool allow) { _allowDiagonal = allow; }
+
+    // 경로를 찾으면 outPath에 시작 -> 끝 순서로 채우고 true
+    bool FindPath(const GridSnapshot& grid, Point start, Point end, std::vector<Point>& outPath);
+
+    int GetExpandedCount() const { return _expandedCount; }
+
+private:
+    float CalculateH(int x, int y, Point end) const;
+
+private:
+    AStar::HeuristicType _heuristicType = AStar::HeuristicType::MANHATTAN;
+    bool _allowDiagonal = true;
+
+    std::vector<float> _g;
+    std::vector<int> _parent;
+    std::vector<unsigned int> _visitStamp;
+    std::vector<unsigned int> _closedStamp;
+    unsigned int _generation = 0;
+
+    struct OpenEntry
+    {
+        float f;
+        float h;
+        int index;
+    };
+    std::vector<OpenEntry> _openList;
+    int _expandedCount = 0;
+};
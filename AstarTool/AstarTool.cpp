@@ -0,0 +1,2368 @@
+﻿// AstarTool: AStar 코어를 창 없이 돌려보는 콘솔 도구 모음
+//
+// 사용법: AstarTool <명령> [인자...]
+//   flow <width> <height> <seed> [goals] [agents] [threads]
+//                                             다중 목적지 흐름장 생성 후 기준 다익스트라 / 에이전트별 AStar 비용과 비교
+//   distance <width> <height> <seed> [sources] [targets] [maxCost]
+//                                             일대다 / 다대다 거리표(뒤집은 탐색 포함)를 칸 쌍마다 AStar 비용과 비교
+//   render <width> <height> <seed> <out.ppm|out.png> [cellPixels] [-expect crc]
+//                                             탐색 하나를 헤드리스로 그려 저장 (증분 / 전체 / 프레임 렌더 일치 + 저장 파일 재확인, 픽셀 CRC 출력)
+//   events <width> <height> <seed> [rounds]  셀 상태 이벤트를 거울 격자에 재생해 탐색 / 편집 / 크기 변경 후 GetCellType과 비교
+//   record <width> <height> <seed> <trace> [nodeLimit]
+//                                             동굴 맵 하나를 만들어 탐색하고 기록 저장 (노드 상한에 닿으면 잊지 않고 PARTIAL)
+//   replay <trace> [step]                     기록 요약 + step번째 확장 시점 상태 출력
+//   snapshot <width> <height> <seed> [readers] [writers] [ms]
+//                                             작성 스레드(Publish / SyncFrom)가 편집을 발행하는 동안 읽기 스레드가 잡은 스냅샷으로 탐색
+//                                             (결과를 그 스냅샷 기준으로 검사, 잡은 스냅샷 불변 / 버전 중복 없음 / 놓은 타일 회수 확인)
+//   world [tilesX] [tilesY] [seed] [queries] [distance] [maxTiles]
+//                                             작은 청크 월드(편집 + 저장/재로드)에서 AStar와 비용 비교,
+//                                             저장하지 못하는 저장소에서 편집 중 내림이 일어나도 편집이 남는지 확인 후
+//                                             노이즈 타일 저장소로 만든 큰 월드(기본 6.4M x 6.4M 칸)에서 긴 쿼리 (상태 메모리 / 상주 타일)
+//   cpd <width> <height> <seed> <file>        첫 이동 테이블 생성/저장 후 쿼리 속도 비교 + 쿼리별 비용 / 도달 여부를 AStar(옥타일)와 비교
+//   anytime <width> <height> <seed> [sliceUs] ARA*를 시간 조각 단위로 돌리며 경로 개선 과정 출력
+//   bounded <width> <height> <seed> <limit>   노드 상한 탐색과 상한 없는 탐색의 결과/노드 수 비교 (상한을 넘으면 종료 코드 2)
+//   perf <width> <height> <seed> [queries] [batch]
+//                                             탐색 단계별 하드웨어 카운터 (Linux perf_event, 없으면 시간만)
+//   simd <width> <height> <seed> [queries]   이웃 평가 구현(scalar / sse2 / avx2)별 속도 + 결과 일치 확인
+//   swamp <width> <height> <seed> [queries] [edits]
+//                                             늪(막다른 주머니) 전처리 + 건너뛰기 전/후 확장 수 비교 (편집 후 재검증)
+//   parallel <width> <height> <seed> [maxThreads] [queries]
+//                                             쿼리 하나를 해시 분배 병렬 A*로 (스레드 수별 시간 / 확장 수 / 보낸 노드 수, AStar와 비용 비교)
+//   watch <width> <height> <seed> [intervalMs] [queries]
+//                                             뒤 스레드 탐색을 최대 속도로 돌리며 프레임만 받아 봄 (받은 프레임 수 / 읽기 시간, 결과 비교)
+//   verify <width> <height> <seed> [maps] [starts] [goals] [-baseline file] [-save file] [-notime] [-repeat N] [-time pct] [-expand pct]
+//                                             기준 다익스트라와 설정별 AStar 결과 비교 (경로 / 코너 규칙 / 비용 상한 / CompactPath 왕복) + 확장 수 / 시간 기준선 비교
+//                                             맵과 쿼리는 mt19937로 만들어서 컴파일러 / 플랫폼이 달라도 같음
+//                                             (저장된 기준선: verify_baseline.txt = "verify 128 128 1 -save verify_baseline.txt -notime"의 결과.
+//                                              확장 수만 있으므로 어느 기계에서나 비교 가능. 시간은 자기 기계에서 -save로 만든 기준선과 비교)
+//   coop <width> <height> <seed> <agents> [window] [ticks]
+//                                             예약 테이블 기반 다중 에이전트 이동 시뮬레이션 + 충돌 검사 (충돌이 있으면 종료 코드 2)
+//                                             (회귀 확인: "coop 256 256 1 2000" -> 충돌 0, 4개는 좁은 통로에서 서로 막혀 도착 못 함)
+//   serve <socket> <width> <height> <seed> [seed...] [-workers N] [-batch N] [-window us]
+//                                             seed마다 동굴 맵을 한 번 만들어 두고 소켓으로 경로 요청 처리
+//   loadgen <socket> <width> <height> <seed> [connections] [requests] [inflight]
+//                                             serve에 같은 맵 기준 요청을 쏘고 지연 분포 출력 (mapId 0)
+#include "MemoryPool.h"
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <unordered_map>
+#include "AStar.h"
+#include "SearchTrace.h"
+#include "FirstMoveTable.h"
+#include "AnytimeAStar.h"
+#include "CooperativeAStar.h"
+#include "SimdNeighbors.h"
+#include "SwampMap.h"
+#include "ParallelFor.h"
+#include "ParallelAStar.h"
+#include "DistanceTable.h"
+#include "CompactPath.h"
+#include "PerfCounters.h"
+#include "VersionedGrid.h"
+#include "PathService.h"
+#include "TripleBuffer.h"
+#include "BackgroundSearch.h"
+#include "SearchVerifier.h"
+#include "FlowField.h"
+#include "GridRenderer.h"
+#include "ChunkedWorld.h"
+
+// --------------------------------------------------------
+// 공용 헬퍼
+// --------------------------------------------------------
+
+// 시드로 동굴 맵 생성 (프런트엔드의 'R' + 'X' 몇 번과 같은 결과)
+static void GenerateCaveMap(AStar& astar, unsigned int seed, int smoothCount = 4)
+{
+    std::srand(seed);
+    astar.GenerateRandomMap(47);
+    for (int i = 0; i < smoothCount; ++i)
+        astar.SmoothMap();
+}
+
+// 경과 시간 (밀리초)
+static double ElapsedMs(std::chrono::steady_clock::time_point since)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - since).count();
+}
+
+// 맵에서 걸을 수 있는 임의의 칸 (없으면 {-1, -1})
+static Point RandomWalkableCell(const AStar& astar)
+{
+    for (int tries = 0; tries < 10000; ++tries)
+    {
+        Point p = { std::rand() % astar.GetMapWidth(), std::rand() % astar.GetMapHeight() };
+        if (astar.IsWalkable(p.x, p.y)) return p;
+    }
+    return { -1, -1 };
+}
+
+// [추가] 같은 칸 고르기를 시드 고정 mt19937로 (std::rand는 컴파일러마다 수열이 달라 저장된 기준선과 비교할 수 없음)
+// 분포도 표준 라이브러리 구현에 맡기지 않고 나머지 연산으로 고정
+static Point RandomWalkableCell(const AStar& astar, std::mt19937& random)
+{
+    for (int tries = 0; tries < 10000; ++tries)
+    {
+        Point p = { (int)(random() % (unsigned int)astar.GetMapWidth()), (int)(random() % (unsigned int)astar.GetMapHeight()) };
+        if (astar.IsWalkable(p.x, p.y)) return p;
+    }
+    return { -1, -1 };
+}
+
+// --------------------------------------------------------
+// flow: 흐름장 검증 (거리장 전체 + 방향을 따라 걷기 + 에이전트별 AStar)
+// --------------------------------------------------------
+static int CommandFlow(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        printf("usage: flow <width> <height> <seed> [goals] [agents] [threads]\n");
+        return 1;
+    }
+
+    int width = atoi(argv[0]);
+    int height = atoi(argv[1]);
+    unsigned int seed = (unsigned int)strtoul(argv[2], nullptr, 10);
+    int goalCount = (argc >= 4) ? (std::max)(1, atoi(argv[3])) : 4;
+    int agentCount = (argc >= 5) ? atoi(argv[4]) : 200;
+    int threadCount = (argc >= 6) ? atoi(argv[5]) : 0;
+
+    AStar astar(width, height);
+    GenerateCaveMap(astar, seed);
+    astar.SetHeuristicType(AStar::HeuristicType::OCTILE);
+
+    std::vector<Point> goals;
+    for (int g = 0; g < goalCount; ++g) goals.push_back(RandomWalkableCell(astar));
+
+    // 1. 생성 (두 번째는 같은 스레드 풀 / 힙 버퍼를 다시 씀)
+    FlowField field;
+    auto begin = std::chrono::steady_clock::now();
+    field.Build(astar, goals, threadCount);
+    double firstMs = ElapsedMs(begin);
+    begin = std::chrono::steady_clock::now();
+    field.Build(astar, goals, threadCount);
+    double secondMs = ElapsedMs(begin);
+
+    // 2. 거리장 전체를 목적지별 기준 다익스트라의 최솟값과 비교 (이동 규칙이 대칭이라 목적지에서 출발해도 같음)
+    std::vector<ReferenceDijkstra> references(goals.size());
+    for (size_t g = 0; g < goals.size(); ++g)
+        references[g].Run(astar, goals[g], astar.GetAllowDiagonal());
+
+    auto nearestGoal = [&](int x, int y, double& best) -> int
+    {
+        int nearest = -1;
+        best = -1.0;
+        for (size_t g = 0; g < goals.size(); ++g)
+        {
+            if (!references[g].IsReachable(x, y)) continue;
+            double cost = references[g].GetCost(x, y);
+            if (nearest < 0 || cost < best) { best = cost; nearest = (int)g; }
+        }
+        return nearest;
+    };
+
+    int distanceMismatches = 0, reachableCells = 0;
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            if (!astar.IsWalkable(x, y)) continue;
+            double expected;
+            bool reachable = nearestGoal(x, y, expected) >= 0;
+            float distance = field.GetDistance(x, y);
+            bool fieldReachable = distance != std::numeric_limits<float>::infinity();
+
+            reachableCells += reachable ? 1 : 0;
+            if (reachable != fieldReachable || (reachable && std::fabs(distance - expected) > expected * 1e-4 + 0.01))
+            {
+                if (distanceMismatches++ < 5)
+                    printf("distance mismatch at (%d,%d): field %.3f, reference %.3f\n", x, y, distance, reachable ? expected : -1.0);
+            }
+        }
+    }
+
+    // 3. 에이전트: 방향을 따라 걸어서 목적지에 닿는지 + 비용이 AStar(가장 가까운 목적지까지)와 같은지
+    int walkMismatches = 0, agentsReached = 0;
+    double astarMs = 0.0;
+    for (int a = 0; a < agentCount; ++a)
+    {
+        Point agent = RandomWalkableCell(astar);
+        double expected;
+        int nearest = nearestGoal(agent.x, agent.y, expected);
+
+        Point p = agent, next;
+        double walked = 0.0;
+        bool legal = true;
+        for (int steps = 0; steps <= width * height && field.GetNextStep(p, next); ++steps)
+        {
+            legal &= ReferenceDijkstra::CanMove(astar, p.x, p.y, next.x - p.x, next.y - p.y, astar.GetAllowDiagonal());
+            walked += (next.x != p.x && next.y != p.y) ? AStar::cost[4] : AStar::cost[0];
+            p = next;
+        }
+        bool atGoal = std::find_if(goals.begin(), goals.end(),
+            [&](const Point& goal) { return goal.x == p.x && goal.y == p.y; }) != goals.end();
+
+        if (nearest < 0)
+        {
+            if (atGoal && !(agent.x == p.x && agent.y == p.y)) ++walkMismatches;
+            continue;
+        }
+
+        begin = std::chrono::steady_clock::now();
+        astar.StartPathFinding(agent, goals[nearest]);
+        while (astar.GetState() == AStar::State::SEARCHING)
+            astar.UpdatePathFinding();
+        astarMs += ElapsedMs(begin);
+        float astarCost = (astar.GetState() == AStar::State::FINISHED) ? (float)SearchVerifier::PathCost(astar.GetPath()) : -1.0f;
+
+        ++agentsReached;
+        double tolerance = expected * 1e-4 + 0.01;
+        if (!legal || !atGoal || std::fabs(walked - expected) > tolerance || std::fabs(astarCost - expected) > tolerance)
+        {
+            if (walkMismatches++ < 5)
+                printf("agent (%d,%d): walked %.3f to (%d,%d)%s, AStar %.3f, reference %.3f\n", agent.x, agent.y,
+                    walked, p.x, p.y, legal ? "" : " with an illegal step", astarCost, expected);
+        }
+    }
+
+    printf("%dx%d, %d goals, %d rounds: build %.2f ms, rebuild %.2f ms\n",
+        width, height, goalCount, field.GetRoundCount(), firstMs, secondMs);
+    printf("distance : %d reachable cells, %d mismatches\n", reachableCells, distanceMismatches);
+    printf("agents   : %d reached a goal, %d mismatches (per-agent AStar total %.2f ms)\n",
+        agentsReached, walkMismatches, astarMs);
+    return (distanceMismatches == 0 && walkMismatches == 0) ? 0 : 2;
+}
+
+// --------------------------------------------------------
+// distance: 일대다 / 다대다 거리표 검증 (칸마다 AStar 비용과 비교)
+// --------------------------------------------------------
+static int CommandDistance(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        printf("usage: distance <width> <height> <seed> [sources] [targets] [maxCost]\n");
+        return 1;
+    }
+
+    int width = atoi(argv[0]);
+    int height = atoi(argv[1]);
+    unsigned int seed = (unsigned int)strtoul(argv[2], nullptr, 10);
+    int sourceCount = (argc >= 4) ? (std::max)(1, atoi(argv[3])) : 8;
+    int targetCount = (argc >= 5) ? (std::max)(1, atoi(argv[4])) : 24;
+    float maxCost = (argc >= 6) ? (float)atof(argv[5]) : std::numeric_limits<float>::infinity();
+
+    AStar astar(width, height);
+    GenerateCaveMap(astar, seed);
+    astar.SetHeuristicType(AStar::HeuristicType::OCTILE); // 허용 휴리스틱이라 AStar 비용 = 최적 비용
+
+    std::vector<Point> sources, targets;
+    for (int s = 0; s < sourceCount; ++s) sources.push_back(RandomWalkableCell(astar));
+    for (int t = 0; t < targetCount; ++t) targets.push_back(RandomWalkableCell(astar));
+
+    // 1. 기준: 칸 쌍마다 AStar (도달 불가 / maxCost 초과는 무한대)
+    std::vector<float> expected((size_t)sourceCount * targetCount);
+    auto begin = std::chrono::steady_clock::now();
+    for (int s = 0; s < sourceCount; ++s)
+    {
+        for (int t = 0; t < targetCount; ++t)
+        {
+            astar.StartPathFinding(sources[s], targets[t]);
+            while (astar.GetState() == AStar::State::SEARCHING)
+                astar.UpdatePathFinding();
+            float cost = (astar.GetState() == AStar::State::FINISHED) ? (float)SearchVerifier::PathCost(astar.GetPath()) : std::numeric_limits<float>::infinity();
+            expected[(size_t)s * targetCount + t] = (cost <= maxCost) ? cost : std::numeric_limits<float>::infinity();
+        }
+    }
+    double astarMs = ElapsedMs(begin);
+
+    // 2. 행 단위(출발지 쪽 탐색)와 뒤집은 쪽(출발지가 더 많으면 목적지 쪽 탐색)을 모두 비교
+    DistanceTable distances(astar);
+    int mismatches = 0;
+    auto check = [&](const char* name, const std::vector<float>& got, bool transposed)
+    {
+        for (int s = 0; s < sourceCount; ++s)
+        {
+            for (int t = 0; t < targetCount; ++t)
+            {
+                float want = expected[(size_t)s * targetCount + t];
+                float value = transposed ? got[(size_t)t * sourceCount + s] : got[(size_t)s * targetCount + t];
+                bool same = std::isinf(want) ? std::isinf(value) : std::fabs(value - want) <= want * 1e-4f + 0.01f;
+                if (!same && mismatches++ < 5)
+                    printf("%s mismatch (%d,%d) -> (%d,%d): table %.3f, AStar %.3f\n", name,
+                        sources[s].x, sources[s].y, targets[t].x, targets[t].y, value, want);
+            }
+        }
+    };
+
+    begin = std::chrono::steady_clock::now();
+    std::vector<float> matrix = distances.ManyToMany(sources, targets, maxCost);
+    double rowsMs = ElapsedMs(begin);
+    check("rows", matrix, false);
+
+    begin = std::chrono::steady_clock::now();
+    std::vector<float> transposed = distances.ManyToMany(targets, sources, maxCost);
+    double columnsMs = ElapsedMs(begin);
+    check("transposed", transposed, true);
+
+    std::vector<float> oneToMany;
+    for (int s = 0; s < sourceCount; ++s)
+    {
+        std::vector<float> row = distances.OneToMany(sources[s], targets, maxCost);
+        oneToMany.insert(oneToMany.end(), row.begin(), row.end());
+    }
+    check("one-to-many", oneToMany, false);
+
+    int reachable = (int)std::count_if(expected.begin(), expected.end(), [](float cost) { return !std::isinf(cost); });
+    printf("%dx%d, %d x %d pairs (%d reachable): AStar per pair %.2f ms, ManyToMany %.2f ms, transposed %.2f ms\n",
+        width, height, sourceCount, targetCount, reachable, astarMs, rowsMs, columnsMs);
+    printf("%d mismatches\n", mismatches);
+    return mismatches == 0 ? 0 : 2;
+}
+
+// --------------------------------------------------------
+// render: 헤드리스 프레임 덤프 + 확인
+// --------------------------------------------------------
+
+// 저장한 PPM / PNG(무압축 deflate)를 다시 읽어 RGB 바이트로 (형식이 다르면 false)
+static bool ReadBackImage(const char* path, bool png, int& width, int& height, std::vector<unsigned char>& rgb)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+    std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    if (!png)
+    {
+        int maxValue = 0, consumed = 0;
+        if (sscanf((const char*)bytes.data(), "P6 %d %d %d%n", &width, &height, &maxValue, &consumed) != 3 || maxValue != 255)
+            return false;
+        size_t offset = (size_t)consumed + 1; // 헤더 뒤 공백 한 칸
+        if (bytes.size() != offset + (size_t)width * height * 3) return false;
+        rgb.assign(bytes.begin() + offset, bytes.end());
+        return true;
+    }
+
+    // PNG: 청크를 따라가며 IHDR 크기와 IDAT(zlib 헤더 2바이트 + 무압축 블록들)를 모음
+    auto be32 = [&](size_t at) { return (unsigned int)bytes[at] << 24 | bytes[at + 1] << 16 | bytes[at + 2] << 8 | bytes[at + 3]; };
+    std::vector<unsigned char> zlib;
+    for (size_t at = 8; at + 12 <= bytes.size();)
+    {
+        unsigned int length = be32(at);
+        std::string type(bytes.begin() + at + 4, bytes.begin() + at + 8);
+        if (at + 12 + length > bytes.size()) return false;
+        if (type == "IHDR") { width = (int)be32(at + 8); height = (int)be32(at + 12); }
+        if (type == "IDAT") zlib.insert(zlib.end(), bytes.begin() + at + 8, bytes.begin() + at + 8 + length);
+        at += 12 + length;
+    }
+
+    std::vector<unsigned char> raw;
+    for (size_t at = 2; at + 5 <= zlib.size();)
+    {
+        bool last = zlib[at] & 1;
+        size_t blockSize = zlib[at + 1] | (zlib[at + 2] << 8);
+        if (at + 5 + blockSize > zlib.size()) return false;
+        raw.insert(raw.end(), zlib.begin() + at + 5, zlib.begin() + at + 5 + blockSize);
+        at += 5 + blockSize;
+        if (last) break;
+    }
+
+    // 행마다 앞의 필터 바이트(0)를 뺌
+    size_t stride = (size_t)width * 3 + 1;
+    if (width <= 0 || height <= 0 || raw.size() != stride * height) return false;
+    rgb.clear();
+    for (int y = 0; y < height; ++y)
+        rgb.insert(rgb.end(), raw.begin() + y * stride + 1, raw.begin() + (y + 1) * stride);
+    return true;
+}
+
+static int CommandRender(int argc, char** argv)
+{
+    if (argc < 4)
+    {
+        printf("usage: render <width> <height> <seed> <out.ppm|out.png> [cellPixels] [-expect crc]\n");
+        return 1;
+    }
+
+    int width = atoi(argv[0]);
+    int height = atoi(argv[1]);
+    unsigned int seed = (unsigned int)strtoul(argv[2], nullptr, 10);
+    const char* outPath = argv[3];
+    int cellPixels = 4;
+    bool hasExpected = false;
+    unsigned int expected = 0;
+    for (int i = 4; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "-expect" && i + 1 < argc) { hasExpected = true; expected = (unsigned int)strtoul(argv[++i], nullptr, 16); }
+        else cellPixels = (std::max)(1, atoi(argv[i]));
+    }
+    std::string outName = outPath;
+    bool png = outName.size() >= 4 && outName.compare(outName.size() - 4, 4, ".png") == 0;
+
+    AStar astar(width, height);
+    GenerateCaveMap(astar, seed);
+    astar.SetHeuristicType(AStar::HeuristicType::OCTILE);
+    astar.SetDirtyTrackingEnabled(true);
+    Point start = RandomWalkableCell(astar);
+    Point end = RandomWalkableCell(astar);
+
+    // 1. 탐색하면서 바뀐 셀만 다시 그림 (창에서 하던 방식)
+    GridRenderer incremental(cellPixels, true);
+    incremental.SetMarkers(start, end);
+    incremental.Update(astar);
+    astar.StartPathFinding(start, end);
+    long long redrawn = 0, steps = 0;
+    while (astar.GetState() == AStar::State::SEARCHING)
+    {
+        astar.UpdatePathFinding();
+        if ((++steps & 63) == 0) redrawn += incremental.Update(astar);
+    }
+    redrawn += incremental.Update(astar);
+
+    // 2. 같은 상태를 새 렌더러로 한 번에 / BackgroundSearch 프레임으로
+    GridRenderer full(cellPixels, true);
+    full.SetMarkers(start, end);
+    full.Update(astar);
+
+    BackgroundSearch search;
+    search.SetStepsPerSecond(0);
+    search.Start(astar, start, end);
+    while (search.IsRunning()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    while (search.AcquireFrame()) {}
+    GridRenderer fromFrame(cellPixels, true);
+    fromFrame.SetMarkers(start, end);
+    fromFrame.Update(search.GetFrame());
+
+    int failures = 0;
+    unsigned int checksum = full.GetPixelChecksum();
+    if (incremental.GetPixels() != full.GetPixels())
+    {
+        printf("incremental render differs from a full render\n");
+        ++failures;
+    }
+    if (fromFrame.GetPixels() != full.GetPixels())
+    {
+        printf("frame render differs from a full render\n");
+        ++failures;
+    }
+
+    // 3. 저장 후 다시 읽어서 픽셀 비교
+    bool saved = png ? full.SavePNG(outPath) : full.SavePPM(outPath);
+    int readWidth = 0, readHeight = 0;
+    std::vector<unsigned char> rgb;
+    if (!saved || !ReadBackImage(outPath, png, readWidth, readHeight, rgb))
+    {
+        printf("%s: could not write or read back\n", outPath);
+        ++failures;
+    }
+    else
+    {
+        bool same = readWidth == full.GetPixelWidth() && readHeight == full.GetPixelHeight();
+        for (size_t i = 0; same && i < full.GetPixels().size(); ++i)
+        {
+            unsigned int color = full.GetPixels()[i];
+            same = rgb[i * 3] == (unsigned char)(color >> 16) && rgb[i * 3 + 1] == (unsigned char)(color >> 8) &&
+                rgb[i * 3 + 2] == (unsigned char)color;
+        }
+        if (!same)
+        {
+            printf("%s: saved pixels differ from the renderer\n", outPath);
+            ++failures;
+        }
+    }
+
+    printf("%dx%d cells -> %dx%d pixels, %lld steps, %lld cells redrawn incrementally (%.1f per step)\n",
+        width, height, full.GetPixelWidth(), full.GetPixelHeight(), steps, redrawn, steps ? (double)redrawn / steps : 0.0);
+    printf("%s: crc %08x%s\n", outPath, checksum, failures ? "" : ", incremental / frame / file all match");
+    if (hasExpected && checksum != expected)
+    {
+        printf("expected crc %08x\n", expected);
+        ++failures;
+    }
+    return failures == 0 ? 0 : 2;
+}
+
+// --------------------------------------------------------
+// events: 셀 상태 이벤트 스트림을 거울 격자에 재생해서 GetCellType과 비교
+// --------------------------------------------------------
+static int CommandEvents(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        printf("usage: events <width> <height> <seed> [rounds]\n");
+        return 1;
+    }
+
+    int width = atoi(argv[0]);
+    int height = atoi(argv[1]);
+    unsigned int seed = (unsigned int)strtoul(argv[2], nullptr, 10);
+    int rounds = (argc >= 4) ? atoi(argv[3]) : 50;
+
+    AStar astar(width, height);
+    GenerateCaveMap(astar, seed);
+    astar.SetHeuristicType(AStar::HeuristicType::OCTILE);
+    astar.SetCellEventsEnabled(true);
+
+    // 거울: 이벤트만 보고 유지하는 셀 상태 (전체 재동기화를 요구받을 때만 GetCellType을 통째로 읽음)
+    std::vector<AStar::NodeType> mirror;
+    std::vector<AStar::CellEvent> events;
+    long long eventCount = 0;
+    int polls = 0, resets = 0, mismatches = 0;
+
+    auto sync = [&](const char* when)
+    {
+        ++polls;
+        int mapWidth = astar.GetMapWidth();
+        int mapHeight = astar.GetMapHeight();
+        if (astar.PollCellEvents(events))
+        {
+            ++resets;
+            mirror.resize((size_t)mapWidth * mapHeight);
+            for (int y = 0; y < mapHeight; ++y)
+                for (int x = 0; x < mapWidth; ++x)
+                    mirror[(size_t)y * mapWidth + x] = astar.GetCellType(x, y);
+            return;
+        }
+
+        eventCount += (long long)events.size();
+        for (const AStar::CellEvent& event : events)
+            mirror[event.index] = event.type;
+
+        for (int y = 0; y < mapHeight; ++y)
+        {
+            for (int x = 0; x < mapWidth; ++x)
+            {
+                AStar::NodeType expected = astar.GetCellType(x, y);
+                if (mirror[(size_t)y * mapWidth + x] == expected) continue;
+                if (mismatches++ < 5)
+                    printf("%s: (%d,%d) mirror %d, cell %d\n", when, x, y, (int)mirror[(size_t)y * mapWidth + x], (int)expected);
+            }
+        }
+    };
+
+    sync("start");
+    for (int round = 0; round < rounds; ++round)
+    {
+        // 1. 탐색 (중간중간 받아서 열린/닫힌 목록 전이도 확인)
+        astar.SetNodeLimit(round % 5 == 4 ? 2000 : 0);
+        astar.StartPathFinding(RandomWalkableCell(astar), RandomWalkableCell(astar));
+        for (int step = 0; astar.GetState() == AStar::State::SEARCHING; ++step)
+        {
+            astar.UpdatePathFinding();
+            if (step % 97 == 0) sync("search");
+        }
+        sync("finish");
+
+        // 2. 편집 (한 칸 / 사각형 / 브러시 / 전체 교체 / 전체 지우기 / 크기 변경 / 껐다 켜기)
+        int mapWidth = astar.GetMapWidth();
+        int mapHeight = astar.GetMapHeight();
+        int x = std::rand() % mapWidth, y = std::rand() % mapHeight;
+        switch (round % 7)
+        {
+        case 0: astar.SetObstacle(x, y, astar.IsWalkable(x, y)); break;
+        case 1: astar.FillRect(x - 3, y - 3, 7, 5, true); break;
+        case 2: astar.PaintBrush(x, y, 4, false); break;
+        case 3:
+        {
+            std::vector<unsigned long long> wallMask((size_t)mapHeight * ((mapWidth + 63) / 64));
+            for (unsigned long long& word : wallMask)
+                word = ((unsigned long long)std::rand() << 32 | (unsigned long long)std::rand()) & ((unsigned long long)std::rand() << 16 | std::rand());
+            astar.ReplaceObstacles(wallMask);
+            break;
+        }
+        case 4: astar.ClearObstacles(); GenerateCaveMap(astar, seed + round); break;
+        case 5:
+            astar.Initialize(mapWidth == width ? width / 2 + 1 : width, mapHeight);
+            GenerateCaveMap(astar, seed + round);
+            break;
+        case 6: astar.SetCellEventsEnabled(false); astar.SetObstacle(x, y, true); astar.SetCellEventsEnabled(true); break;
+        }
+        sync("edit");
+    }
+
+    printf("%dx%d, %d rounds: %d polls, %d full resyncs, %lld events replayed\n", width, height, rounds, polls, resets, eventCount);
+    printf("%d mismatches\n", mismatches);
+    return mismatches == 0 ? 0 : 2;
+}
+
+// --------------------------------------------------------
+// record: 탐색 하나를 기록해서 파일로 저장
+// --------------------------------------------------------
+static int CommandRecord(int argc, char** argv)
+{
+    if (argc < 4)
+    {
+        printf("usage: record <width> <height> <seed> <trace> [nodeLimit]\n");
+        return 1;
+    }
+
+    int width = atoi(argv[0]);
+    int height = atoi(argv[1]);
+    unsigned int seed = (unsigned int)strtoul(argv[2], nullptr, 10);
+
+    AStar astar(width, height);
+    GenerateCaveMap(astar, seed);
+
+    // 걸을 수 있는 임의의 두 칸 사이를 탐색
+    Point start = RandomWalkableCell(astar);
+    Point end = RandomWalkableCell(astar);
+
+    SearchTraceRecorder recorder;
+    astar.SetNodeLimit((argc >= 5) ? atoi(argv[4]) : 0);
+    astar.SetTraceRecorder(&recorder);
+    astar.StartPathFinding(start, end);
+    while (astar.GetState() == AStar::State::SEARCHING)
+        astar.UpdatePathFinding();
+    astar.SetTraceRecorder(nullptr);
+
+    if (!recorder.Save(argv[3]))
+    {
+        printf("failed to write %s\n", argv[3]);
+        return 1;
+    }
+
+    static const char* resultNames[] = { "EXACT", "PRUNED", "PARTIAL" };
+    printf("(%d,%d) -> (%d,%d) : %s (%s), path %zu cells, %d expansions\n", start.x, start.y, end.x, end.y,
+        astar.GetState() == AStar::State::FINISHED ? "found" : "not found", resultNames[(int)astar.GetBoundResult()],
+        astar.GetPath().size(), astar.GetExpandCount());
+    printf("%zu events, %zu bytes (%.2f bytes/event)\n", recorder.GetEventCount(), recorder.GetByteCount(),
+        recorder.GetEventCount() ? (double)recorder.GetByteCount() / recorder.GetEventCount() : 0.0);
+    return 0;
+}
+
+// --------------------------------------------------------
+// replay: 기록 요약 + 특정 단계 상태
+// --------------------------------------------------------
+static int CommandReplay(int argc, char** argv)
+{
+    if (argc < 1)
+    {
+        printf("usage: replay <trace> [step]\n");
+        return 1;
+    }
+
+    SearchTraceReplay replay;
+    if (!replay.Load(argv[0]))
+    {
+        printf("failed to read %s\n", argv[0]);
+        return 1;
+    }
+
+    printf("map %dx%d, (%d,%d) -> (%d,%d), %zu events\n", replay.GetWidth(), replay.GetHeight(),
+        replay.GetStart().x, replay.GetStart().y, replay.GetEnd().x, replay.GetEnd().y, replay.GetEventCount());
+
+    SearchTraceReplay::Summary summary = replay.Summarize();
+    printf("expansions %zu, pushes %zu, decreases %zu, stale pops %zu, max heap %zu\n",
+        summary.expansions, summary.pushes, summary.decreases, summary.stalePops, summary.maxHeapSize);
+
+    printf("heap size over time:");
+    for (size_t size : summary.heapSamples) printf(" %zu", size);
+    printf("\n");
+
+    printf("revisit hotspots (16x16 tiles):\n");
+    for (const SearchTraceReplay::Hotspot& hotspot : summary.hotspots)
+        printf("  tile (%d,%d) cells (%d,%d)-(%d,%d): %d\n", hotspot.tileX, hotspot.tileY,
+            hotspot.tileX * 16, hotspot.tileY * 16, hotspot.tileX * 16 + 15, hotspot.tileY * 16 + 15, hotspot.revisits);
+
+    if (argc >= 2)
+    {
+        size_t step = (size_t)strtoull(argv[1], nullptr, 10);
+        replay.SeekToExpansion(step);
+        printf("after %zu expansions: open %zu, closed %zu, heap %zu\n",
+            replay.GetExpansionCount(), replay.GetOpenCount(), replay.GetClosedCount(), replay.GetHeapSize());
+    }
+    return 0;
+}
+
+// --------------------------------------------------------
+// snapshot: 작성 스레드가 편집을 발행하는 동안 읽기 스레드들이 잡은 스냅샷으로 탐색
+// --------------------------------------------------------
+
+// 스냅샷의 벽을 AStar 맵으로 옮김 (기준 다익스트라 / CheckPath는 AStar 맵을 읽음)
+static void CopySnapshotWalls(const GridSnapshot& snapshot, AStar& out, std::vector<unsigned long long>& wallMask)
+{
+    int width = snapshot.GetWidth();
+    int height = snapshot.GetHeight();
+    if (out.GetMapWidth() != width || out.GetMapHeight() != height)
+        out.Initialize(width, height);
+
+    size_t wordsPerRow = (size_t)(width + 63) / 64;
+    wallMask.assign(wordsPerRow * height, 0);
+    for (int y = 0; y < height; ++y)
+        for (int x = 0; x < width; ++x)
+            if (!snapshot.IsWalkable(x, y)) wallMask[y * wordsPerRow + x / 64] |= 1ull << (x % 64);
+    out.ReplaceObstacles(wallMask);
+}
+
+static int CommandSnapshot(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        printf("usage: snapshot <width> <height> <seed> [readers] [writers] [ms]\n");
+        return 1;
+    }
+
+    int width = atoi(argv[0]);
+    int height = atoi(argv[1]);
+    unsigned int seed = (unsigned int)strtoul(argv[2], nullptr, 10);
+    int readerCount = (argc >= 4) ? (std::max)(1, atoi(argv[3])) : 4;
+    int writerCount = (argc >= 5) ? (std::max)(1, atoi(argv[4])) : 2;
+    int durationMs = (argc >= 6) ? atoi(argv[5]) : 1000;
+
+    long long tilesBefore = GridSnapshot::GetLiveTileCount();
+    int mismatches = 0;
+    {
+        AStar astar(width, height);
+        GenerateCaveMap(astar, seed);
+        VersionedGrid grid(astar);
+
+        // 실행 내내 잡아두는 첫 스냅샷 (끝에서 처음 벽 그대로인지 확인)
+        std::shared_ptr<const GridSnapshot> pinned = grid.Acquire();
+        AStar pinnedWalls(width, height);
+        std::vector<unsigned long long> pinnedMask;
+        CopySnapshotWalls(*pinned, pinnedWalls, pinnedMask);
+
+        std::atomic<bool> stop{ false };
+        std::atomic<long long> peakTiles{ GridSnapshot::GetLiveTileCount() };
+        std::mutex reportMutex;
+        auto report = [&](const char* format, auto... args)
+        {
+            std::lock_guard<std::mutex> lock(reportMutex);
+            if (mismatches++ < 5) printf(format, args...);
+        };
+
+        // 1. 작성자: 임의 칸 몇 개씩 묶어 발행, 받은 버전 번호를 모아 둠 (작성자끼리 겹치면 안 됨)
+        std::vector<std::vector<unsigned long long>> versions(writerCount + 1); // 마지막: SyncFrom 전체 재구성
+        std::vector<std::thread> threads;
+        for (int w = 0; w < writerCount; ++w)
+        {
+            threads.emplace_back([&, w]()
+            {
+                std::mt19937 random(seed * 7919u + w);
+                std::vector<VersionedGrid::Edit> edits;
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    edits.clear();
+                    int count = 1 + (int)(random() % 8);
+                    for (int e = 0; e < count; ++e)
+                        edits.push_back({ (int)(random() % width), (int)(random() % height), random() % 100 < 40 });
+                    versions[w].push_back(grid.Publish(edits));
+
+                    long long live = GridSnapshot::GetLiveTileCount();
+                    long long peak = peakTiles.load(std::memory_order_relaxed);
+                    while (live > peak && !peakTiles.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+                    std::this_thread::yield(); // 코어가 적어도 읽기 스레드가 돌 수 있게
+                }
+            });
+        }
+
+        // 1-1. AStar 맵을 고치고 SyncFrom으로 따라가는 작성자 (가끔 기록 용량을 넘겨 전체 재구성 -> Publish와 같은 CAS로 발행)
+        threads.emplace_back([&]()
+        {
+            std::mt19937 random(seed * 31u + 17u);
+            for (int round = 0; !stop.load(std::memory_order_relaxed); ++round)
+            {
+                bool rebuild = round % 8 == 7;
+                int count = rebuild ? AStar::MAP_JOURNAL_CAPACITY + 1 : 1 + (int)(random() % 8);
+                for (int e = 0; e < count; ++e)
+                {
+                    int x = (int)(random() % width), y = (int)(random() % height);
+                    astar.SetObstacle(x, y, astar.IsWalkable(x, y));
+                }
+                unsigned long long version = grid.SyncFrom(astar);
+                if (rebuild) versions[writerCount].push_back(version); // 전체 재구성은 항상 새 버전
+                std::this_thread::yield();
+            }
+        });
+
+        // 2. 읽기: 스냅샷을 잡은 직후 벽을 복사해 두고, 탐색이 끝난 뒤 그 복사본 기준으로 경로 검사
+        std::vector<long long> searches(readerCount, 0);
+        for (int r = 0; r < readerCount; ++r)
+        {
+            threads.emplace_back([&, r]()
+            {
+                std::mt19937 random(seed * 104729u + r);
+                SnapshotPathFinder finder;
+                finder.SetHeuristicType(AStar::HeuristicType::OCTILE);
+                AStar walls(width, height);
+                ReferenceDijkstra reference;
+                std::vector<unsigned long long> mask, maskAfter;
+                std::vector<Point> path;
+                unsigned long long lastVersion = 0;
+
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    std::shared_ptr<const GridSnapshot> snapshot = grid.Acquire();
+                    if (snapshot->GetVersion() < lastVersion)
+                        report("reader %d: version went back from %llu to %llu\n", r, lastVersion, snapshot->GetVersion());
+                    lastVersion = snapshot->GetVersion();
+                    CopySnapshotWalls(*snapshot, walls, mask);
+
+                    Point start = { (int)(random() % width), (int)(random() % height) };
+                    Point end = { (int)(random() % width), (int)(random() % height) };
+                    bool found = finder.FindPath(*snapshot, start, end, path);
+
+                    // 탐색하는 동안 발행이 이어졌어도 잡은 스냅샷은 그대로여야 함
+                    CopySnapshotWalls(*snapshot, walls, maskAfter);
+                    if (maskAfter != mask)
+                        report("reader %d: snapshot %llu changed while held\n", r, snapshot->GetVersion());
+
+                    if (!walls.IsWalkable(start.x, start.y) || !walls.IsWalkable(end.x, end.y))
+                    {
+                        if (found) report("reader %d: path from or to a wall\n", r);
+                        continue;
+                    }
+                    reference.Run(walls, start, true);
+                    SearchVerifier::PathError error = SearchVerifier::CheckPath(walls, reference, start, end, found, path, true, 1.0);
+                    if (error != SearchVerifier::PathError::NONE)
+                        report("reader %d: (%d,%d) -> (%d,%d) on version %llu: %s\n", r, start.x, start.y, end.x, end.y,
+                            snapshot->GetVersion(), SearchVerifier::GetErrorName(error));
+                    ++searches[r];
+                }
+            });
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(durationMs));
+        stop.store(true);
+        for (std::thread& thread : threads)
+            thread.join();
+
+        // 3. 발행된 버전 번호는 모두 달라야 함
+        std::vector<unsigned long long> allVersions;
+        for (const auto& list : versions) allVersions.insert(allVersions.end(), list.begin(), list.end());
+        std::sort(allVersions.begin(), allVersions.end());
+        if (std::adjacent_find(allVersions.begin(), allVersions.end()) != allVersions.end())
+            report("two publishes returned the same version\n");
+
+        std::vector<unsigned long long> pinnedAfter;
+        CopySnapshotWalls(*pinned, pinnedWalls, pinnedAfter);
+        if (pinnedAfter != pinnedMask)
+            report("pinned snapshot %llu changed\n", pinned->GetVersion());
+
+        // 4. 회수: 고정 스냅샷을 놓으면 현재 버전의 타일만 남아야 함
+        long long liveWhilePinned = GridSnapshot::GetLiveTileCount() - tilesBefore;
+        pinned.reset();
+        long long live = GridSnapshot::GetLiveTileCount() - tilesBefore;
+        int currentTiles = grid.Acquire()->GetTileCount();
+        if (live != currentTiles)
+            report("%lld tiles alive after release, current version has %d\n", live, currentTiles);
+
+        long long totalSearches = 0;
+        for (long long count : searches) totalSearches += count;
+        printf("%dx%d, %d writers + SyncFrom, %d readers, %d ms: %zu versions published (%zu full rebuilds), %lld searches checked\n",
+            width, height, writerCount, readerCount, durationMs, allVersions.size(), versions[writerCount].size(), totalSearches);
+        printf("tiles: %d per version, peak %lld alive, %lld while the first version was pinned, %lld after release\n",
+            currentTiles, peakTiles.load() - tilesBefore, liveWhilePinned, live);
+    }
+
+    // 5. 그리드를 없애면 타일이 하나도 남지 않아야 함
+    if (GridSnapshot::GetLiveTileCount() != tilesBefore)
+    {
+        if (mismatches++ < 5) printf("%lld tiles leaked\n", GridSnapshot::GetLiveTileCount() - tilesBefore);
+    }
+    printf("%d mismatches\n", mismatches);
+    return mismatches == 0 ? 0 : 2;
+}
+
+// --------------------------------------------------------
+// world: 청크 월드 검증 + 큰 월드 쿼리
+// --------------------------------------------------------
+
+// 노이즈 위에 저장된 타일을 덮어쓰는 저장소 (SaveTile -> LoadTile 왕복 확인용)
+class EditedTileStore : public ITileStore
+{
+public:
+    EditedTileStore(unsigned int seed, int fillPercent) : _noise(seed, fillPercent) {}
+
+    void LoadTile(int tileX, int tileY, unsigned char* walls) override
+    {
+        auto it = _saved.find(Key(tileX, tileY));
+        if (it == _saved.end()) _noise.LoadTile(tileX, tileY, walls);
+        else std::copy(it->second.begin(), it->second.end(), walls);
+    }
+    bool SaveTile(int tileX, int tileY, const unsigned char* walls) override
+    {
+        _saved[Key(tileX, tileY)].assign(walls, walls + TILE_CELLS);
+        return true;
+    }
+    size_t GetSavedCount() const { return _saved.size(); }
+
+private:
+    static long long Key(int tileX, int tileY) { return ((long long)tileY << 32) | (unsigned int)tileX; }
+
+    NoiseTileStore _noise;
+    std::unordered_map<long long, std::vector<unsigned char>> _saved;
+};
+
+// 청크 월드에서 (x, y) 근처의 걸을 수 있는 칸 (못 찾으면 {-1, -1})
+static Point NearestWalkable(ChunkedWorld& world, int x, int y)
+{
+    for (int radius = 0; radius < 64; ++radius)
+    {
+        for (int dy = -radius; dy <= radius; ++dy)
+        {
+            for (int dx = -radius; dx <= radius; ++dx)
+            {
+                if ((std::max)(std::abs(dx), std::abs(dy)) != radius) continue;
+                if (world.IsWalkable(x + dx, y + dy)) return { x + dx, y + dy };
+            }
+        }
+    }
+    return { -1, -1 };
+}
+
+static int CommandWorld(int argc, char** argv)
+{
+    int tilesX = (argc >= 1) ? atoi(argv[0]) : 100000;
+    int tilesY = (argc >= 2) ? atoi(argv[1]) : 100000;
+    unsigned int seed = (argc >= 3) ? (unsigned int)strtoul(argv[2], nullptr, 10) : 1;
+    int queryCount = (argc >= 4) ? atoi(argv[3]) : 10;
+    int distance = (argc >= 5) ? atoi(argv[4]) : 3000;
+    size_t maxTiles = (argc >= 6) ? (size_t)atoi(argv[5]) : 256;
+    const int FILL_PERCENT = 25;
+    if (tilesX < 1 || tilesY < 1 || (long long)tilesX * ChunkedWorld::TILE_SIZE > (std::numeric_limits<int>::max)() ||
+        (long long)tilesY * ChunkedWorld::TILE_SIZE > (std::numeric_limits<int>::max)())
+    {
+        printf("usage: world [tilesX] [tilesY] [seed] [queries] [distance] [maxTiles] (world size must fit in int cells)\n");
+        return 1;
+    }
+
+    std::mt19937 random(seed);
+    int failures = 0;
+
+    // 1. 작은 월드 (8x8 타일, 상주 16개): 편집 -> 내림/저장 -> 다시 읽은 맵으로 AStar와 비교
+    {
+        const int SMALL_TILES = 8;
+        EditedTileStore store(seed, FILL_PERCENT);
+        ChunkedWorld world(store, SMALL_TILES, SMALL_TILES, 16);
+        int size = world.GetWidth();
+
+        // 편집은 마지막 값만 기억해 두고, 내렸다 다시 읽은 뒤에도 남아 있는지 확인
+        std::uniform_int_distribution<int> cell(0, size - 1);
+        std::unordered_map<int, bool> edits;
+        for (int i = 0; i < 2000; ++i)
+        {
+            int x = cell(random), y = cell(random);
+            world.SetObstacle(x, y, i % 2 == 0);
+            edits[y * size + x] = i % 2 == 0;
+        }
+        world.Flush();
+        int lostEdits = 0;
+        for (auto& [index, isWall] : edits)
+            lostEdits += (world.IsWalkable(index % size, index / size) == isWall) ? 1 : 0;
+        if (lostEdits > 0)
+        {
+            printf("  %d edits lost after save / reload\n", lostEdits);
+            ++failures;
+        }
+
+        AStar astar(size, size);
+        int wordsPerRow = (size + 63) / 64;
+        std::vector<unsigned long long> wallMask((size_t)wordsPerRow * size, 0);
+        for (int y = 0; y < size; ++y)
+        {
+            for (int x = 0; x < size; ++x)
+            {
+                if (!world.IsWalkable(x, y)) wallMask[(size_t)y * wordsPerRow + (x >> 6)] |= 1ull << (x & 63);
+            }
+        }
+        astar.ReplaceObstacles(wallMask);
+        astar.SetHeuristicType(AStar::HeuristicType::OCTILE);
+
+        ChunkedAStar chunked;
+        chunked.SetHeuristicType(AStar::HeuristicType::OCTILE);
+        std::vector<Point> chunkedPath;
+        int compared = 0, reachable = 0;
+        for (int q = 0; q < 200; ++q)
+        {
+            Point start = NearestWalkable(world, cell(random), cell(random));
+            Point end = NearestWalkable(world, cell(random), cell(random));
+            if (start.x < 0 || end.x < 0) continue;
+
+            astar.StartPathFinding(start, end);
+            while (astar.GetState() == AStar::State::SEARCHING)
+                astar.UpdatePathFinding();
+            bool found = astar.GetState() == AStar::State::FINISHED;
+            bool chunkedFound = chunked.FindPath(world, start, end, chunkedPath);
+
+            ++compared;
+            reachable += found ? 1 : 0;
+            float cost = found ? (float)SearchVerifier::PathCost(astar.GetPath()) : 0.0f;
+            float chunkedCost = chunkedFound ? (float)SearchVerifier::PathCost(chunkedPath) : 0.0f;
+            if (found != chunkedFound || std::abs(cost - chunkedCost) > 0.01f + cost * 1e-5f)
+            {
+                if (failures < 10)
+                    printf("  mismatch (%d,%d)->(%d,%d): AStar %s %.3f, chunked %s %.3f\n", start.x, start.y, end.x, end.y,
+                        found ? "found" : "failed", cost, chunkedFound ? "found" : "failed", chunkedCost);
+                ++failures;
+            }
+        }
+        printf("small world %dx%d: %zu edits kept, %d queries (%d reachable), %zu tiles saved, %zu loads, %d failures\n",
+            size, size, edits.size() - lostEdits, compared, reachable, store.GetSavedCount(), world.GetLoadCount(), failures);
+    }
+
+    // 2. 저장하지 못하는 저장소 (노이즈만): 편집하는 동안 내림이 일어나도 편집한 타일은 고정되어 남아야 함
+    {
+        const int SMALL_TILES = 8;
+        NoiseTileStore store(seed, FILL_PERCENT);
+        ChunkedWorld world(store, SMALL_TILES, SMALL_TILES, 16);
+        int size = world.GetWidth();
+
+        // 편집 사이사이 다른 타일을 훑어서 상주 한도를 계속 넘기게 함
+        std::uniform_int_distribution<int> cell(0, size - 1);
+        std::unordered_map<int, bool> edits;
+        for (int i = 0; i < 500; ++i)
+        {
+            int x = cell(random), y = cell(random);
+            world.SetObstacle(x, y, i % 2 == 0);
+            edits[y * size + x] = i % 2 == 0;
+            for (int t = 0; t < 4; ++t)
+                world.IsWalkable(cell(random), cell(random));
+        }
+        size_t loadsBefore = world.GetLoadCount();
+        for (int y = 0; y < size; y += ChunkedWorld::TILE_SIZE)
+            for (int x = 0; x < size; x += ChunkedWorld::TILE_SIZE)
+                world.IsWalkable(x, y);
+        world.Flush();
+
+        int lostEdits = 0;
+        for (auto& [index, isWall] : edits)
+            lostEdits += (world.IsWalkable(index % size, index / size) == isWall) ? 1 : 0;
+        if (lostEdits > 0)
+        {
+            printf("  %d edits reverted by eviction\n", lostEdits);
+            ++failures;
+        }
+        printf("unsaved edits %dx%d: %zu edits, %d reverted, %zu pinned tiles, %zu loads (%zu while editing)\n", size, size,
+            edits.size(), lostEdits, world.GetPinnedTileCount(), world.GetLoadCount(), loadsBefore);
+    }
+
+    // 3. 큰 월드: 타일은 처음 닿을 때 노이즈로 생성, 상주 타일은 maxTiles까지만
+    NoiseTileStore store(seed, FILL_PERCENT);
+    ChunkedWorld world(store, tilesX, tilesY, maxTiles);
+    ChunkedAStar chunked;
+    chunked.SetHeuristicType(AStar::HeuristicType::OCTILE);
+    printf("large world %d x %d cells (%lld tiles), max %zu resident tiles\n", world.GetWidth(), world.GetHeight(),
+        (long long)tilesX * tilesY, maxTiles);
+
+    std::uniform_int_distribution<int> columnDist(0, world.GetWidth() - 1);
+    std::uniform_int_distribution<int> rowDist(0, world.GetHeight() - 1);
+    std::uniform_real_distribution<double> angleDist(0.0, 6.283185307179586);
+    std::vector<Point> path;
+    size_t peakStateBytes = 0, peakTiles = 0;
+    int found = 0;
+    double totalMs = 0.0;
+    for (int q = 0; q < queryCount; ++q)
+    {
+        Point start = NearestWalkable(world, columnDist(random), rowDist(random));
+        double angle = angleDist(random);
+        int endX = std::clamp(start.x + (int)(distance * std::cos(angle)), 0, world.GetWidth() - 1);
+        int endY = std::clamp(start.y + (int)(distance * std::sin(angle)), 0, world.GetHeight() - 1);
+        Point end = NearestWalkable(world, endX, endY);
+        if (start.x < 0 || end.x < 0) continue;
+
+        auto begin = std::chrono::steady_clock::now();
+        bool ok = chunked.FindPath(world, start, end, path, 4000000);
+        double ms = ElapsedMs(begin);
+        totalMs += ms;
+        found += ok ? 1 : 0;
+        peakStateBytes = (std::max)(peakStateBytes, chunked.GetStateBytes());
+        peakTiles = (std::max)(peakTiles, chunked.GetTouchedTileCount());
+
+        printf("  (%d,%d)->(%d,%d): %s, cost %.1f, %zu expanded, %zu state tiles (%.1f MB), %zu resident, %.1f ms\n",
+            start.x, start.y, end.x, end.y, ok ? "found" : "failed", ok ? (float)SearchVerifier::PathCost(path) : 0.0f, chunked.GetExpandedCount(),
+            chunked.GetTouchedTileCount(), chunked.GetStateBytes() / (1024.0 * 1024.0), world.GetLoadedTileCount(), ms);
+    }
+    printf("%d/%d found, peak %zu state tiles (%.1f MB), %zu tile loads, %.1f ms total\n", found, queryCount, peakTiles,
+        peakStateBytes / (1024.0 * 1024.0), world.GetLoadCount(), totalMs);
+
+    return failures == 0 ? 0 : 2;
+}
+
+// --------------------------------------------------------
+// cpd: 첫 이동 테이블 전처리 + 쿼리 비교
+// --------------------------------------------------------
+static int CommandCpd(int argc, char** argv)
+{
+    if (argc < 4)
+    {
+        printf("usage: cpd <width> <height> <seed> <file>\n");
+        return 1;
+    }
+
+    int width = atoi(argv[0]);
+    int height = atoi(argv[1]);
+    unsigned int seed = (unsigned int)strtoul(argv[2], nullptr, 10);
+
+    AStar astar(width, height);
+    GenerateCaveMap(astar, seed);
+    astar.SetHeuristicType(AStar::HeuristicType::OCTILE); // 허용 휴리스틱이라 AStar 비용 = 최적 비용 (기준으로 씀)
+
+    // 1. 전처리 (파일이 이미 있고 같은 맵이면 재사용)
+    FirstMoveTable table;
+    auto begin = std::chrono::steady_clock::now();
+    if (table.Load(argv[3], astar))
+    {
+        printf("loaded %s in %.1f ms\n", argv[3], ElapsedMs(begin));
+    }
+    else
+    {
+        table.Build(astar);
+        printf("built in %.1f ms\n", ElapsedMs(begin));
+        if (!table.Save(argv[3])) printf("failed to write %s\n", argv[3]);
+    }
+    printf("%zu runs, %.1f KB\n", table.GetRunCount(), table.GetMemoryBytes() / 1024.0);
+
+    // 2. 같은 쿼리 묶음으로 테이블 조회 vs AStar 비교
+    const int QUERY_COUNT = 1000;
+    std::vector<std::pair<Point, Point>> queries;
+    for (int i = 0; i < QUERY_COUNT; ++i)
+        queries.push_back({ RandomWalkableCell(astar), RandomWalkableCell(astar) });
+
+    std::vector<Point> path;
+    std::vector<float> tableCosts(queries.size(), -1.0f); // -1: 경로 없음
+    size_t tableSteps = 0;
+    begin = std::chrono::steady_clock::now();
+    for (size_t q = 0; q < queries.size(); ++q)
+    {
+        if (!table.ExtractPath(queries[q].first, queries[q].second, path)) continue;
+        tableSteps += path.size();
+        tableCosts[q] = (float)SearchVerifier::PathCost(path);
+    }
+    double tableMs = ElapsedMs(begin);
+
+    size_t astarSteps = 0;
+    std::vector<float> astarCosts(queries.size(), -1.0f);
+    begin = std::chrono::steady_clock::now();
+    for (size_t q = 0; q < queries.size(); ++q)
+    {
+        astar.StartPathFinding(queries[q].first, queries[q].second);
+        while (astar.GetState() == AStar::State::SEARCHING)
+            astar.UpdatePathFinding();
+        if (astar.GetState() != AStar::State::FINISHED) continue;
+        astarSteps += astar.GetPath().size();
+        astarCosts[q] = (float)SearchVerifier::PathCost(astar.GetPath());
+    }
+    double astarMs = ElapsedMs(begin);
+
+    // 3. 쿼리마다 도달 여부 / 비용 비교 + 테이블 경로가 이동 규칙을 지키는지 (시간 측정 밖에서 다시 뽑음)
+    int mismatches = 0;
+    for (size_t q = 0; q < queries.size(); ++q)
+    {
+        const auto& [start, end] = queries[q];
+        bool legal = true;
+        if (tableCosts[q] >= 0.0f && table.ExtractPath(start, end, path))
+        {
+            legal = path.front().x == start.x && path.front().y == start.y && path.back().x == end.x && path.back().y == end.y;
+            for (size_t i = 1; i < path.size() && legal; ++i)
+            {
+                int stepX = path[i].x - path[i - 1].x;
+                int stepY = path[i].y - path[i - 1].y;
+                legal = std::abs(stepX) <= 1 && std::abs(stepY) <= 1 &&
+                    ReferenceDijkstra::CanMove(astar, path[i - 1].x, path[i - 1].y, stepX, stepY, astar.GetAllowDiagonal());
+            }
+        }
+
+        bool sameReach = (tableCosts[q] >= 0.0f) == (astarCosts[q] >= 0.0f);
+        if (sameReach && legal && std::fabs(tableCosts[q] - astarCosts[q]) <= astarCosts[q] * 1e-4f + 0.01f) continue;
+        if (mismatches++ < 5)
+            printf("mismatch (%d,%d) -> (%d,%d): table %.3f%s, AStar %.3f\n", start.x, start.y, end.x, end.y,
+                tableCosts[q], legal ? "" : " (illegal step)", astarCosts[q]);
+    }
+
+    printf("%d queries: table %.3f ms (%.2f us/query, %zu cells), AStar %.3f ms (%zu cells)\n",
+        QUERY_COUNT, tableMs, tableMs * 1000.0 / QUERY_COUNT, tableSteps, astarMs, astarSteps);
+    printf("%d mismatches\n", mismatches);
+    return mismatches == 0 ? 0 : 2;
+}
+
+// --------------------------------------------------------
+// anytime: 시간 조각마다 현재 경로 비용 / 준최적 상한 출력
+// --------------------------------------------------------
+static int CommandAnytime(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        printf("usage: anytime <width> <height> <seed> [sliceUs]\n");
+        return 1;
+    }
+
+    int width = atoi(argv[0]);
+    int height = atoi(argv[1]);
+    unsigned int seed = (unsigned int)strtoul(argv[2], nullptr, 10);
+    int sliceUs = (argc >= 4) ? atoi(argv[3]) : 500;
+
+    AStar astar(width, height);
+    GenerateCaveMap(astar, seed);
+
+    Point start = RandomWalkableCell(astar);
+    Point end = RandomWalkableCell(astar);
+    printf("start (%d, %d) -> end (%d, %d)\n", start.x, start.y, end.x, end.y);
+
+    AnytimeAStar search(astar);
+    search.Start(start, end);
+
+    auto begin = std::chrono::steady_clock::now();
+    int slice = 0;
+    while (search.GetState() == AStar::State::SEARCHING)
+    {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::microseconds(sliceUs);
+        int expanded = search.Run(deadline);
+
+        printf("slice %3d: +%6d expanded, iteration %d, weight %.2f, ", ++slice, expanded,
+            search.GetIterationCount(), search.GetWeight());
+        if (search.HasPath())
+            printf("cost %.3f (<= %.3f x optimal)\n", search.GetPathCost(), search.GetSuboptimalityBound());
+        else
+            printf("no path yet\n");
+    }
+
+    printf("%s after %.1f ms, %d expansions total\n",
+        search.GetState() == AStar::State::FINISHED ? "optimal" : "no path",
+        ElapsedMs(begin), search.GetExpandedCount());
+    return 0;
+}
+
+// --------------------------------------------------------
+// bounded: 노드 상한을 건 탐색 vs 상한 없는 탐색
+// --------------------------------------------------------
+static int CommandBounded(int argc, char** argv)
+{
+    if (argc < 4)
+    {
+        printf("usage: bounded <width> <height> <seed> <limit>\n");
+        return 1;
+    }
+
+    int width = atoi(argv[0]);
+    int height = atoi(argv[1]);
+    unsigned int seed = (unsigned int)strtoul(argv[2], nullptr, 10);
+    int limit = atoi(argv[3]);
+
+    AStar astar(width, height);
+    GenerateCaveMap(astar, seed);
+    astar.SetHeuristicType(AStar::HeuristicType::EUCLIDEAN);
+
+    Point start = RandomWalkableCell(astar);
+    Point end = RandomWalkableCell(astar);
+    printf("start (%d, %d) -> end (%d, %d)\n", start.x, start.y, end.x, end.y);
+
+    static const char* stateNames[] = { "READY", "SEARCHING", "FINISHED", "FAILED" };
+    static const char* resultNames[] = { "EXACT", "PRUNED", "PARTIAL" };
+
+    // 주어진 상한 + 아주 작은 상한들 (작은 값도 올리지 않고 그대로 지켜야 함)
+    int overLimit = 0;
+    for (int nodeLimit : { 0, limit, 1, 8, 9, 10, 16, 63 })
+    {
+        astar.SetNodeLimit(nodeLimit);
+        astar.StartPathFinding(start, end);
+
+        int steps = 0;
+        int peakNodes = 0;
+        while (astar.GetState() == AStar::State::SEARCHING)
+        {
+            astar.UpdatePathFinding();
+            ++steps;
+            peakNodes = (std::max)(peakNodes, astar.GetLiveNodeCount());
+        }
+
+        printf("limit %6d: %-8s %-7s optimal=%d, %d steps, peak %d nodes, path %zu cells\n",
+            astar.GetNodeLimit(), stateNames[(int)astar.GetState()], resultNames[(int)astar.GetBoundResult()],
+            astar.IsPathOptimal() ? 1 : 0, steps, peakNodes, astar.GetPath().size());
+        if (nodeLimit > 0 && (peakNodes > nodeLimit || astar.GetNodeLimit() != nodeLimit))
+        {
+            printf("  limit %d exceeded or changed (%d)\n", nodeLimit, astar.GetNodeLimit());
+            ++overLimit;
+        }
+    }
+    return overLimit == 0 ? 0 : 2;
+}
+
+// --------------------------------------------------------
+// perf: 탐색 단계별 하드웨어 카운터
+// --------------------------------------------------------
+static void PrintPerfRow(const char* label, const PerfCounters& counters, const PerfCounters::Sample& sample, long long expansions)
+{
+    printf("%-10s %9.3f ms", label, sample.milliseconds);
+    if (expansions > 0) printf(" (%.3f us/step)", sample.milliseconds * 1000.0 / expansions);
+
+    if (counters.IsAvailable(PerfCounters::CYCLES) && counters.IsAvailable(PerfCounters::INSTRUCTIONS) && sample.value[PerfCounters::CYCLES] > 0)
+        printf("  IPC %5.2f", (double)sample.value[PerfCounters::INSTRUCTIONS] / sample.value[PerfCounters::CYCLES]);
+
+    // 확장 1회당 값으로 나눠야 단계 / 배치끼리 비교 가능
+    double divisor = (expansions > 0) ? (double)expansions : 1.0;
+    for (int i = 0; i < PerfCounters::EVENT_COUNT; ++i)
+    {
+        PerfCounters::Event event = (PerfCounters::Event)i;
+        if (counters.IsAvailable(event))
+            printf("  %s%s %.1f", PerfCounters::GetEventName(event), expansions > 0 ? "/step" : "", sample.value[i] / divisor);
+    }
+    printf("\n");
+}
+
+static int CommandPerf(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        printf("usage: perf <width> <height> <seed> [queries] [batch]\n");
+        return 1;
+    }
+
+    int width = atoi(argv[0]);
+    int height = atoi(argv[1]);
+    unsigned int seed = (unsigned int)strtoul(argv[2], nullptr, 10);
+    int queryCount = (argc >= 4) ? atoi(argv[3]) : 100;
+    int batchSize = (argc >= 5) ? (std::max)(1, atoi(argv[4])) : 256;
+
+    PerfCounters counters;
+    if (!counters.Open())
+        printf("hardware counters unavailable (%s), timing only\n", counters.GetUnavailableReason());
+
+    AStar astar(width, height);
+    GenerateCaveMap(astar, seed);
+
+    // 배치 번호별 누적 (탐색이 진행될수록 열린 목록 / 노드 맵이 커져서 미스가 느는지 보기 위함)
+    const int MAX_BATCH_ROWS = 16;
+    std::vector<PerfCounters::Sample> batchSamples(MAX_BATCH_ROWS);
+    std::vector<long long> batchSteps(MAX_BATCH_ROWS, 0);
+
+    PerfCounters::Sample startTotal, expandTotal, extractTotal;
+    long long totalSteps = 0;
+    CompactPath path;
+
+    for (int q = 0; q < queryCount; ++q)
+    {
+        Point start = RandomWalkableCell(astar);
+        Point end = RandomWalkableCell(astar);
+
+        // 1. 준비 (이전 노드 반납 포함)
+        counters.Start();
+        astar.StartPathFinding(start, end);
+        startTotal += counters.Stop();
+
+        // 2. 확장: batchSize번씩 묶어서 측정 (호출마다 읽으면 측정 비용이 더 큼)
+        for (int batch = 0; astar.GetState() == AStar::State::SEARCHING; ++batch)
+        {
+            int steps = 0;
+            counters.Start();
+            while (steps < batchSize && astar.GetState() == AStar::State::SEARCHING)
+            {
+                astar.UpdatePathFinding();
+                ++steps;
+            }
+            PerfCounters::Sample sample = counters.Stop();
+
+            expandTotal += sample;
+            totalSteps += steps;
+            int row = (std::min)(batch, MAX_BATCH_ROWS - 1);
+            batchSamples[row] += sample;
+            batchSteps[row] += steps;
+        }
+
+        // 3. 경로 추출
+        counters.Start();
+        astar.GetCompactPath(path);
+        extractTotal += counters.Stop();
+    }
+
+    printf("%d queries, %lld UpdatePathFinding calls, batch %d\n", queryCount, totalSteps, batchSize);
+    PrintPerfRow("start", counters, startTotal, 0);
+    PrintPerfRow("expand", counters, expandTotal, totalSteps);
+    PrintPerfRow("extract", counters, extractTotal, 0);
+
+    printf("expand by batch index (%d+ = rest):\n", MAX_BATCH_ROWS - 1);
+    for (int row = 0; row < MAX_BATCH_ROWS; ++row)
+    {
+        if (batchSteps[row] == 0) continue;
+        char label[16];
+        snprintf(label, sizeof(label), "  #%d", row);
+        PrintPerfRow(label, counters, batchSamples[row], batchSteps[row]);
+    }
+    return 0;
+}
+
+// --------------------------------------------------------
+// simd: 이웃 평가 구현 비교
+// --------------------------------------------------------
+static int CommandSimd(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        printf("usage: simd <width> <height> <seed> [queries]\n");
+        return 1;
+    }
+
+    int width = atoi(argv[0]);
+    int height = atoi(argv[1]);
+    unsigned int seed = (unsigned int)strtoul(argv[2], nullptr, 10);
+    int queryCount = (argc >= 4) ? atoi(argv[3]) : 200;
+
+    AStar astar(width, height);
+    GenerateCaveMap(astar, seed);
+
+    std::vector<std::pair<Point, Point>> queries;
+    for (int i = 0; i < queryCount; ++i)
+        queries.push_back({ RandomWalkableCell(astar), RandomWalkableCell(astar) });
+
+    AStar::SimdLevel best = SimdNeighbors::DetectLevel();
+    printf("cpu supports up to %s\n", SimdNeighbors::GetLevelName(best));
+
+    static const char* heuristicNames[] = { "manhattan", "euclidean", "octile" };
+    int mismatches = 0;
+    for (AStar::HeuristicType type : { AStar::HeuristicType::MANHATTAN, AStar::HeuristicType::EUCLIDEAN, AStar::HeuristicType::OCTILE })
+    {
+        astar.SetHeuristicType(type);
+
+        // 스칼라 결과를 기준으로 경로 / 확장 단계 수가 완전히 같은지 확인
+        std::vector<std::vector<Point>> referencePaths;
+        std::vector<long long> referenceSteps;
+        for (AStar::SimdLevel level : { AStar::SimdLevel::SCALAR, AStar::SimdLevel::SSE2, AStar::SimdLevel::AVX2 })
+        {
+            if (level > best) break;
+            astar.SetSimdLevel(level);
+
+            long long totalSteps = 0;
+            auto begin = std::chrono::steady_clock::now();
+            for (int q = 0; q < queryCount; ++q)
+            {
+                astar.StartPathFinding(queries[q].first, queries[q].second);
+                long long steps = 0;
+                while (astar.GetState() == AStar::State::SEARCHING)
+                {
+                    astar.UpdatePathFinding();
+                    ++steps;
+                }
+                totalSteps += steps;
+
+                if (level == AStar::SimdLevel::SCALAR)
+                {
+                    referencePaths.push_back(astar.GetPath());
+                    referenceSteps.push_back(steps);
+                }
+                else if (astar.GetPath() != referencePaths[q] || steps != referenceSteps[q])
+                {
+                    ++mismatches;
+                }
+            }
+            double ms = ElapsedMs(begin);
+
+            printf("%-9s %-6s: %8.1f ms, %lld steps, %.1f ns/step\n", heuristicNames[(int)type],
+                SimdNeighbors::GetLevelName(level), ms, totalSteps, totalSteps ? ms * 1e6 / totalSteps : 0.0);
+        }
+    }
+
+    printf("%d mismatches against scalar\n", mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
+
+// --------------------------------------------------------
+// swamp: 늪 건너뛰기 효과 측정
+// --------------------------------------------------------
+static int CommandSwamp(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        printf("usage: swamp <width> <height> <seed> [queries] [edits]\n");
+        return 1;
+    }
+
+    int width = atoi(argv[0]);
+    int height = atoi(argv[1]);
+    unsigned int seed = (unsigned int)strtoul(argv[2], nullptr, 10);
+    int queryCount = (argc >= 4) ? atoi(argv[3]) : 500;
+    int editCount = (argc >= 5) ? atoi(argv[4]) : 50;
+
+    AStar astar(width, height);
+    GenerateCaveMap(astar, seed);
+    astar.SetHeuristicType(AStar::HeuristicType::OCTILE); // 최적 경로끼리 비용 비교
+
+    int walkable = 0;
+    for (int y = 0; y < height; ++y)
+        for (int x = 0; x < width; ++x)
+            if (astar.IsWalkable(x, y)) ++walkable;
+
+    SwampMap swamps;
+    auto begin = std::chrono::steady_clock::now();
+    swamps.Build(astar);
+    printf("build %.1f ms: %d swamps, %zu cells (%.1f%% of %d walkable)\n", ElapsedMs(begin),
+        swamps.GetSwampCount(), swamps.GetSwampCellCount(), 100.0 * swamps.GetSwampCellCount() / (std::max)(walkable, 1), walkable);
+
+    // 같은 쿼리를 늪 없이 / 늪 건너뛰기로 돌려서 확장 수와 비용 비교
+    auto runQueries = [&](const char* label)
+    {
+        long long plainSteps = 0, swampSteps = 0, skipped = 0;
+        int mismatches = 0;
+        for (int q = 0; q < queryCount; ++q)
+        {
+            Point start = RandomWalkableCell(astar);
+            Point end = RandomWalkableCell(astar);
+
+            float costs[2] = {};
+            for (int pass = 0; pass < 2; ++pass)
+            {
+                astar.SetSwampMap(pass == 0 ? nullptr : &swamps);
+                astar.StartPathFinding(start, end);
+                long long steps = 0;
+                while (astar.GetState() == AStar::State::SEARCHING)
+                {
+                    astar.UpdatePathFinding();
+                    ++steps;
+                }
+                costs[pass] = astar.GetState() == AStar::State::FINISHED ? (float)SearchVerifier::PathCost(astar.GetPath()) : -1.0f;
+                (pass == 0 ? plainSteps : swampSteps) += steps;
+                if (pass == 1) skipped += astar.GetSwampSkipCount();
+            }
+            if (std::fabs(costs[0] - costs[1]) > 0.01f) ++mismatches;
+        }
+        astar.SetSwampMap(nullptr);
+
+        printf("%s: %d queries, %lld -> %lld steps (%.1f%% avoided), %lld neighbours skipped, %d cost mismatches\n",
+            label, queryCount, plainSteps, swampSteps, plainSteps ? 100.0 * (plainSteps - swampSteps) / plainSteps : 0.0,
+            skipped, mismatches);
+        return mismatches;
+    };
+
+    int mismatches = runQueries("before edits");
+
+    // 편집 후: 다음 탐색 시작에서 편집 근처 늪만 지워짐
+    for (int e = 0; e < editCount; ++e)
+    {
+        Point p = RandomWalkableCell(astar);
+        astar.PaintBrush(p.x, p.y, 1 + std::rand() % 3, (std::rand() % 2) == 0);
+    }
+    int before = swamps.GetSwampCount();
+    int removed = swamps.SyncFrom(astar);
+    printf("%d edits: %d of %d swamps invalidated\n", editCount, removed, before);
+    mismatches += runQueries("after edits");
+
+    return mismatches == 0 ? 0 : 1;
+}
+
+// --------------------------------------------------------
+// parallel: 큰 맵의 긴 쿼리 하나를 여러 스레드로
+// --------------------------------------------------------
+static int CommandParallel(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        printf("usage: parallel <width> <height> <seed> [maxThreads] [queries]\n");
+        return 1;
+    }
+
+    int width = atoi(argv[0]);
+    int height = atoi(argv[1]);
+    unsigned int seed = (unsigned int)strtoul(argv[2], nullptr, 10);
+    int maxThreads = (argc >= 4) ? atoi(argv[3]) : (int)std::thread::hardware_concurrency();
+    int queryCount = (argc >= 5) ? atoi(argv[4]) : 5;
+    maxThreads = (std::max)(maxThreads, 1);
+
+    AStar astar(width, height);
+    GenerateCaveMap(astar, seed);
+    astar.SetHeuristicType(AStar::HeuristicType::OCTILE); // ParallelAStar와 같은 (허용) 휴리스틱
+
+    // 맵 대각선 양쪽 근처에서 출발 / 도착을 골라 긴 쿼리로
+    std::vector<std::pair<Point, Point>> queries;
+    for (int q = 0; q < queryCount; ++q)
+    {
+        Point start = { -1, -1 }, end = { -1, -1 };
+        for (int tries = 0; tries < 10000 && (start.x < 0 || end.x < 0); ++tries)
+        {
+            Point a = { std::rand() % (width / 4 + 1), std::rand() % (height / 4 + 1) };
+            Point b = { width - 1 - std::rand() % (width / 4 + 1), height - 1 - std::rand() % (height / 4 + 1) };
+            if (start.x < 0 && astar.IsWalkable(a.x, a.y)) start = a;
+            if (end.x < 0 && astar.IsWalkable(b.x, b.y)) end = b;
+        }
+        queries.push_back({ start, end });
+    }
+
+    // 1. 기준: 단일 스레드 AStar
+    std::vector<float> expected;
+    auto begin = std::chrono::steady_clock::now();
+    long long serialSteps = 0;
+    for (const auto& [start, end] : queries)
+    {
+        astar.StartPathFinding(start, end);
+        while (astar.GetState() == AStar::State::SEARCHING)
+        {
+            astar.UpdatePathFinding();
+            ++serialSteps;
+        }
+        expected.push_back(astar.GetState() == AStar::State::FINISHED ? (float)SearchVerifier::PathCost(astar.GetPath()) : -1.0f);
+    }
+    double serialMs = ElapsedMs(begin);
+    printf("%d queries on %dx%d, %u hardware threads\n", queryCount, width, height, std::thread::hardware_concurrency());
+    printf("AStar      : %9.1f ms, %lld steps\n", serialMs, serialSteps);
+
+    // 2. 스레드 수를 늘려가며 (1, 2, 4, ... maxThreads)
+    int mismatches = 0;
+    ParallelAStar parallel(astar);
+    std::vector<Point> path;
+    std::vector<int> threadCounts;
+    for (int threads = 1; threads < maxThreads; threads *= 2) threadCounts.push_back(threads);
+    threadCounts.push_back(maxThreads);
+
+    long long oneThreadBusiest = 0; // 1스레드일 때 확장 수 기준으로 가장 바쁜 스레드가 얼마나 줄었는지
+    for (int threads : threadCounts)
+    {
+        parallel.SetThreadCount(threads);
+
+        long long expanded = 0, messages = 0, busiest = 0;
+        begin = std::chrono::steady_clock::now();
+        for (size_t q = 0; q < queries.size(); ++q)
+        {
+            bool found = parallel.FindPath(queries[q].first, queries[q].second, path);
+            float cost = found ? parallel.GetPathCost() : -1.0f;
+            if (std::fabs(cost - expected[q]) > 0.01f || (found && std::fabs((float)SearchVerifier::PathCost(path) - cost) > 0.01f))
+                ++mismatches;
+
+            expanded += parallel.GetExpandedCount();
+            messages += parallel.GetMessageCount();
+            busiest += parallel.GetBusiestExpandedCount(); // 쿼리마다 가장 바쁜 스레드가 걸리는 시간을 정함
+        }
+        double ms = ElapsedMs(begin);
+        if (threads == 1) oneThreadBusiest = busiest;
+        printf("%2d threads : %9.1f ms (x%.2f), %lld expanded, %lld sent (%.0f%%), busiest thread %lld (x%.2f)\n",
+            threads, ms, serialMs / ms, expanded, messages, expanded ? 100.0 * messages / expanded : 0.0, busiest,
+            busiest ? (double)oneThreadBusiest / busiest : 0.0);
+    }
+
+    printf("%d cost mismatches\n", mismatches);
+    return mismatches == 0 ? 0 : 1;
+}
+
+// --------------------------------------------------------
+// watch: 창 없이 BackgroundSearch 프레임 받기 (UI 스레드 흉내)
+// --------------------------------------------------------
+static int CommandWatch(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        printf("usage: watch <width> <height> <seed> [intervalMs] [queries]\n");
+        return 1;
+    }
+
+    int width = atoi(argv[0]);
+    int height = atoi(argv[1]);
+    unsigned int seed = (unsigned int)strtoul(argv[2], nullptr, 10);
+    int intervalMs = (argc >= 4) ? atoi(argv[3]) : 16;
+    int queryCount = (argc >= 5) ? atoi(argv[4]) : 5;
+
+    AStar astar(width, height);
+    GenerateCaveMap(astar, seed);
+
+    std::vector<std::pair<Point, Point>> queries;
+    for (int q = 0; q < queryCount; ++q)
+        queries.push_back({ RandomWalkableCell(astar), RandomWalkableCell(astar) });
+
+    // 1. 기준: 같은 스레드에서 UpdatePathFinding만
+    std::vector<float> expected;
+    long long serialSteps = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for (const auto& [start, end] : queries)
+    {
+        astar.StartPathFinding(start, end);
+        while (astar.GetState() == AStar::State::SEARCHING)
+        {
+            astar.UpdatePathFinding();
+            ++serialSteps;
+        }
+        expected.push_back(astar.GetState() == AStar::State::FINISHED ? (float)SearchVerifier::PathCost(astar.GetPath()) : -1.0f);
+    }
+    double serialMs = ElapsedMs(begin);
+
+    // 2. 뒤 스레드 탐색 + 이 스레드는 1ms마다 새 프레임을 받아 읽기만 (창의 WM_TIMER + Render 역할)
+    BackgroundSearch search;
+    search.SetStepsPerSecond(0);
+    search.SetPublishInterval(intervalMs);
+
+    // 첫 Start의 벽 복사(맵이 같으면 이후로는 생략)는 따로 잼
+    begin = std::chrono::steady_clock::now();
+    search.Start(astar, queries[0].first, queries[0].first);
+    search.Cancel();
+    double copyMs = ElapsedMs(begin);
+    while (search.AcquireFrame()) {}
+
+    int mismatches = 0;
+    long long frames = 0, backgroundSteps = 0, closedSeen = 0;
+    double maxReadMs = 0.0;
+    begin = std::chrono::steady_clock::now();
+    for (size_t q = 0; q < queries.size(); ++q)
+    {
+        search.Start(astar, queries[q].first, queries[q].second);
+
+        bool finished = false;
+        while (!finished)
+        {
+            // 끝났는지 먼저 보고 받아야 마지막 프레임을 놓치지 않음
+            finished = !search.IsRunning();
+
+            auto readBegin = std::chrono::steady_clock::now();
+            if (search.AcquireFrame())
+            {
+                ++frames;
+                const SearchFrame& frame = search.GetFrame();
+                for (unsigned char type : frame.cellTypes)
+                    closedSeen += (type == (unsigned char)AStar::NodeType::CLOSED);
+            }
+            maxReadMs = (std::max)(maxReadMs, ElapsedMs(readBegin));
+
+            if (!finished) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        const SearchFrame& frame = search.GetFrame();
+        float cost = (frame.state == AStar::State::FINISHED) ? (float)SearchVerifier::PathCost(frame.path) : -1.0f;
+        if (frame.searchId == 0 || std::fabs(cost - expected[q]) > 0.01f) ++mismatches;
+        backgroundSteps += frame.stepCount;
+    }
+    double backgroundMs = ElapsedMs(begin);
+
+    printf("%d queries on %dx%d, publish every %d ms\n", queryCount, width, height, intervalMs);
+    printf("same thread : %9.1f ms, %lld steps\n", serialMs, serialSteps);
+    printf("map copy    : %9.1f ms (first Start only)\n", copyMs);
+    printf("background  : %9.1f ms, %lld steps, %lld frames received (%llu published), slowest frame read %.3f ms\n",
+        backgroundMs, backgroundSteps, frames, search.GetPublishedCount(), maxReadMs);
+    printf("mismatches  : %d (closed cells seen across frames: %lld)\n", mismatches, closedSeen);
+    return mismatches == 0 ? 0 : 2;
+}
+
+// --------------------------------------------------------
+// verify: 차등 검증 + 성능 기준선
+// --------------------------------------------------------
+
+// 검증할 탐색 설정 (이름은 기준선 파일의 키라서 바꾸면 기준선도 다시 만들어야 함)
+struct VerifyConfig
+{
+    const char* name;
+    AStar::HeuristicType heuristic;
+    bool allowDiagonal;
+    float weight;
+    AStar::SimdLevel simdLevel; // 지원하는 최고 단계로 낮춰짐
+    bool swampPruning;
+    bool searchTreeReuse;       // 출발점마다 목적지만 바꿔가며 이어서 탐색
+};
+
+static const VerifyConfig g_verifyConfigs[] =
+{
+    { "manhattan-4",     AStar::HeuristicType::MANHATTAN, false, 1.0f, AStar::SimdLevel::AVX2,   false, false },
+    { "manhattan-8",     AStar::HeuristicType::MANHATTAN, true,  1.0f, AStar::SimdLevel::AVX2,   false, false },
+    { "euclidean-4",     AStar::HeuristicType::EUCLIDEAN, false, 1.0f, AStar::SimdLevel::AVX2,   false, false },
+    { "euclidean-8",     AStar::HeuristicType::EUCLIDEAN, true,  1.0f, AStar::SimdLevel::AVX2,   false, false },
+    { "octile-8",        AStar::HeuristicType::OCTILE,    true,  1.0f, AStar::SimdLevel::AVX2,   false, false },
+    { "octile-8-w1.5",   AStar::HeuristicType::OCTILE,    true,  1.5f, AStar::SimdLevel::AVX2,   false, false },
+    { "octile-8-scalar", AStar::HeuristicType::OCTILE,    true,  1.0f, AStar::SimdLevel::SCALAR, false, false },
+    { "octile-8-swamp",  AStar::HeuristicType::OCTILE,    true,  1.0f, AStar::SimdLevel::AVX2,   true,  false },
+    { "octile-8-reuse",  AStar::HeuristicType::OCTILE,    true,  1.0f, AStar::SimdLevel::AVX2,   false, true },
+};
+
+// 맵 종류를 번갈아 가며: 다듬은 동굴 / 성긴 노이즈(막힌 쿼리가 많음) / 덜 다듬은 동굴
+// [수정] GenerateRandomMap(std::rand)과 같은 규칙(가장자리 벽 + fillPercent% 벽)을 mt19937로 직접 만들어 ReplaceObstacles
+static void GenerateVerifyMap(AStar& astar, unsigned int seed, int index)
+{
+    static const int fillPercents[3] = { 47, 30, 47 };
+    static const int smoothCounts[3] = { 4, 0, 1 };
+
+    int width = astar.GetMapWidth();
+    int height = astar.GetMapHeight();
+    int wordsPerRow = (width + 63) / 64;
+    std::vector<unsigned long long> walls((size_t)wordsPerRow * height, 0);
+    std::mt19937 random(seed);
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            bool border = x == 0 || x == width - 1 || y == 0 || y == height - 1;
+            if (border || (int)(random() % 100u) < fillPercents[index % 3])
+                walls[(size_t)y * wordsPerRow + x / 64] |= 1ull << (x % 64);
+        }
+    }
+
+    astar.ReplaceObstacles(walls);
+    for (int i = 0; i < smoothCounts[index % 3]; ++i)
+        astar.SmoothMap();
+}
+
+// 탐색 결과의 CompactPath가 GetPath와 같은 칸들로 풀리는지 (반복자 / ToPoints / 런 바이트 왕복). 맞으면 nullptr
+static const char* CheckCompactPath(const AStar& search, CompactPath& compact, CompactPath& copy, std::vector<Point>& points)
+{
+    const std::vector<Point>& path = search.GetPath();
+    if (!search.GetCompactPath(compact)) return path.empty() ? nullptr : "no compact path";
+    if (compact.GetLength() != (int)path.size()) return "length";
+
+    size_t i = 0;
+    for (Point p : compact)
+    {
+        if (i >= path.size() || p != path[i]) return "iterator";
+        ++i;
+    }
+    if (i != path.size()) return "iterator";
+
+    compact.ToPoints(points);
+    if (points != path) return "ToPoints";
+
+    copy.AssignRuns(compact.GetStart(), compact.GetRunData(), compact.GetRunCount());
+    copy.ToPoints(points);
+    if (points != path) return "AssignRuns";
+    return nullptr;
+}
+
+static int CommandVerify(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        printf("usage: verify <width> <height> <seed> [maps] [starts] [goals] [-baseline file] [-save file] [-notime] [-repeat N] [-time pct] [-expand pct]\n");
+        return 1;
+    }
+
+    int width = atoi(argv[0]);
+    int height = atoi(argv[1]);
+    unsigned int seed = (unsigned int)strtoul(argv[2], nullptr, 10);
+    int counts[3] = { 6, 4, 8 }; // maps, starts, goals
+    int countIndex = 0;
+    const char* baselinePath = nullptr;
+    const char* savePath = nullptr;
+    bool saveTimes = true;
+    int repeat = 3;
+    double timeTolerance = 0.25;
+    double expansionTolerance = 0.01;
+
+    for (int i = 3; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "-baseline" && i + 1 < argc) baselinePath = argv[++i];
+        else if (arg == "-save" && i + 1 < argc) savePath = argv[++i];
+        else if (arg == "-notime") saveTimes = false;
+        else if (arg == "-repeat" && i + 1 < argc) repeat = (std::max)(1, atoi(argv[++i]));
+        else if (arg == "-time" && i + 1 < argc) timeTolerance = atof(argv[++i]) / 100.0;
+        else if (arg == "-expand" && i + 1 < argc) expansionTolerance = atof(argv[++i]) / 100.0;
+        else if (countIndex < 3) counts[countIndex++] = (std::max)(1, atoi(argv[i]));
+    }
+    int mapCount = counts[0], startCount = counts[1], goalCount = counts[2];
+
+    const int configCount = (int)(sizeof(g_verifyConfigs) / sizeof(g_verifyConfigs[0]));
+    std::vector<long long> expansions(configCount, 0);
+    std::vector<double> milliseconds(configCount, 0.0);
+    std::vector<int> failures(configCount, 0);
+    int queryCount = 0, unreachableCount = 0, printedFailures = 0;
+
+    ReferenceDijkstra referenceDiagonal, referenceStraight;
+    CompactPath compact, compactCopy;
+    std::vector<Point> compactPoints;
+    for (int m = 0; m < mapCount; ++m)
+    {
+        unsigned int mapSeed = seed + (unsigned int)m;
+        AStar map(width, height);
+        GenerateVerifyMap(map, mapSeed, m);
+
+        // 1. 쿼리: 출발점마다 목적지 여러 개 (트리 재사용 설정이 이어서 탐색할 수 있게)
+        std::mt19937 random(mapSeed * 7919u + 1u);
+        std::vector<Point> starts, goals;
+        for (int s = 0; s < startCount; ++s) starts.push_back(RandomWalkableCell(map, random));
+        for (int g = 0; g < startCount * goalCount; ++g) goals.push_back(RandomWalkableCell(map, random));
+        if (starts[0].x < 0) continue; // 걸을 수 있는 칸이 없는 맵
+
+        // 2. 설정마다 맵을 새로 만들어 (repeat번 중 가장 빠른 시간, 검사는 첫 번째만)
+        for (int c = 0; c < configCount; ++c)
+        {
+            const VerifyConfig& config = g_verifyConfigs[c];
+            double bound = SearchVerifier::GetCostBound(config.heuristic, config.allowDiagonal, config.weight);
+            double bestMs = 0.0;
+
+            for (int r = 0; r < repeat; ++r)
+            {
+                SwampMap swamps;
+                AStar search(width, height);
+                GenerateVerifyMap(search, mapSeed, m);
+                search.SetHeuristicType(config.heuristic);
+                search.SetAllowDiagonal(config.allowDiagonal);
+                search.SetHeuristicWeight(config.weight);
+                search.SetSimdLevel(config.simdLevel);
+                search.SetSearchTreeReuse(config.searchTreeReuse);
+                if (config.swampPruning)
+                {
+                    swamps.Build(search); // 전처리는 시간에 넣지 않음
+                    search.SetSwampMap(&swamps);
+                }
+
+                double ms = 0.0;
+                long long expanded = 0;
+                for (int s = 0; s < startCount; ++s)
+                {
+                    Point start = starts[s];
+                    ReferenceDijkstra& reference = config.allowDiagonal ? referenceDiagonal : referenceStraight;
+                    if (r == 0) reference.Run(map, start, config.allowDiagonal);
+
+                    for (int g = 0; g < goalCount; ++g)
+                    {
+                        Point end = goals[s * goalCount + g];
+                        auto begin = std::chrono::steady_clock::now();
+                        search.StartPathFinding(start, end);
+                        while (search.GetState() == AStar::State::SEARCHING)
+                            search.UpdatePathFinding();
+                        ms += ElapsedMs(begin);
+                        expanded += search.GetExpandCount();
+
+                        if (r != 0) continue;
+                        if (c == 0)
+                        {
+                            ++queryCount;
+                            unreachableCount += reference.IsReachable(end.x, end.y) ? 0 : 1;
+                        }
+
+                        bool found = search.GetState() == AStar::State::FINISHED;
+                        const char* compactError = CheckCompactPath(search, compact, compactCopy, compactPoints);
+                        if (compactError)
+                        {
+                            ++failures[c];
+                            if (printedFailures++ < 10)
+                                printf("FAIL %-16s map %d (seed %u) (%d,%d)->(%d,%d): compact path %s differs from GetPath\n",
+                                    config.name, m, mapSeed, start.x, start.y, end.x, end.y, compactError);
+                        }
+
+                        SearchVerifier::PathError error = SearchVerifier::CheckPath(map, reference, start, end,
+                            found, search.GetPath(), config.allowDiagonal, bound);
+                        if (error == SearchVerifier::PathError::NONE) continue;
+
+                        ++failures[c];
+                        if (printedFailures++ < 10)
+                        {
+                            printf("FAIL %-16s map %d (seed %u) (%d,%d)->(%d,%d): %s, cost %.3f, optimal %.3f, bound x%.4f\n",
+                                config.name, m, mapSeed, start.x, start.y, end.x, end.y, SearchVerifier::GetErrorName(error),
+                                found ? SearchVerifier::PathCost(search.GetPath()) : -1.0,
+                                reference.IsReachable(end.x, end.y) ? reference.GetCost(end.x, end.y) : -1.0, bound);
+                        }
+                    }
+                }
+
+                if (r == 0)
+                {
+                    bestMs = ms;
+                    expansions[c] += expanded;
+                }
+                bestMs = (std::min)(bestMs, ms);
+            }
+            milliseconds[c] += bestMs;
+        }
+    }
+
+    // 3. 결과 + 기준선 비교
+    char params[128];
+    snprintf(params, sizeof(params), "%d %d %u %d %d %d", width, height, seed, mapCount, startCount, goalCount);
+    SearchBaseline current;
+    current.SetParams(params);
+    for (int c = 0; c < configCount; ++c)
+        current.Set(g_verifyConfigs[c].name, expansions[c], milliseconds[c]);
+
+    SearchBaseline baseline;
+    bool compare = false;
+    if (baselinePath)
+    {
+        if (!baseline.Load(baselinePath))
+            printf("baseline %s: cannot read, skipping comparison\n", baselinePath);
+        else if (baseline.GetParams() != current.GetParams())
+            printf("baseline %s: recorded with params \"%s\", this run is \"%s\", skipping comparison\n",
+                baselinePath, baseline.GetParams().c_str(), params);
+        else
+            compare = true;
+    }
+
+    printf("%d maps %dx%d, %d queries per setting (%d unreachable), best of %d\n",
+        mapCount, width, height, queryCount, unreachableCount, repeat);
+    printf("%-16s %8s %12s %10s %s\n", "setting", "failures", "expanded", "ms", compare ? "vs baseline" : "");
+    int totalFailures = 0;
+    for (int c = 0; c < configCount; ++c)
+    {
+        totalFailures += failures[c];
+        printf("%-16s %8d %12lld %10.1f", g_verifyConfigs[c].name, failures[c], expansions[c], milliseconds[c]);
+        const SearchBaseline::Entry* base = compare ? baseline.Find(g_verifyConfigs[c].name) : nullptr;
+        if (base)
+        {
+            printf(" expanded %+.1f%%",
+                base->expansions ? 100.0 * (expansions[c] - base->expansions) / base->expansions : 0.0);
+            if (base->milliseconds > 0.0)
+                printf(", time %+.1f%%", 100.0 * (milliseconds[c] - base->milliseconds) / base->milliseconds);
+        }
+        printf("\n");
+    }
+
+    std::vector<SearchBaseline::Regression> regressions;
+    if (compare)
+        regressions = baseline.Compare(current, expansionTolerance, timeTolerance);
+    for (const SearchBaseline::Regression& regression : regressions)
+    {
+        printf("REGRESSION %-16s %s %.1f -> %.1f (limit +%.0f%%)\n", regression.name.c_str(),
+            regression.expansions ? "expanded" : "ms", regression.baseline, regression.current,
+            100.0 * (regression.expansions ? expansionTolerance : timeTolerance));
+    }
+
+    if (savePath)
+    {
+        if (current.Save(savePath, saveTimes)) printf("baseline saved to %s\n", savePath);
+        else printf("baseline %s: cannot write\n", savePath);
+    }
+
+    if (totalFailures > 0) return 2;
+    return regressions.empty() ? 0 : 3;
+}
+
+// --------------------------------------------------------
+// coop: 다중 에이전트 계획 (틱마다 창의 절반만 진행하고 다시 계획)
+// --------------------------------------------------------
+static int CommandCoop(int argc, char** argv)
+{
+    if (argc < 4)
+    {
+        printf("usage: coop <width> <height> <seed> <agents> [window] [ticks]\n");
+        return 1;
+    }
+
+    int width = atoi(argv[0]);
+    int height = atoi(argv[1]);
+    unsigned int seed = (unsigned int)strtoul(argv[2], nullptr, 10);
+    int agentCount = atoi(argv[3]);
+    int window = (argc >= 5) ? atoi(argv[4]) : CooperativeAStar::DEFAULT_WINDOW;
+    int maxTicks = (argc >= 6) ? atoi(argv[5]) : 200;
+
+    AStar astar(width, height);
+    GenerateCaveMap(astar, seed);
+
+    // 출발 칸끼리, 목표 칸끼리 겹치지 않게 배치 (서로 다른 동굴에 떨어진 쌍은 제외)
+    DistanceTable distances(astar);
+    std::vector<CooperativeAStar::Agent> agents;
+    std::vector<char> startUsed((size_t)width * height, 0);
+    std::vector<char> goalUsed((size_t)width * height, 0);
+    for (int tries = 0; (int)agents.size() < agentCount && tries < agentCount * 100; ++tries)
+    {
+        Point start = RandomWalkableCell(astar);
+        Point goal = RandomWalkableCell(astar);
+        if (start.x < 0 || goal.x < 0) break;
+        if (startUsed[start.y * width + start.x] || goalUsed[goal.y * width + goal.x]) continue;
+        if (std::isinf(distances.OneToMany(start, { goal })[0])) continue;
+        startUsed[start.y * width + start.x] = 1;
+        goalUsed[goal.y * width + goal.x] = 1;
+        agents.push_back({ start, goal });
+    }
+    printf("%d agents, window %d\n", (int)agents.size(), window);
+
+    CooperativeAStar planner(astar);
+    planner.SetWindow(window);
+    // [수정] 거리 필드 캐시는 에이전트 수와 상관없이 고정 용량 (필드는 탐색이 닿은 블록만 쓰므로 대부분 이 안에 들어감)
+    planner.SetHeuristicCacheBytes(128 * 1024 * 1024);
+    int step = (std::max)(1, window / 2);
+
+    std::vector<std::vector<Point>> paths;
+    std::vector<int> cellOwner((size_t)width * height, -1);
+    long long conflicts = 0;
+    double totalMs = 0.0;
+    int tick = 0;
+    for (; tick < maxTicks; ++tick)
+    {
+        int arrived = 0;
+        for (const CooperativeAStar::Agent& agent : agents)
+            if (agent.start.x == agent.goal.x && agent.start.y == agent.goal.y) ++arrived;
+        if (arrived == (int)agents.size()) break;
+
+        auto begin = std::chrono::steady_clock::now();
+        int failed = planner.PlanAgents(agents, paths);
+        double ms = ElapsedMs(begin);
+        totalMs += ms;
+
+        // step 틱만큼 진행하면서 같은 칸 / 자리 맞바꾸기 충돌 검사
+        long long conflictsBefore = conflicts;
+        auto at = [&paths](int i, int t) { return paths[i][(std::min)(t, (int)paths[i].size() - 1)]; };
+        for (int t = 1; t <= step; ++t)
+        {
+            for (int i = 0; i < (int)agents.size(); ++i)
+            {
+                Point p = at(i, t);
+                int& owner = cellOwner[p.y * width + p.x];
+                if (owner >= 0)
+                {
+                    ++conflicts;
+                    continue;
+                }
+                owner = i;
+
+                // i와 j가 t-1 -> t에 서로 자리를 바꿨는지 (j는 t에 i의 이전 칸에 있음)
+                Point previous = at(i, t - 1);
+                for (int j = 0; j < i; ++j)
+                {
+                    Point other = at(j, t);
+                    Point otherPrevious = at(j, t - 1);
+                    if (other.x == previous.x && other.y == previous.y &&
+                        otherPrevious.x == p.x && otherPrevious.y == p.y && (p.x != previous.x || p.y != previous.y))
+                        ++conflicts;
+                }
+            }
+            for (int i = 0; i < (int)agents.size(); ++i)
+            {
+                Point p = at(i, t);
+                cellOwner[p.y * width + p.x] = -1;
+            }
+        }
+
+        for (int i = 0; i < (int)agents.size(); ++i)
+            agents[i].start = at(i, step);
+
+        if (tick % 10 == 0 || failed > 0 || conflicts > conflictsBefore)
+        {
+            printf("tick %3d: %d / %d arrived, plan %.2f ms, %d expanded, %zu reservations, %d failed, %lld conflicts\n",
+                tick, arrived, (int)agents.size(), ms, planner.GetExpandedCount(), planner.GetReservationCount(), failed,
+                conflicts - conflictsBefore);
+        }
+    }
+
+    int arrived = 0;
+    for (const CooperativeAStar::Agent& agent : agents)
+        if (agent.start.x == agent.goal.x && agent.start.y == agent.goal.y) ++arrived;
+    printf("%d / %d arrived after %d ticks (%d steps), avg plan %.2f ms, %lld conflicts\n",
+        arrived, (int)agents.size(), tick, tick * step, tick ? totalMs / tick : 0.0, conflicts);
+    return conflicts == 0 ? 0 : 2;
+}
+
+// --------------------------------------------------------
+// serve: 길찾기 데몬
+// --------------------------------------------------------
+static int CommandServe(int argc, char** argv)
+{
+    if (argc < 4)
+    {
+        printf("usage: serve <socket> <width> <height> <seed> [seed...] [-workers N] [-batch N] [-window us]\n");
+        return 1;
+    }
+
+    int width = atoi(argv[1]);
+    int height = atoi(argv[2]);
+    int workerCount = (std::max)(1, (int)std::thread::hardware_concurrency());
+    int maxBatch = 32;
+    int windowMicros = 200;
+    std::vector<unsigned int> seeds;
+
+    for (int i = 3; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "-workers" && i + 1 < argc) workerCount = atoi(argv[++i]);
+        else if (arg == "-batch" && i + 1 < argc) maxBatch = atoi(argv[++i]);
+        else if (arg == "-window" && i + 1 < argc) windowMicros = atoi(argv[++i]);
+        else seeds.push_back((unsigned int)strtoul(argv[i], nullptr, 10));
+    }
+
+    // 맵은 여기서 한 번만 만들고 서버가 불변 스냅샷으로 보관
+    PathServer server(workerCount, maxBatch, windowMicros);
+    for (unsigned int seed : seeds)
+    {
+        AStar astar(width, height);
+        GenerateCaveMap(astar, seed);
+        int mapId = server.AddMap(astar);
+        if (mapId < 0)
+        {
+            printf("cannot serve seed %u: %s\n", seed, server.GetError().c_str());
+            return 1;
+        }
+        printf("map %d: %dx%d seed %u\n", mapId, width, height, seed);
+    }
+
+    if (!server.Start(argv[0]))
+    {
+        printf("failed to start: %s\n", server.GetError().c_str());
+        return 1;
+    }
+    printf("listening on %s (%d workers, batch %d, window %d us)\n", argv[0], workerCount, maxBatch, windowMicros);
+    fflush(stdout);
+
+    // 5초마다 누적 통계 (종료는 프로세스를 끄는 것으로)
+    PathServer::Stats last;
+    while (true)
+    {
+        std::this_thread::sleep_for(std::chrono::seconds(5));
+        PathServer::Stats stats = server.GetStats();
+        unsigned long long requests = stats.requests - last.requests;
+        if (requests > 0)
+        {
+            printf("%llu requests in %llu batches, avg queue %.1f us, avg search %.1f us (max %llu / %llu us)\n",
+                requests, stats.batches - last.batches,
+                (double)(stats.queueMicros - last.queueMicros) / requests,
+                (double)(stats.searchMicros - last.searchMicros) / requests,
+                stats.maxQueueMicros, stats.maxSearchMicros);
+        }
+        last = stats;
+        fflush(stdout);
+    }
+}
+
+// --------------------------------------------------------
+// loadgen: serve용 부하 생성기
+// --------------------------------------------------------
+static int CommandLoadGen(int argc, char** argv)
+{
+    if (argc < 4)
+    {
+        printf("usage: loadgen <socket> <width> <height> <seed> [connections] [requests] [inflight]\n");
+        return 1;
+    }
+
+    int width = atoi(argv[1]);
+    int height = atoi(argv[2]);
+    unsigned int seed = (unsigned int)strtoul(argv[3], nullptr, 10);
+    int connectionCount = (argc >= 5) ? (std::max)(1, atoi(argv[4])) : 4;
+    int requestCount = (argc >= 6) ? (std::max)(1, atoi(argv[5])) : 10000;
+    int inflight = (argc >= 7) ? (std::max)(1, atoi(argv[6])) : 8;
+
+    // 서버와 같은 맵을 만들어 걸을 수 있는 칸끼리만 요청 (요청은 미리 다 만들어 둠)
+    AStar astar(width, height);
+    GenerateCaveMap(astar, seed);
+    std::vector<PathProtocol::Request> requests(requestCount);
+    for (int i = 0; i < requestCount; ++i)
+        requests[i] = { (unsigned int)i, 0, RandomWalkableCell(astar), RandomWalkableCell(astar) };
+
+    std::vector<double> latencyMicros(requestCount, 0.0);
+    std::vector<PathProtocol::Response> responses(requestCount);
+    std::atomic<int> failedConnections{ 0 };
+
+    // 연결마다 스레드 하나: 요청 inflight개를 띄워두고 응답 하나 받을 때마다 하나 더 보냄
+    auto begin = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int c = 0; c < connectionCount; ++c)
+    {
+        threads.emplace_back([&, c]
+        {
+            PathClient client;
+            if (!client.Connect(argv[0]))
+            {
+                ++failedConnections;
+                return;
+            }
+
+            std::vector<std::chrono::steady_clock::time_point> sentAt(requestCount);
+            std::vector<int> mine;
+            for (int i = c; i < requestCount; i += connectionCount) mine.push_back(i);
+
+            size_t nextSend = 0;
+            size_t received = 0;
+            auto sendOne = [&]
+            {
+                int id = mine[nextSend++];
+                sentAt[id] = std::chrono::steady_clock::now();
+                return client.Send(&requests[id], 1);
+            };
+
+            while (nextSend < mine.size() && nextSend < (size_t)inflight)
+                sendOne();
+
+            PathProtocol::Response response;
+            while (received < mine.size())
+            {
+                if (!client.Receive(response))
+                {
+                    ++failedConnections;
+                    return;
+                }
+                ++received;
+                if (response.id < (unsigned int)requestCount)
+                {
+                    latencyMicros[response.id] = std::chrono::duration<double, std::micro>(
+                        std::chrono::steady_clock::now() - sentAt[response.id]).count();
+                    responses[response.id] = response;
+                }
+                if (nextSend < mine.size()) sendOne();
+            }
+        });
+    }
+    for (std::thread& thread : threads) thread.join();
+    double totalMs = ElapsedMs(begin);
+
+    if (failedConnections > 0)
+    {
+        printf("%d connections failed (is the server running on %s?)\n", failedConnections.load(), argv[0]);
+        return 1;
+    }
+
+    // 결과 요약
+    int okCount = 0;
+    double queueSum = 0.0, searchSum = 0.0;
+    size_t runBytes = 0;
+    for (const PathProtocol::Response& response : responses)
+    {
+        if (response.status == PathProtocol::Status::OK) ++okCount;
+        queueSum += response.queueMicros;
+        searchSum += response.searchMicros;
+        runBytes += response.path.GetRunCount();
+    }
+
+    std::vector<double> sorted = latencyMicros;
+    std::sort(sorted.begin(), sorted.end());
+    auto percentile = [&sorted](double p) { return sorted[(size_t)((sorted.size() - 1) * p)]; };
+
+    printf("%d requests over %d connections (inflight %d): %.1f ms, %.0f req/s\n",
+        requestCount, connectionCount, inflight, totalMs, requestCount * 1000.0 / totalMs);
+    printf("found %d / %d, avg %.1f run bytes per path\n", okCount, requestCount, okCount ? (double)runBytes / okCount : 0.0);
+    printf("round trip us: p50 %.1f  p90 %.1f  p99 %.1f  max %.1f\n",
+        percentile(0.5), percentile(0.9), percentile(0.99), sorted.back());
+    printf("server us: avg queue %.1f  avg search %.1f\n", queueSum / requestCount, searchSum / requestCount);
+    return 0;
+}
+
+// --------------------------------------------------------
+// 진입점
+// --------------------------------------------------------
+struct Command
+{
+    const char* name;
+    int (*func)(int argc, char** argv);
+};
+
+static const Command g_commands[] =
+{
+    { "flow", CommandFlow },
+    { "distance", CommandDistance },
+    { "render", CommandRender },
+    { "events", CommandEvents },
+    { "record", CommandRecord },
+    { "replay", CommandReplay },
+    { "snapshot", CommandSnapshot },
+    { "world", CommandWorld },
+    { "cpd", CommandCpd },
+    { "anytime", CommandAnytime },
+    { "bounded", CommandBounded },
+    { "perf", CommandPerf },
+    { "simd", CommandSimd },
+    { "swamp", CommandSwamp },
+    { "parallel", CommandParallel },
+    { "watch", CommandWatch },
+    { "verify", CommandVerify },
+    { "coop", CommandCoop },
+    { "serve", CommandServe },
+    { "loadgen", CommandLoadGen },
+};
+
+int main(int argc, char** argv)
+{
+    if (argc >= 2)
+    {
+        for (const Command& command : g_commands)
+        {
+            if (std::string(argv[1]) == command.name)
+                return command.func(argc - 2, argv + 2);
+        }
+    }
+
+    printf("usage: AstarTool <command> [args...]\n");
+    printf("commands:");
+    for (const Command& command : g_commands) printf(" %s", command.name);
+    printf("\n");
+    return 1;
+}
@@ -0,0 +1,546 @@
+﻿#include "MemoryPool.h"
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <chrono>
+#include "AStar.h"
+#include "VersionedGrid.h"
+#include "CompactPath.h"
+#include "SearchVerifier.h"
+#include "PathService.h"
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <afunix.h>
+#pragma comment(lib, "ws2_32.lib")
+using SocketHandle = SOCKET;
+static const SocketHandle INVALID_HANDLE = INVALID_SOCKET;
+static void CloseSocket(SocketHandle s) { closesocket(s); }
+static void ShutdownSocket(SocketHandle s) { shutdown(s, SD_BOTH); }
+#else
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+using SocketHandle = int;
+static const SocketHandle INVALID_HANDLE = -1;
+static void CloseSocket(SocketHandle s) { close(s); }
+static void ShutdownSocket(SocketHandle s) { shutdown(s, SHUT_RDWR); }
+#endif
+
+#ifdef MSG_NOSIGNAL
+static const int SEND_FLAGS = MSG_NOSIGNAL; // 끊긴 연결에 보내도 SIGPIPE로 죽지 않도록
+#else
+static const int SEND_FLAGS = 0;
+#endif
+
+namespace
+{
+    // 헤더에는 OS 타입을 노출하지 않으므로 long long으로 들고 다님
+    SocketHandle ToHandle(long long value) { return (SocketHandle)value; }
+    long long FromHandle(SocketHandle handle) { return (handle == INVALID_HANDLE) ? -1 : (long long)handle; }
+
+    bool InitializeSockets()
+    {
+#ifdef _WIN32
+        static bool initialized = false;
+        if (!initialized)
+        {
+            WSADATA data;
+            if (WSAStartup(MAKEWORD(2, 2), &data) != 0) return false;
+            initialized = true;
+        }
+#endif
+        return true;
+    }
+
+    bool MakeAddress(const char* path, sockaddr_un& address)
+    {
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (std::strlen(path) >= sizeof(address.sun_path)) return false;
+        std::memcpy(address.sun_path, path, std::strlen(path) + 1);
+        return true;
+    }
+
+    bool SendAll(SocketHandle s, const unsigned char* data, size_t size)
+    {
+        while (size > 0)
+        {
+            int sent = send(s, (const char*)data, (int)(std::min)(size, (size_t)1 << 20), SEND_FLAGS);
+            if (sent <= 0) return false;
+            data += sent;
+            size -= sent;
+        }
+        return true;
+    }
+
+    // 리틀 엔디언 읽기/쓰기
+    void Put16(unsigned char* p, unsigned int v) { p[0] = (unsigned char)v; p[1] = (unsigned char)(v >> 8); }
+    void Put32(unsigned char* p, unsigned int v) { Put16(p, v & 0xFFFF); Put16(p + 2, v >> 16); }
+    unsigned int Get16(const unsigned char* p) { return p[0] | (p[1] << 8); }
+    unsigned int Get32(const unsigned char* p) { return Get16(p) | (Get16(p + 2) << 16); }
+
+    unsigned int ElapsedMicros(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to)
+    {
+        return (unsigned int)std::chrono::duration_cast<std::chrono::microseconds>(to - from).count();
+    }
+}
+
+// -----------------------------------------------------------
+// PathProtocol
+// -----------------------------------------------------------
+bool PathProtocol::EncodeRequest(const Request& request, unsigned char* out)
+{
+    // [수정] i16으로 잘려서 다른 칸을 묻는 일이 없도록
+    for (int coord : { request.start.x, request.start.y, request.end.x, request.end.y })
+    {
+        if (coord < -MAX_COORD - 1 || coord > MAX_COORD) return false;
+    }
+
+    Put32(out, request.id);
+    Put16(out + 4, request.mapId);
+    Put16(out + 6, 0);
+    Put16(out + 8, (unsigned short)request.start.x);
+    Put16(out + 10, (unsigned short)request.start.y);
+    Put16(out + 12, (unsigned short)request.end.x);
+    Put16(out + 14, (unsigned short)request.end.y);
+    return true;
+}
+
+void PathProtocol::DecodeRequest(const unsigned char* in, Request& out)
+{
+    out.id = Get32(in);
+    out.mapId = (unsigned short)Get16(in + 4);
+    out.start = { (short)Get16(in + 8), (short)Get16(in + 10) };
+    out.end = { (short)Get16(in + 12), (short)Get16(in + 14) };
+}
+
+void PathProtocol::AppendResponse(const Response& response, std::vector<unsigned char>& out)
+{
+    // [수정] runCount는 u16. 넘치면 잘린 값으로 프레이밍이 깨지므로 런 없이 상태로 알림
+    bool tooLong = response.path.GetRunCount() > MAX_RUN_COUNT;
+    size_t runCount = tooLong ? 0 : response.path.GetRunCount();
+    size_t offset = out.size();
+    out.resize(offset + RESPONSE_HEADER_SIZE + runCount);
+
+    unsigned char* p = &out[offset];
+    unsigned int costBits;
+    std::memcpy(&costBits, &response.cost, sizeof(costBits));
+
+    Put32(p, response.id);
+    p[4] = (unsigned char)(tooLong ? Status::PATH_TOO_LONG : response.status);
+    p[5] = 0;
+    Put16(p + 6, (unsigned int)runCount);
+    Put16(p + 8, tooLong ? 0 : (unsigned short)response.path.GetStart().x);
+    Put16(p + 10, tooLong ? 0 : (unsigned short)response.path.GetStart().y);
+    Put32(p + 12, tooLong ? 0 : (unsigned int)response.path.GetLength());
+    Put32(p + 16, costBits);
+    Put32(p + 20, response.queueMicros);
+    Put32(p + 24, response.searchMicros);
+    if (runCount > 0)
+        std::memcpy(p + RESPONSE_HEADER_SIZE, response.path.GetRunData(), runCount);
+}
+
+size_t PathProtocol::DecodeResponse(const unsigned char* in, size_t size, Response& out)
+{
+    if (size < (size_t)RESPONSE_HEADER_SIZE) return 0;
+    size_t runCount = Get16(in + 6);
+    if (size < RESPONSE_HEADER_SIZE + runCount) return 0;
+
+    unsigned int costBits = Get32(in + 16);
+    out.id = Get32(in);
+    out.status = (Status)in[4];
+    std::memcpy(&out.cost, &costBits, sizeof(costBits));
+    out.queueMicros = Get32(in + 20);
+    out.searchMicros = Get32(in + 24);
+
+    if (Get32(in + 12) == 0)
+        out.path.Clear();
+    else
+        out.path.AssignRuns({ (short)Get16(in + 8), (short)Get16(in + 10) }, in + RESPONSE_HEADER_SIZE, runCount);
+    return RESPONSE_HEADER_SIZE + runCount;
+}
+
+// -----------------------------------------------------------
+// PathServer
+// -----------------------------------------------------------
+struct PathServer::Connection
+{
+    SocketHandle socket = INVALID_HANDLE;
+    std::mutex sendMutex; // 여러 작업 스레드가 같은 연결로 응답을 보낼 수 있음
+    std::thread reader;
+    std::atomic<bool> finished{ false }; // 읽기 스레드 종료 (정리 대상)
+
+    // 소켓은 마지막 참조(처리 중인 요청 포함)가 사라질 때 닫음
+    // -> 끊긴 연결의 늦은 응답이 같은 번호를 재사용한 새 연결로 가는 일이 없음
+    ~Connection()
+    {
+        if (socket != INVALID_HANDLE) CloseSocket(socket);
+    }
+};
+
+PathServer::PathServer(int workerCount, int maxBatch, int batchWindowMicros)
+    : _workerCount((std::max)(workerCount, 1))
+    , _maxBatch((std::max)(maxBatch, 1))
+    , _batchWindow(batchWindowMicros)
+{
+}
+
+PathServer::~PathServer()
+{
+    Stop();
+}
+
+int PathServer::AddMap(const AStar& map)
+{
+    if (map.GetMapWidth() > PathProtocol::MAX_COORD + 1 || map.GetMapHeight() > PathProtocol::MAX_COORD + 1)
+    {
+        _error = "map is larger than the i16 coordinate range";
+        return -1;
+    }
+    _maps.push_back(std::make_unique<VersionedGrid>(map));
+    return (int)_maps.size() - 1;
+}
+
+bool PathServer::Start(const char* socketPath)
+{
+    if (_running) return true;
+    if (!InitializeSockets())
+    {
+        _error = "socket initialization failed";
+        return false;
+    }
+
+    sockaddr_un address;
+    if (!MakeAddress(socketPath, address))
+    {
+        _error = "socket path too long";
+        return false;
+    }
+
+    SocketHandle listenSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenSocket == INVALID_HANDLE)
+    {
+        _error = "socket() failed";
+        return false;
+    }
+
+    // 이전 실행이 남긴 소켓 파일 제거
+    std::remove(socketPath);
+    if (bind(listenSocket, (const sockaddr*)&address, sizeof(address)) != 0 || listen(listenSocket, 64) != 0)
+    {
+        _error = std::string("cannot listen on ") + socketPath;
+        CloseSocket(listenSocket);
+        return false;
+    }
+
+    _socketPath = socketPath;
+    _listenSocket = FromHandle(listenSocket);
+    _running = true;
+
+    for (int i = 0; i < _workerCount; ++i)
+        _workers.emplace_back(&PathServer::WorkerLoop, this);
+    _acceptThread = std::thread(&PathServer::AcceptLoop, this);
+    return true;
+}
+
+void PathServer::Stop()
+{
+    if (!_running.exchange(false)) return;
+
+    // 1. 수락 중단 (accept가 에러로 빠져나옴)
+    ShutdownSocket(ToHandle(_listenSocket));
+    CloseSocket(ToHandle(_listenSocket));
+    _listenSocket = -1;
+    if (_acceptThread.joinable()) _acceptThread.join();
+
+    // 2. 연결마다 읽기 중단
+    for (auto& connection : _connections)
+    {
+        ShutdownSocket(connection->socket);
+        connection->reader.join();
+    }
+
+    // 3. 작업 스레드 깨워서 종료
+    _queueCondition.notify_all();
+    for (std::thread& worker : _workers) worker.join();
+    _workers.clear();
+    _queue.clear();
+
+    _connections.clear();
+    std::remove(_socketPath.c_str());
+}
+
+PathServer::Stats PathServer::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(_statsMutex);
+    return _stats;
+}
+
+void PathServer::AcceptLoop()
+{
+    while (_running)
+    {
+        SocketHandle client = accept(ToHandle(_listenSocket), nullptr, nullptr);
+        if (client == INVALID_HANDLE)
+        {
+            if (!_running) break;
+            continue;
+        }
+
+        // 끝난 연결 정리 (스레드를 join한 뒤 목록에서 뺌. 소켓은 남은 참조가 없어질 때 닫힘)
+        for (auto& connection : _connections)
+        {
+            if (connection->finished) connection->reader.join();
+        }
+        _connections.erase(std::remove_if(_connections.begin(), _connections.end(),
+            [](const std::shared_ptr<Connection>& connection) { return connection->finished && !connection->reader.joinable(); }),
+            _connections.end());
+
+        auto connection = std::make_shared<Connection>();
+        connection->socket = client;
+        connection->reader = std::thread(&PathServer::ReadLoop, this, connection);
+        _connections.push_back(std::move(connection));
+    }
+}
+
+void PathServer::ReadLoop(std::shared_ptr<Connection> connection)
+{
+    std::vector<unsigned char> buffer(PathProtocol::REQUEST_SIZE * 256);
+    size_t filled = 0;
+    std::vector<Pending> received;
+
+    while (_running)
+    {
+        int bytes = recv(connection->socket, (char*)buffer.data() + filled, (int)(buffer.size() - filled), 0);
+        if (bytes <= 0) break; // 끊김 / Stop
+
+        filled += bytes;
+        auto now = std::chrono::steady_clock::now();
+
+        // 1. 다 도착한 요청만 꺼내고 나머지 조각은 앞으로 당김
+        size_t consumed = 0;
+        received.clear();
+        while (filled - consumed >= (size_t)PathProtocol::REQUEST_SIZE)
+        {
+            Pending pending{ connection, {}, now };
+            PathProtocol::DecodeRequest(&buffer[consumed], pending.request);
+            received.push_back(std::move(pending));
+            consumed += PathProtocol::REQUEST_SIZE;
+        }
+        std::memmove(buffer.data(), buffer.data() + consumed, filled - consumed);
+        filled -= consumed;
+
+        // 2. recv 한 번에 온 요청은 락 한 번으로 큐에 넣음
+        if (!received.empty())
+        {
+            {
+                std::lock_guard<std::mutex> lock(_queueMutex);
+                for (Pending& pending : received) _queue.push_back(std::move(pending));
+            }
+            _queueCondition.notify_one();
+        }
+    }
+
+    connection->finished = true;
+}
+
+void PathServer::WorkerLoop()
+{
+    SnapshotPathFinder finder;
+    finder.SetHeuristicType(AStar::HeuristicType::EUCLIDEAN);
+
+    std::vector<Pending> batch;
+    std::vector<Point> points;
+    std::vector<unsigned char> sendBuffer;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(_queueMutex);
+            _queueCondition.wait(lock, [this] { return !_queue.empty() || !_running; });
+            if (!_running) return;
+
+            // 배치가 덜 찼으면 batchWindow 동안 더 모아봄 (부하가 낮을 때는 지연만큼만 손해)
+            if ((int)_queue.size() < _maxBatch && _batchWindow.count() > 0)
+            {
+                _queueCondition.wait_for(lock, _batchWindow,
+                    [this] { return (int)_queue.size() >= _maxBatch || !_running; });
+                if (!_running) return;
+                if (_queue.empty()) continue; // 다른 작업 스레드가 가져감
+            }
+
+            int count = (std::min)((int)_queue.size(), _maxBatch);
+            batch.assign(std::make_move_iterator(_queue.begin()), std::make_move_iterator(_queue.begin() + count));
+            _queue.erase(_queue.begin(), _queue.begin() + count);
+
+            // 남은 요청이 있으면 다른 작업 스레드도 깨움
+            if (!_queue.empty()) _queueCondition.notify_one();
+        }
+
+        ProcessBatch(batch, finder, points, sendBuffer);
+    }
+}
+
+void PathServer::ProcessBatch(std::vector<Pending>& batch, SnapshotPathFinder& finder, std::vector<Point>& points,
+                              std::vector<unsigned char>& sendBuffer)
+{
+    auto dequeued = std::chrono::steady_clock::now();
+
+    // 같은 연결로 갈 응답끼리 모이도록 정렬 (연결 안에서는 도착 순서 유지)
+    std::stable_sort(batch.begin(), batch.end(),
+        [](const Pending& a, const Pending& b) { return a.connection.get() < b.connection.get(); });
+
+    Stats batchStats;
+    batchStats.batches = 1;
+
+    PathProtocol::Response response;
+    sendBuffer.clear();
+    for (size_t i = 0; i < batch.size(); ++i)
+    {
+        const PathProtocol::Request& request = batch[i].request;
+        response.id = request.id;
+        response.path.Clear();
+        response.cost = 0.0f;
+        response.queueMicros = ElapsedMicros(batch[i].arrival, dequeued);
+
+        auto searchBegin = std::chrono::steady_clock::now();
+        if (request.mapId >= _maps.size())
+        {
+            response.status = PathProtocol::Status::BAD_REQUEST;
+        }
+        else
+        {
+            std::shared_ptr<const GridSnapshot> snapshot = _maps[request.mapId]->Acquire();
+            auto inside = [&snapshot](Point p) { return p.x >= 0 && p.x < snapshot->GetWidth() && p.y >= 0 && p.y < snapshot->GetHeight(); };
+            if (!inside(request.start) || !inside(request.end))
+            {
+                response.status = PathProtocol::Status::BAD_REQUEST;
+            }
+            else if (finder.FindPath(*snapshot, request.start, request.end, points))
+            {
+                response.status = PathProtocol::Status::OK;
+                response.path.Assign(points);
+                response.cost = (float)SearchVerifier::PathCost(points);
+            }
+            else
+            {
+                response.status = PathProtocol::Status::NO_PATH;
+            }
+        }
+        response.searchMicros = ElapsedMicros(searchBegin, std::chrono::steady_clock::now());
+        PathProtocol::AppendResponse(response, sendBuffer);
+
+        ++batchStats.requests;
+        batchStats.queueMicros += response.queueMicros;
+        batchStats.searchMicros += response.searchMicros;
+        batchStats.maxQueueMicros = (std::max)(batchStats.maxQueueMicros, (unsigned long long)response.queueMicros);
+        batchStats.maxSearchMicros = (std::max)(batchStats.maxSearchMicros, (unsigned long long)response.searchMicros);
+
+        // 연결이 바뀌는 지점에서 모아둔 응답을 한 번에 전송
+        bool lastOfConnection = (i + 1 == batch.size()) || batch[i + 1].connection != batch[i].connection;
+        if (lastOfConnection)
+        {
+            Connection& connection = *batch[i].connection;
+            std::lock_guard<std::mutex> lock(connection.sendMutex);
+            SendAll(connection.socket, sendBuffer.data(), sendBuffer.size()); // 실패해도 클라이언트가 끊긴 것뿐
+            sendBuffer.clear();
+        }
+    }
+    batch.clear();
+
+    std::lock_guard<std::mutex> lock(_statsMutex);
+    _stats.requests += batchStats.requests;
+    _stats.batches += batchStats.batches;
+    _stats.queueMicros += batchStats.queueMicros;
+    _stats.searchMicros += batchStats.searchMicros;
+    _stats.maxQueueMicros = (std::max)(_stats.maxQueueMicros, batchStats.maxQueueMicros);
+    _stats.maxSearchMicros = (std::max)(_stats.maxSearchMicros, batchStats.maxSearchMicros);
+}
+
+// -----------------------------------------------------------
+// PathClient
+// -----------------------------------------------------------
+bool PathClient::Connect(const char* socketPath)
+{
+    Close();
+    if (!InitializeSockets()) return false;
+
+    sockaddr_un address;
+    if (!MakeAddress(socketPath, address)) return false;
+
+    SocketHandle s = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (s == INVALID_HANDLE) return false;
+    if (connect(s, (const sockaddr*)&address, sizeof(address)) != 0)
+    {
+        CloseSocket(s);
+        return false;
+    }
+
+    _socket = FromHandle(s);
+    _buffer.clear();
+    _readOffset = 0;
+    return true;
+}
+
+void PathClient::Close()
+{
+    if (_socket == -1) return;
+    CloseSocket(ToHandle(_socket));
+    _socket = -1;
+}
+
+bool PathClient::Send(const PathProtocol::Request* requests, size_t count)
+{
+    if (_socket == -1) return false;
+
+    std::vector<unsigned char> data(count * PathProtocol::REQUEST_SIZE);
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (!PathProtocol::EncodeRequest(requests[i], &data[i * PathProtocol::REQUEST_SIZE])) return false;
+    }
+    return SendAll(ToHandle(_socket), data.data(), data.size());
+}
+
+bool PathClient::Receive(PathProtocol::Response& out)
+{
+    if (_socket == -1) return false;
+
+    while (true)
+    {
+        size_t available = _buffer.size() - _readOffset;
+        if (available > 0)
+        {
+            size_t used = PathProtocol::DecodeResponse(&_buffer[_readOffset], available, out);
+            if (used > 0)
+            {
+                _readOffset += used;
+                return true;
+            }
+        }
+
+        // 다 읽은 앞부분은 버리고 이어 받기
+        _buffer.erase(_buffer.begin(), _buffer.begin() + _readOffset);
+        _readOffset = 0;
+
+        size_t oldSize = _buffer.size();
+        _buffer.resize(oldSize + 4096);
+        int bytes = recv(ToHandle(_socket), (char*)_buffer.data() + oldSize, 4096, 0);
+        if (bytes <= 0)
+        {
+            _buffer.resize(oldSize);
+            return false;
+        }
+        _buffer.resize(oldSize + bytes);
+    }
+}
\ No newline at end of file
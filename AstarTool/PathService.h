@@ -0,0 +1,145 @@
+﻿#pragma once
+
+// -----------------------------------------------------------
+// PathService (Unix 도메인 소켓 길찾기 서비스)
+//
+// 게임 서버 프로세스마다 AStar와 맵 사본을 들고 있는 대신,
+// 맵을 한 번만 읽어 둔 로컬 데몬에 경로를 물어보는 구조입니다.
+//
+// [프로토콜] 리틀 엔디언 고정 길이 (소켓 하나에 요청을 몰아서 보내도 됨, 응답 순서는 보장 안 함 -> id로 매칭)
+// - 요청 16바이트 : id(u32) mapId(u16) reserved(u16) startX startY endX endY (각 i16)
+// - 응답 28바이트 + 런 : id(u32) status(u8) reserved(u8) runCount(u16) startX startY (i16)
+//                       length(u32, 칸 수) cost(f32) queueMicros(u32) searchMicros(u32) + CompactPath 런 바이트
+// - [수정] 좌표가 i16이므로 맵은 한 변 MAX_COORD + 1칸까지만 등록, 범위 밖 좌표 요청은 보내지 않음 / BAD_REQUEST
+//          런이 u16을 넘는 경로는 PATH_TOO_LONG (런 없이 cost만)
+//
+// [서버 구조]
+// - 연결마다 읽기 스레드가 요청을 공용 큐에 넣음
+// - 작업 스레드는 큐에서 요청을 최대 maxBatch개까지 (batchWindow 동안 더 모아서) 한 번에 가져가
+//   각자의 SnapshotPathFinder로 처리하고, 같은 연결로 갈 응답은 send 한 번으로 묶어 보냄
+// - 맵은 VersionedGrid 스냅샷(불변)이라 작업 스레드끼리 락 없이 공유
+// -----------------------------------------------------------
+namespace PathProtocol
+{
+    constexpr int REQUEST_SIZE = 16;
+    constexpr int RESPONSE_HEADER_SIZE = 28;
+    constexpr int MAX_COORD = 32767;      // i16
+    constexpr size_t MAX_RUN_COUNT = 0xFFFF; // runCount(u16)
+
+    enum class Status : unsigned char { OK, NO_PATH, BAD_REQUEST, PATH_TOO_LONG };
+
+    struct Request
+    {
+        unsigned int id;
+        unsigned short mapId;
+        Point start;
+        Point end;
+    };
+
+    struct Response
+    {
+        unsigned int id = 0;
+        Status status = Status::BAD_REQUEST;
+        float cost = 0.0f;
+        unsigned int queueMicros = 0;  // 서버에 도착해서 작업 스레드가 꺼낼 때까지
+        unsigned int searchMicros = 0; // 탐색에 걸린 시간
+        CompactPath path;
+    };
+
+    // 좌표가 i16 범위 밖이면 쓰지 않고 false
+    bool EncodeRequest(const Request& request, unsigned char* out);
+    void DecodeRequest(const unsigned char* in, Request& out);
+
+    // 런이 MAX_RUN_COUNT를 넘으면 PATH_TOO_LONG + 빈 경로로 씀 (cost는 유지)
+    void AppendResponse(const Response& response, std::vector<unsigned char>& out);
+    // in 앞부분에서 응답 하나를 읽음. 아직 다 안 왔으면 0, 읽었으면 소비한 바이트 수
+    size_t DecodeResponse(const unsigned char* in, size_t size, Response& out);
+}
+
+class PathServer
+{
+public:
+    struct Stats
+    {
+        unsigned long long requests = 0;
+        unsigned long long batches = 0;
+        unsigned long long queueMicros = 0;  // 합계
+        unsigned long long searchMicros = 0; // 합계
+        unsigned long long maxQueueMicros = 0;
+        unsigned long long maxSearchMicros = 0;
+    };
+
+public:
+    PathServer(int workerCount, int maxBatch, int batchWindowMicros);
+    ~PathServer();
+
+    // Start 전에 맵 등록. 반환값이 요청의 mapId (한 변이 MAX_COORD + 1을 넘으면 -1 + GetError)
+    int AddMap(const AStar& map);
+
+    // 소켓을 열고 수락 / 작업 스레드 시작 (바로 반환). 실패하면 false + GetError
+    bool Start(const char* socketPath);
+    void Stop();
+
+    const std::string& GetError() const { return _error; }
+    Stats GetStats() const;
+
+private:
+    struct Connection;
+    struct Pending
+    {
+        std::shared_ptr<Connection> connection;
+        PathProtocol::Request request;
+        std::chrono::steady_clock::time_point arrival;
+    };
+
+    void AcceptLoop();
+    void ReadLoop(std::shared_ptr<Connection> connection);
+    void WorkerLoop();
+    void ProcessBatch(std::vector<Pending>& batch, SnapshotPathFinder& finder, std::vector<Point>& points,
+                      std::vector<unsigned char>& sendBuffer);
+
+private:
+    int _workerCount;
+    int _maxBatch;
+    std::chrono::microseconds _batchWindow;
+
+    std::vector<std::unique_ptr<VersionedGrid>> _maps;
+    std::string _socketPath;
+    std::string _error;
+
+    long long _listenSocket = -1;
+    std::atomic<bool> _running{ false };
+    std::thread _acceptThread;
+    std::vector<std::thread> _workers;
+
+    std::vector<std::shared_ptr<Connection>> _connections; // 수락 스레드만 수정 (Stop은 수락 스레드 종료 후)
+
+    std::mutex _queueMutex;
+    std::condition_variable _queueCondition;
+    std::deque<Pending> _queue;
+
+    mutable std::mutex _statsMutex;
+    Stats _stats;
+};
+
+// 블로킹 클라이언트 (부하 생성기 / 테스트용)
+class PathClient
+{
+public:
+    PathClient() = default;
+    ~PathClient() { Close(); }
+
+    PathClient(const PathClient&) = delete;
+    PathClient& operator=(const PathClient&) = delete;
+
+    bool Connect(const char* socketPath);
+    void Close();
+
+    bool Send(const PathProtocol::Request* requests, size_t count); // 좌표가 i16 밖인 요청이 있으면 보내지 않고 false
+    bool Receive(PathProtocol::Response& out); // 응답 하나가 올 때까지 대기
+
+private:
+    long long _socket = -1;
+    std::vector<unsigned char> _buffer;
+    size_t _readOffset = 0;
+};
\ No newline at end of file
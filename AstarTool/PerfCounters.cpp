@@ -0,0 +1,151 @@
+﻿#include <string>
+#include <chrono>
+#include <cstring>
+#include <cerrno>
+#include "PerfCounters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const char* EVENT_NAMES[PerfCounters::EVENT_COUNT] =
+    {
+        "cycles", "instructions", "L1D misses", "LLC misses", "branch misses",
+    };
+
+#ifdef __linux__
+    struct EventConfig
+    {
+        unsigned int type;
+        unsigned long long config;
+    };
+
+    const EventConfig EVENT_CONFIGS[PerfCounters::EVENT_COUNT] =
+    {
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+        { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+    };
+
+    int OpenEvent(const EventConfig& config)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = config.type;
+        attr.config = config.config;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        attr.exclude_kernel = 1; // perf_event_paranoid가 2여도 열리도록 사용자 모드만
+        attr.exclude_hv = 1;
+
+        // pid 0, cpu -1: 현재 스레드를 어느 CPU에서 돌든 측정
+        return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+#endif
+}
+
+const char* PerfCounters::GetEventName(Event event)
+{
+    return EVENT_NAMES[event];
+}
+
+bool PerfCounters::IsAnyAvailable() const
+{
+    for (int i = 0; i < EVENT_COUNT; ++i)
+    {
+        if (_fd[i] >= 0) return true;
+    }
+    return false;
+}
+
+bool PerfCounters::Open()
+{
+    Close();
+
+#ifdef __linux__
+    int firstError = 0;
+    for (int i = 0; i < EVENT_COUNT; ++i)
+    {
+        _fd[i] = OpenEvent(EVENT_CONFIGS[i]);
+        if (_fd[i] < 0 && firstError == 0) firstError = errno;
+    }
+
+    if (!IsAnyAvailable())
+    {
+        _reason = std::string("perf_event_open failed: ") + std::strerror(firstError);
+        if (firstError == EACCES || firstError == EPERM)
+            _reason += " (check /proc/sys/kernel/perf_event_paranoid)";
+        return false;
+    }
+    _reason.clear();
+    return true;
+#else
+    _reason = "hardware counters are only supported on Linux";
+    return false;
+#endif
+}
+
+void PerfCounters::Close()
+{
+    for (int i = 0; i < EVENT_COUNT; ++i)
+    {
+#ifdef __linux__
+        if (_fd[i] >= 0) close(_fd[i]);
+#endif
+        _fd[i] = -1;
+    }
+}
+
+void PerfCounters::ReadAll(Reading* out) const
+{
+    for (int i = 0; i < EVENT_COUNT; ++i)
+    {
+        out[i] = Reading();
+#ifdef __linux__
+        if (_fd[i] < 0) continue;
+
+        unsigned long long buffer[3];
+        if (read(_fd[i], buffer, sizeof(buffer)) == (ssize_t)sizeof(buffer))
+        {
+            out[i].value = buffer[0];
+            out[i].enabled = buffer[1];
+            out[i].running = buffer[2];
+        }
+#endif
+    }
+}
+
+void PerfCounters::Start()
+{
+    ReadAll(_begin);
+    _beginTime = std::chrono::steady_clock::now();
+}
+
+PerfCounters::Sample PerfCounters::Stop()
+{
+    Sample sample;
+    sample.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _beginTime).count();
+
+    Reading end[EVENT_COUNT];
+    ReadAll(end);
+
+    for (int i = 0; i < EVENT_COUNT; ++i)
+    {
+        unsigned long long delta = end[i].value - _begin[i].value;
+        unsigned long long enabled = end[i].enabled - _begin[i].enabled;
+        unsigned long long running = end[i].running - _begin[i].running;
+
+        // 번갈아 측정된 경우 켜져 있던 시간 전체로 늘려 추정
+        if (running > 0 && running < enabled)
+            delta = (unsigned long long)((double)delta * enabled / running);
+        sample.value[i] = delta;
+    }
+    return sample;
+}
\ No newline at end of file
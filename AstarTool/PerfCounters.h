@@ -0,0 +1,69 @@
+﻿#pragma once
+
+// -----------------------------------------------------------
+// PerfCounters (하드웨어 성능 카운터)
+//
+// 벽시계 시간만으로는 탐색 루프가 _nodeMap 조회의 캐시 미스 때문에 느린지,
+// 힙 연산(분기 예측 실패) 때문에 느린지 구분이 안 됩니다.
+// Linux에서는 perf_event_open으로 사이클 / 명령어 / L1D·LLC 미스 / 분기 예측 실패를
+// 현재 스레드(사용자 모드)에 대해 읽습니다.
+// - 카운터는 하나씩 따로 열어서, 일부만 지원되는 환경(VM 등)에서도 되는 것만 씀
+// - 다른 OS거나 권한이 없으면 Open이 false -> 시간만 측정 (GetUnavailableReason으로 이유 확인)
+// - 카운터가 부족해 번갈아 측정(multiplexing)되면 실행 시간 비율로 보정
+// -----------------------------------------------------------
+class PerfCounters
+{
+public:
+    enum Event { CYCLES, INSTRUCTIONS, L1D_MISSES, LLC_MISSES, BRANCH_MISSES, EVENT_COUNT };
+
+    // Start ~ Stop 사이 구간 측정값 (여러 구간을 +=로 누적 가능)
+    struct Sample
+    {
+        unsigned long long value[EVENT_COUNT] = {};
+        double milliseconds = 0.0;
+
+        Sample& operator+=(const Sample& other)
+        {
+            for (int i = 0; i < EVENT_COUNT; ++i) value[i] += other.value[i];
+            milliseconds += other.milliseconds;
+            return *this;
+        }
+    };
+
+public:
+    PerfCounters() = default;
+    ~PerfCounters() { Close(); }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    // 카운터 열기. 하나라도 열리면 true
+    bool Open();
+    void Close();
+
+    bool IsAvailable(Event event) const { return _fd[event] >= 0; }
+    bool IsAnyAvailable() const;
+    const char* GetUnavailableReason() const { return _reason.c_str(); }
+    static const char* GetEventName(Event event);
+
+    // 구간 측정. 카운터는 계속 돌고 있고 시작/끝 값의 차이만 계산하므로 구간마다 시스템 콜은 읽기뿐
+    void Start();
+    Sample Stop();
+
+private:
+    struct Reading
+    {
+        unsigned long long value = 0;
+        unsigned long long enabled = 0; // 카운터가 켜져 있던 시간
+        unsigned long long running = 0; // 실제로 하드웨어에서 센 시간
+    };
+
+    void ReadAll(Reading* out) const;
+
+private:
+    int _fd[EVENT_COUNT] = { -1, -1, -1, -1, -1 };
+    std::string _reason;
+
+    Reading _begin[EVENT_COUNT];
+    std::chrono::steady_clock::time_point _beginTime;
+};
\ No newline at end of file